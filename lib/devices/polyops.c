@@ -37,6 +37,8 @@
 
 typedef struct _clip {
     gfxpoly_t*poly;
+    gfxbbox_t bbox;
+    char isrect; // poly is just its bounding box
     int openclips;
     struct _clip*next;
 } clip_t;
@@ -44,10 +46,24 @@ typedef struct _clip {
 typedef struct _internal {
     gfxdevice_t*out;
     clip_t*clip;
-    gfxpoly_t*polyunion;
+
+    /* polygons collected by the union device. They're merged
+       lazily (in one sweep) when the union is requested */
+    char getunion;
+    gfxpoly_t**unionpolys;
+    int num_unionpolys;
+    int size_unionpolys;
     
     int good_polygons;
     int bad_polygons;
+
+    /* clip intersections on the current page */
+    int sweeps;
+    int skipped_sweeps;
+
+    /* if set, save all clip polygons to files starting with this prefix */
+    char*dumpclips;
+    int num_dumped;
 } internal_t;
 
 static int verbose = 0;
@@ -75,6 +91,13 @@ int polyops_setparameter(struct _gfxdevice*dev, const char*key, const char*value
 {
     dbg("polyops_setparameter");
     internal_t*i = (internal_t*)dev->internal;
+    if(!strcmp(key, "polythreads")) {
+	gfxpoly_set_num_threads(atoi(value));
+    } else if(!strcmp(key, "dumpclips")) {
+	if(i->dumpclips)
+	    free(i->dumpclips);
+	i->dumpclips = strdup(value);
+    }
     if(i->out) return i->out->setparameter(i->out,key,value);
     else return 0;
 }
@@ -83,9 +106,61 @@ void polyops_startpage(struct _gfxdevice*dev, int width, int height)
 {
     dbg("polyops_startpage");
     internal_t*i = (internal_t*)dev->internal;
+    i->sweeps = i->skipped_sweeps = 0;
     if(i->out) i->out->startpage(i->out,width,height);
 }
 
+static char line_is_rectangle(gfxline_t*line)
+{
+    gfxbbox_t*r = gfxline_isrectangle(line);
+    if(!r)
+	return 0;
+    free(r);
+    return 1;
+}
+/* we only need to know whether a fill is a rectangle if there's clipping */
+static char is_rectangle(internal_t*i, gfxline_t*line)
+{
+    if(!i->clip || !i->clip->poly)
+	return 0;
+    return line_is_rectangle(line);
+}
+
+/* intersect a polygon with the current clipping polygon. We only do a full
+   sweep if we have to: polygons outside of the clipping area are discarded,
+   polygons inside a rectangular clipping area are returned unchanged,
+   and if either of the two is a rectangle, the other one is cut to it directly.
+   The result may be the input polygon itself. */
+static gfxpoly_t* intersect_with_clip(internal_t*i, gfxpoly_t*poly, char isrect, char*result_isrect)
+{
+    clip_t*c = i->clip;
+    gfxbbox_t b = gfxpoly_getbbox(poly);
+    *result_isrect = 0;
+
+    if(b.xmax <= c->bbox.xmin || b.xmin >= c->bbox.xmax ||
+       b.ymax <= c->bbox.ymin || b.ymin >= c->bbox.ymax) {
+	i->skipped_sweeps++;
+	/* the empty polygon is a (degenerate) rectangle, too */
+	*result_isrect = 1;
+	return gfxpoly_from_fill(0, DEFAULT_GRID);
+    }
+    if(c->isrect) {
+	i->skipped_sweeps++;
+	*result_isrect = isrect;
+	if(b.xmin >= c->bbox.xmin && b.xmax <= c->bbox.xmax &&
+	   b.ymin >= c->bbox.ymin && b.ymax <= c->bbox.ymax) {
+	    return poly;
+	}
+	return gfxpoly_intersect_box(poly, &c->bbox);
+    }
+    if(isrect) {
+	i->skipped_sweeps++;
+	return gfxpoly_intersect_box(c->poly, &b);
+    }
+    i->sweeps++;
+    return gfxpoly_intersect(poly, c->poly);
+}
+
 void polyops_startclip(struct _gfxdevice*dev, gfxline_t*line)
 {
     dbg("polyops_startclip");
@@ -93,6 +168,7 @@ void polyops_startclip(struct _gfxdevice*dev, gfxline_t*line)
 
     gfxpoly_t* oldclip = i->clip?i->clip->poly:0;
     gfxpoly_t* poly = gfxpoly_from_fill(line, DEFAULT_GRID);
+    char isrect = line_is_rectangle(line);
     if(poly) 
         i->good_polygons++;
     else
@@ -121,11 +197,13 @@ void polyops_startclip(struct _gfxdevice*dev, gfxline_t*line)
 	currentclip = 0;
 	type = 2;
     } else if(poly && oldclip) {
-	gfxpoly_t*intersection = gfxpoly_intersect(poly, oldclip);
+	gfxpoly_t*intersection = intersect_with_clip(i, poly, isrect, &isrect);
 	if(intersection) {
             i->good_polygons++;
 	    // this case is what usually happens 
-	    gfxpoly_destroy(poly);poly=0;
+	    if(intersection != poly)
+		gfxpoly_destroy(poly);
+	    poly=0;
 	    currentclip = intersection;
 	    type = 0;
 	} else {
@@ -145,6 +223,15 @@ void polyops_startclip(struct _gfxdevice*dev, gfxline_t*line)
     i->clip->next = n;
     i->clip->poly = currentclip;
     i->clip->openclips = type;
+    if(currentclip) {
+	i->clip->bbox = gfxpoly_getbbox(currentclip);
+	i->clip->isrect = isrect;
+	if(i->dumpclips) {
+	    char filename[1024];
+	    snprintf(filename, sizeof(filename), "%s%05d.ps", i->dumpclips, i->num_dumped++);
+	    gfxpoly_save(currentclip, filename);
+	}
+    }
 }
 
 void polyops_endclip(struct _gfxdevice*dev)
@@ -169,25 +256,29 @@ void polyops_endclip(struct _gfxdevice*dev)
     old->next = 0;free(old);
 }
 
-static void addtounion(struct _gfxdevice*dev, gfxpoly_t*poly)
+/* returns 1 if the polygon was stored (and must not be freed by the caller) */
+static char addtounion(struct _gfxdevice*dev, gfxpoly_t*poly)
 {
     internal_t*i = (internal_t*)dev->internal;
-    if(poly && i->polyunion) {
-	gfxpoly_t*old = i->polyunion;
-	gfxpoly_t*newpoly = gfxpoly_union(poly,i->polyunion);
-	i->polyunion = newpoly;
-	gfxpoly_destroy(old);
+    if(!poly || !i->getunion)
+	return 0;
+    if(i->num_unionpolys == i->size_unionpolys) {
+	i->size_unionpolys = i->size_unionpolys ? i->size_unionpolys*2 : 64;
+	i->unionpolys = (gfxpoly_t**)rfx_realloc(i->unionpolys, sizeof(gfxpoly_t*)*i->size_unionpolys);
     }
+    i->unionpolys[i->num_unionpolys++] = poly;
+    return 1;
 }
 
-static gfxline_t* handle_poly(gfxdevice_t*dev, gfxpoly_t*poly, char*ok)
+static gfxline_t* handle_poly(gfxdevice_t*dev, gfxpoly_t*poly, char isrect, char*ok)
 {
     internal_t*i = (internal_t*)dev->internal;
     if(i->clip && i->clip->poly) {
 	gfxpoly_t*old = poly;
 	if(poly) {
-	    poly = gfxpoly_intersect(poly, i->clip->poly);
-	    gfxpoly_destroy(old);
+	    poly = intersect_with_clip(i, poly, isrect, &isrect);
+	    if(poly != old)
+		gfxpoly_destroy(old);
 	}
     }
 
@@ -196,12 +287,13 @@ static gfxline_t* handle_poly(gfxdevice_t*dev, gfxpoly_t*poly, char*ok)
     else
         i->bad_polygons++;
 
-    addtounion(dev, poly);
+    char stored = addtounion(dev, poly);
     gfxline_t*gfxline = 0;
     if(poly) {
 	// this is the case where everything went right
 	gfxline_t*line = gfxline_from_gfxpoly(poly);
-	gfxpoly_destroy(poly);
+	if(!stored)
+	    gfxpoly_destroy(poly);
         *ok = 1;
 	return line;
     } else {
@@ -228,7 +320,7 @@ void polyops_stroke(struct _gfxdevice*dev, gfxline_t*line, gfxcoord_t width, gfx
 
     gfxpoly_t* poly = gfxpoly_from_stroke(line, width, cap_style, joint_style, miterLimit, DEFAULT_GRID);
     char ok = 0;
-    gfxline_t*line2 = handle_poly(dev, poly, &ok);
+    gfxline_t*line2 = handle_poly(dev, poly, 0, &ok);
 
     if(ok) {
 	if(i->out && line2) i->out->fill(i->out, line2, color);
@@ -246,7 +338,7 @@ void polyops_fill(struct _gfxdevice*dev, gfxline_t*line, gfxcolor_t*color)
 
     gfxpoly_t*poly = gfxpoly_from_fill(line, DEFAULT_GRID);
     char ok = 0;
-    gfxline_t*line2 = handle_poly(dev, poly, &ok);
+    gfxline_t*line2 = handle_poly(dev, poly, is_rectangle(i, line), &ok);
 
     if(ok) {
 	if(i->out && line2) i->out->fill(i->out, line2, color);
@@ -263,7 +355,7 @@ void polyops_fillbitmap(struct _gfxdevice*dev, gfxline_t*line, gfximage_t*img, g
     
     gfxpoly_t*poly = gfxpoly_from_fill(line, DEFAULT_GRID);
     char ok = 0;
-    gfxline_t*line2 = handle_poly(dev, poly, &ok);
+    gfxline_t*line2 = handle_poly(dev, poly, is_rectangle(i, line), &ok);
 
     if(ok) {
 	if(i->out && line2) i->out->fillbitmap(i->out, line2, img, matrix, cxform);
@@ -280,7 +372,7 @@ void polyops_fillgradient(struct _gfxdevice*dev, gfxline_t*line, gfxgradient_t*g
     
     gfxpoly_t*poly = gfxpoly_from_fill(line, DEFAULT_GRID);
     char ok = 0;
-    gfxline_t*line2 = handle_poly(dev, poly, &ok);
+    gfxline_t*line2 = handle_poly(dev, poly, is_rectangle(i, line), &ok);
 
     if(ok) {
 	if(i->out && line2) i->out->fillgradient(i->out, line2, gradient, type, matrix);
@@ -314,7 +406,7 @@ void polyops_drawchar(struct _gfxdevice*dev, gfxfont_t*font, int glyphnr, gfxcol
 	gfxline_free(dummybox2);
 
         char ok=0;
-	gfxline_t*gfxline = handle_poly(dev, dummybox, &ok);
+	gfxline_t*gfxline = handle_poly(dev, dummybox, 1, &ok);
 	if(ok) {
 	    gfxbbox_t bbox2 = gfxline_getbbox(gfxline);
 	    double w = bbox2.xmax - bbox2.xmin;
@@ -354,6 +446,10 @@ void polyops_endpage(struct _gfxdevice*dev)
 {
     dbg("polyops_endpage");
     internal_t*i = (internal_t*)dev->internal;
+    if(i->sweeps || i->skipped_sweeps) {
+	msg("<verbose> polyops: %d of %d clip intersections didn't need a polygon sweep", 
+		i->skipped_sweeps, i->sweeps + i->skipped_sweeps);
+    }
     if(i->out) i->out->endpage(i->out);
 }
 
@@ -362,14 +458,19 @@ gfxresult_t* polyops_finish(struct _gfxdevice*dev)
     dbg("polyops_finish");
     internal_t*i = (internal_t*)dev->internal;
 
-    if(i->polyunion) {
-	gfxpoly_destroy(i->polyunion);i->polyunion=0;
+    if(i->getunion) {
+	int t;
+	for(t=0;t<i->num_unionpolys;t++)
+	    gfxpoly_destroy(i->unionpolys[t]);
+	rfx_free(i->unionpolys);i->unionpolys=0;
     } else {
         if(i->bad_polygons) {
             msg("<notice> --flatten success rate: %.1f%% (%d failed polygons)", i->good_polygons*100.0 / (i->good_polygons + i->bad_polygons), i->bad_polygons);
         }
     }
     gfxdevice_t*out = i->out;
+    if(i->dumpclips)
+	free(i->dumpclips);
     free(i);memset(dev, 0, sizeof(gfxdevice_t));
     if(out) {
 	return out->finish(out);
@@ -381,7 +482,17 @@ gfxresult_t* polyops_finish(struct _gfxdevice*dev)
 gfxline_t*gfxdevice_union_getunion(struct _gfxdevice*dev)
 {
     internal_t*i = (internal_t*)dev->internal;
-    return gfxline_from_gfxpoly(i->polyunion);
+    if(!i->num_unionpolys)
+	return 0;
+    /* even a single polygon goes through the sweep, so that the result
+       is always in normal form */
+    gfxpoly_t*u = gfxpoly_union_many(i->unionpolys, i->num_unionpolys);
+    int t;
+    for(t=0;t<i->num_unionpolys;t++)
+	gfxpoly_destroy(i->unionpolys[t]);
+    i->unionpolys[0] = u;
+    i->num_unionpolys = 1;
+    return gfxline_from_gfxpoly(i->unionpolys[0]);
 }
 
 void gfxdevice_removeclippings_init(gfxdevice_t*dev, gfxdevice_t*out)
@@ -409,7 +520,6 @@ void gfxdevice_removeclippings_init(gfxdevice_t*dev, gfxdevice_t*out)
     dev->finish = polyops_finish;
 
     i->out = out;
-    i->polyunion = 0;
 }
 
 void gfxdevice_union_init(gfxdevice_t*dev,gfxdevice_t*out)
@@ -437,7 +547,6 @@ void gfxdevice_union_init(gfxdevice_t*dev,gfxdevice_t*out)
     dev->finish = polyops_finish;
 
     i->out = out;
-    /* create empty polygon */
-    i->polyunion = gfxpoly_from_stroke(0, 0, gfx_capButt, gfx_joinMiter, 0, DEFAULT_GRID);
+    i->getunion = 1;
 }
 
@@ -194,11 +194,13 @@ static void dumpImage(writer_t*w, state_t*state, gfximage_t*img)
     unsigned char*filter = malloc(img->height);
     int y;
     image = malloc(img->width*img->height*sizeof(gfxcolor_t));
+    png_filterlines_t*lines = png_filterlines_new(img->width);
     for(y=0;y<img->height;y++) {
-	filter[y] = png_apply_filter_32(
+	filter[y] = png_apply_filter_32(lines,
 		(void*)&image[y*img->width], 
 		(void*)&img->data[y*img->width], img->width, y);
     }
+    png_filterlines_destroy(lines);
 #else
     image = img->data;
 #endif
@@ -25,6 +25,7 @@
 #include "../gfxdevice.h"
 #include "../gfxtools.h"
 #include "../mem.h"
+#include "../q.h"
 #include "../types.h"
 #include "../png.h"
 #include "../log.h"
@@ -55,6 +56,30 @@ typedef struct _clipbuffer {
     struct _clipbuffer*next;
 } clipbuffer_t;
 
+/* rasterized glyph, as a one bit per pixel coverage mask at the
+   (antialized) internal resolution */
+typedef struct _glyphkey {
+    char*id;
+    int glyphnr;
+    float m00,m01,m10,m11;
+    char subx,suby;
+} glyphkey_t;
+
+typedef struct _glyphmask {
+    glyphkey_t*key;
+    int xoffset,yoffset; /* position of the mask relative to the pen position */
+    int width,height;
+    int bitwidth;
+    U32*data;
+    int size;
+    struct _glyphmask*prev; /* LRU list */
+    struct _glyphmask*next;
+} glyphmask_t;
+
+/* the fractional part of a glyph's position is quantized to this many steps */
+#define GLYPHCACHE_SUBPIXELS 4
+#define GLYPHCACHE_DEFAULT_SIZE (4*1024*1024)
+
 typedef struct _internal {
     int width;
     int height;
@@ -77,6 +102,12 @@ typedef struct _internal {
 
     internal_result_t*results;
     internal_result_t*result_next;
+
+    dict_t*glyphs;
+    glyphmask_t*glyphs_first; /* most recently used */
+    glyphmask_t*glyphs_last;
+    int glyphs_size;
+    int glyphs_maxsize;
 } internal_t;
 
 typedef enum {filltype_solid,filltype_clip,filltype_bitmap,filltype_gradient} filltype_t;
@@ -505,16 +536,21 @@ void fill_solid(gfxdevice_t*dev, gfxcolor_t* color)
     fill(dev, &info);
 }
 
+static void glyphcache_destroy(internal_t*i);
+
 int render_setparameter(struct _gfxdevice*dev, const char*key, const char*value)
 {
     internal_t*i = (internal_t*)dev->internal;
     if(!strcmp(key, "antialize") || !strcmp(key, "antialise")) {
 	i->antialize = atoi(value);
 	i->zoom = i->antialize * i->multiply;
+	/* cached glyphs were rasterized at the old zoom */
+	glyphcache_destroy(i);
 	return 1;
     } else if(!strcmp(key, "multiply")) {
 	i->multiply = atoi(value);
 	i->zoom = i->antialize * i->multiply;
+	glyphcache_destroy(i);
 	fprintf(stderr, "Warning: multiply not implemented yet\n");
 	return 1;
     } else if(!strcmp(key, "fillwhite")) {
@@ -523,6 +559,10 @@ int render_setparameter(struct _gfxdevice*dev, const char*key, const char*value)
     } else if(!strcmp(key, "palette")) {
 	i->palette = atoi(value);
 	return 1;
+    } else if(!strcmp(key, "glyphcache")) {
+	/* size of the glyph cache, in kilobytes. 0 disables the cache */
+	i->glyphs_maxsize = atoi(value)*1024;
+	return 1;
     }
     return 0;
 }
@@ -755,6 +795,262 @@ void render_addfont(struct _gfxdevice*dev, gfxfont_t*font)
 {
 }
 
+static void* glyphkey_clone(const void*_k)
+{
+    const glyphkey_t*k1 = (const glyphkey_t*)_k;
+    glyphkey_t*k2 = (glyphkey_t*)malloc(sizeof(glyphkey_t));
+    *k2 = *k1;
+    k2->id = strdup(k1->id);
+    return k2;
+}
+static unsigned int glyphkey_hash(const void*_k)
+{
+    const glyphkey_t*k = (const glyphkey_t*)_k;
+    unsigned int h = crc32_add_string(0, k->id);
+    h = crc32_add_bytes(h, (char*)&k->glyphnr, sizeof(k->glyphnr));
+    h = crc32_add_bytes(h, (char*)&k->m00, sizeof(k->m00));
+    h = crc32_add_bytes(h, (char*)&k->m01, sizeof(k->m01));
+    h = crc32_add_bytes(h, (char*)&k->m10, sizeof(k->m10));
+    h = crc32_add_bytes(h, (char*)&k->m11, sizeof(k->m11));
+    h = crc32_add_byte(h, k->subx);
+    h = crc32_add_byte(h, k->suby);
+    return h;
+}
+static void glyphkey_destroy(void*_k)
+{
+    glyphkey_t*k = (glyphkey_t*)_k;
+    free(k->id);k->id = 0;
+    free(k);
+}
+static char glyphkey_equals(const void*_k1, const void*_k2)
+{
+    const glyphkey_t*k1 = (const glyphkey_t*)_k1;
+    const glyphkey_t*k2 = (const glyphkey_t*)_k2;
+    /* compare the float32 bits, so that equals() matches hash() */
+    return k1->glyphnr == k2->glyphnr &&
+	   *(U32*)&k1->m00 == *(U32*)&k2->m00 &&
+	   *(U32*)&k1->m01 == *(U32*)&k2->m01 &&
+	   *(U32*)&k1->m10 == *(U32*)&k2->m10 &&
+	   *(U32*)&k1->m11 == *(U32*)&k2->m11 &&
+	   k1->subx == k2->subx && k1->suby == k2->suby &&
+	   !strcmp(k1->id, k2->id);
+}
+static type_t glyphkey_type = {
+    hash: glyphkey_hash,
+    equals: glyphkey_equals,
+    dup: glyphkey_clone,
+    free: glyphkey_destroy,
+};
+
+static void glyphcache_unlink(internal_t*i, glyphmask_t*mask)
+{
+    if(mask->prev) mask->prev->next = mask->next;
+    else i->glyphs_first = mask->next;
+    if(mask->next) mask->next->prev = mask->prev;
+    else i->glyphs_last = mask->prev;
+    mask->prev = mask->next = 0;
+}
+static void glyphcache_link(internal_t*i, glyphmask_t*mask)
+{
+    mask->prev = 0;
+    mask->next = i->glyphs_first;
+    if(i->glyphs_first) i->glyphs_first->prev = mask;
+    i->glyphs_first = mask;
+    if(!i->glyphs_last) i->glyphs_last = mask;
+}
+static void glyphmask_free(glyphmask_t*mask)
+{
+    rfx_free(mask->data);mask->data = 0;
+    rfx_free(mask);
+}
+static void glyphcache_destroy(internal_t*i)
+{
+    glyphmask_t*mask = i->glyphs_first;
+    while(mask) {
+	glyphmask_t*next = mask->next;
+	glyphmask_free(mask);
+	mask = next;
+    }
+    i->glyphs_first = i->glyphs_last = 0;
+    i->glyphs_size = 0;
+    dict_destroy(i->glyphs);i->glyphs = 0;
+}
+
+/* rasterize a glyph outline (in device coordinates, already shifted so that
+   its bounding box starts at 0,0) into a coverage mask, using the same
+   scanline code as all the other fills */
+static void glyphmask_rasterize(gfxdevice_t*dev, glyphmask_t*mask, gfxline_t*line)
+{
+    internal_t*i = (internal_t*)dev->internal;
+
+    renderline_t*lines = i->lines;
+    int width2 = i->width2, height2 = i->height2, bitwidth = i->bitwidth;
+    int ymin = i->ymin, ymax = i->ymax;
+    clipbuffer_t*clipbuf = i->clipbuf;
+
+    clipbuffer_t c;
+    c.data = mask->data;
+    c.next = 0;
+    i->clipbuf = &c;
+    i->lines = (renderline_t*)rfx_calloc(mask->height*sizeof(renderline_t));
+    i->width2 = mask->width;
+    i->height2 = mask->height;
+    i->bitwidth = mask->bitwidth;
+    i->ymin = 0x7fffffff;
+    i->ymax = -0x80000000;
+
+    fillinfo_t info;
+    memset(&info, 0, sizeof(info));
+    info.type = filltype_clip;
+    draw_line(dev, line);
+    fill(dev, &info);
+
+    int y;
+    for(y=0;y<mask->height;y++) {
+	rfx_free(i->lines[y].points);
+    }
+    rfx_free(i->lines);
+
+    i->lines = lines;
+    i->width2 = width2;
+    i->height2 = height2;
+    i->bitwidth = bitwidth;
+    i->ymin = ymin;
+    i->ymax = ymax;
+    i->clipbuf = clipbuf;
+}
+
+static glyphmask_t* glyphmask_new(gfxdevice_t*dev, gfxglyph_t*glyph, glyphkey_t*key)
+{
+    internal_t*i = (internal_t*)dev->internal;
+
+    if(!glyph->line)
+	return 0;
+
+    gfxmatrix_t m;
+    m.m00 = key->m00; m.m10 = key->m10;
+    m.m01 = key->m01; m.m11 = key->m11;
+    m.tx = (double)key->subx / (GLYPHCACHE_SUBPIXELS*i->zoom);
+    m.ty = (double)key->suby / (GLYPHCACHE_SUBPIXELS*i->zoom);
+    gfxline_t*line = gfxline_clone(glyph->line);
+    gfxline_transform(line, &m);
+
+    gfxbbox_t bbox = gfxline_getbbox(line);
+    int x1 = (int)floor(bbox.xmin*i->zoom);
+    int y1 = (int)floor(bbox.ymin*i->zoom);
+    int x2 = (int)ceil(bbox.xmax*i->zoom)+1;
+    int y2 = (int)ceil(bbox.ymax*i->zoom)+1;
+    int width = x2-x1;
+    int height = y2-y1;
+    int bitwidth = (width+31)/32;
+    int size = sizeof(glyphmask_t) + sizeof(U32)*bitwidth*height;
+
+    if(size > i->glyphs_maxsize/4) {
+	/* huge glyph- not worth caching */
+	gfxline_free(line);
+	return 0;
+    }
+
+    gfxmatrix_t shift = {1,0,-(double)x1/i->zoom,
+	                 0,1,-(double)y1/i->zoom};
+    gfxline_transform(line, &shift);
+
+    glyphmask_t*mask = (glyphmask_t*)rfx_calloc(sizeof(glyphmask_t));
+    mask->xoffset = x1;
+    mask->yoffset = y1;
+    mask->width = width;
+    mask->height = height;
+    mask->bitwidth = bitwidth;
+    mask->size = size;
+    mask->data = (U32*)rfx_calloc(sizeof(U32)*bitwidth*height);
+    glyphmask_rasterize(dev, mask, line);
+    gfxline_free(line);
+    return mask;
+}
+
+/* look up (or create) the coverage mask for a glyph drawn with the given matrix.
+   x,y receive the device position of the mask's top left corner. */
+static glyphmask_t* glyphcache_get(gfxdevice_t*dev, gfxfont_t*font, int glyphnr, gfxmatrix_t*matrix, int*x, int*y)
+{
+    internal_t*i = (internal_t*)dev->internal;
+
+    double px = matrix->tx*i->zoom;
+    double py = matrix->ty*i->zoom;
+    int ix = (int)floor(px);
+    int iy = (int)floor(py);
+
+    glyphkey_t key;
+    key.id = (char*)font->id;
+    key.glyphnr = glyphnr;
+    key.m00 = matrix->m00; key.m01 = matrix->m01;
+    key.m10 = matrix->m10; key.m11 = matrix->m11;
+    key.subx = (int)((px-ix)*GLYPHCACHE_SUBPIXELS);
+    key.suby = (int)((py-iy)*GLYPHCACHE_SUBPIXELS);
+
+    if(!i->glyphs)
+	i->glyphs = dict_new2(&glyphkey_type);
+
+    glyphmask_t*mask = (glyphmask_t*)dict_lookup(i->glyphs, &key);
+    if(mask) {
+	glyphcache_unlink(i, mask);
+    } else {
+	mask = glyphmask_new(dev, &font->glyphs[glyphnr], &key);
+	if(!mask)
+	    return 0;
+	dictentry_t*e = dict_put(i->glyphs, &key, mask);
+	mask->key = (glyphkey_t*)e->key;
+	i->glyphs_size += mask->size;
+
+	while(i->glyphs_size > i->glyphs_maxsize && i->glyphs_last) {
+	    glyphmask_t*old = i->glyphs_last;
+	    glyphcache_unlink(i, old);
+	    i->glyphs_size -= old->size;
+	    dict_del(i->glyphs, old->key);
+	    glyphmask_free(old);
+	}
+    }
+    glyphcache_link(i, mask);
+
+    *x = ix + mask->xoffset;
+    *y = iy + mask->yoffset;
+    return mask;
+}
+
+static void fill_mask_solid(internal_t*i, glyphmask_t*mask, int x1, int y1, RGBA col)
+{
+    int ainv = 255-col.a;
+    if(col.a!=255) {
+        col.r = (col.r*col.a)/255;
+        col.g = (col.g*col.a)/255;
+        col.b = (col.b*col.a)/255;
+    }
+    int y;
+    for(y=0;y<mask->height;y++) {
+	int yy = y1+y;
+	if(yy<0 || yy>=i->height2)
+	    continue;
+	U32*m = &mask->data[mask->bitwidth*y];
+	RGBA*line = &i->img[i->width2*yy];
+	U32*z = &i->clipbuf->data[i->bitwidth*yy];
+	int x;
+	for(x=0;x<mask->width;x++) {
+	    int xx = x1+x;
+	    if(!(m[x>>5]&(1<<(x&31))))
+		continue;
+	    if(xx<0 || xx>=i->width2 || !(z[xx>>5]&(1<<(xx&31))))
+		continue;
+	    if(col.a!=255) {
+		line[xx].r = ((line[xx].r*ainv)/255)+col.r;
+		line[xx].g = ((line[xx].g*ainv)/255)+col.g;
+		line[xx].b = ((line[xx].b*ainv)/255)+col.b;
+		line[xx].a = ((line[xx].a*ainv)/255)+col.a;
+	    } else {
+		line[xx] = col;
+	    }
+	}
+    }
+}
+
 void render_drawchar(struct _gfxdevice*dev, gfxfont_t*font, int glyphnr, gfxcolor_t*color, gfxmatrix_t*matrix)
 {
     internal_t*i = (internal_t*)dev->internal;
@@ -765,6 +1061,16 @@ void render_drawchar(struct _gfxdevice*dev, gfxfont_t*font, int glyphnr, gfxcolo
     matrix->tx = (int)(matrix->tx * i->antialize) / i->antialize;
     matrix->ty = (int)(matrix->ty * i->antialize) / i->antialize;
 
+    /* fonts without an id can't be told apart, so they bypass the cache */
+    if(i->glyphs_maxsize && font->id) {
+	int x,y;
+	glyphmask_t*mask = glyphcache_get(dev, font, glyphnr, matrix, &x, &y);
+	if(mask) {
+	    fill_mask_solid(i, mask, x, y, *color);
+	    return;
+	}
+    }
+
     gfxglyph_t*glyph = &font->glyphs[glyphnr];
     gfxline_t*line2 = gfxline_clone(glyph->line);
     gfxline_transform(line2, matrix);
@@ -896,6 +1202,7 @@ gfxresult_t* render_finish(struct _gfxdevice*dev)
     res->get = render_result_get;
     res->destroy = render_result_destroy;
 
+    glyphcache_destroy(i);
     free(dev->internal); dev->internal = 0; i = 0;
 
     return res;
@@ -1059,6 +1366,7 @@ void gfxdevice_render_init(gfxdevice_t*dev)
     i->antialize = 1;
     i->multiply = 1;
     i->zoom = 1;
+    i->glyphs_maxsize = GLYPHCACHE_DEFAULT_SIZE;
 
     dev->setparameter = render_setparameter;
     dev->startpage = render_startpage;
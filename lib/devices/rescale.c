@@ -110,8 +110,12 @@ gfxline_t*transformgfxline(internal_t*i, gfxline_t*line)
 	    return gfxline_clone(r);
 	}
     } */
-    gfxline_t*line2 = gfxline_clone(line);
-    gfxline_transform(line2, &i->matrix);
+    /* transform a packed copy, so that the result is a single memory block
+       instead of one allocation per segment */
+    gfxpath_t*path = gfxpath_from_gfxline(line);
+    gfxpath_transform(path, &i->matrix);
+    gfxline_t*line2 = gfxline_from_gfxpath(path);
+    gfxpath_free(path);
     return line2;
 }
 
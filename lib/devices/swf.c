@@ -89,6 +89,11 @@ typedef struct _swfoutput_internal
     double config_dumpfonts;
     double config_ppmsubpixels;
     double config_jpegsubpixels;
+    gfximage_filter_t config_imagefilter;
+    int config_imagethreads;
+    double config_quantize;
+    int config_dither;
+    double config_minpsnr;
     char hasbuttons;
     int config_invisibletexttofront;
     int config_dots;
@@ -99,6 +104,7 @@ typedef struct _swfoutput_internal
     int config_frameresets;
     int config_linknameurl;
     int config_jpegquality;
+    int config_jpegpassthrough;
     int config_storeallcharacters;
     int config_enablezlib;
     int config_insertstoptag;
@@ -219,6 +225,7 @@ static void swf_startclip(gfxdevice_t*dev, gfxline_t*line);
 static void swf_endclip(gfxdevice_t*dev);
 static void swf_stroke(gfxdevice_t*dev, gfxline_t*line, gfxcoord_t width, gfxcolor_t*color, gfx_capType cap_style, gfx_joinType joint_style, gfxcoord_t miterLimit);
 static void swf_fill(gfxdevice_t*dev, gfxline_t*line, gfxcolor_t*color);
+static void swf_fillpoly(gfxdevice_t*dev, gfxpoly_t*poly, gfxcolor_t*color);
 static void swf_fillgradient(gfxdevice_t*dev, gfxline_t*line, gfxgradient_t*gradient, gfxgradienttype_t type, gfxmatrix_t*matrix);
 static void swf_drawchar(gfxdevice_t*dev, gfxfont_t*font, int glyph, gfxcolor_t*color, gfxmatrix_t*matrix);
 static void swf_addfont(gfxdevice_t*dev, gfxfont_t*font);
@@ -269,10 +276,16 @@ static swfoutput_internal* init_internal_struct()
     i->config_dumpfonts=0;
     i->config_ppmsubpixels=0;
     i->config_jpegsubpixels=0;
+    i->config_imagefilter=GFXIMAGE_FILTER_BOX;
+    i->config_imagethreads=1;
+    i->config_quantize=0;
+    i->config_dither=0;
+    i->config_minpsnr=0;
     i->config_opennewwindow=1;
     i->config_ignoredraworder=0;
     i->config_drawonlyshapes=0;
     i->config_jpegquality=85;
+    i->config_jpegpassthrough=1;
     i->config_storeallcharacters=0;
     i->config_dots=1;
     i->config_enablezlib=0;
@@ -1859,6 +1872,73 @@ static void drawgfxline(gfxdevice_t*dev, gfxline_t*line, int fill)
     msg("<trace> drawgfxline, %d lines, %d splines", lines, splines);
 }
 
+typedef struct _polydraw_internal {
+    gfxdevice_t*dev;
+    double dx,dy;
+    int lines;
+} polydraw_internal_t;
+
+static void polydraw_moveTo(gfxdrawer_t*d, gfxcoord_t x, gfxcoord_t y)
+{
+    polydraw_internal_t*p = (polydraw_internal_t*)d->internal;
+    swfoutput_internal*i = (swfoutput_internal*)p->dev->internal;
+    moveto(p->dev, i->tag, x+p->dx, y+p->dy);
+}
+static void polydraw_lineTo(gfxdrawer_t*d, gfxcoord_t x, gfxcoord_t y)
+{
+    polydraw_internal_t*p = (polydraw_internal_t*)d->internal;
+    swfoutput_internal*i = (swfoutput_internal*)p->dev->internal;
+    lineto(p->dev, i->tag, x+p->dx, y+p->dy);
+    p->lines++;
+}
+
+/* same as drawgfxline, for packed paths. (dx,dy) is added to all coordinates */
+static void drawgfxpath(gfxdevice_t*dev, gfxpath_t*path, int fill, double dx, double dy)
+{
+    swfoutput_internal*i = (swfoutput_internal*)dev->internal;
+    int lines= 0, splines=0;
+    int t;
+
+    i->fill = fill;
+
+    gfxpoint_t*p = path->points;
+    for(t=0;t<path->num;t++) {
+	if(path->types[t] == gfx_moveTo) {
+	    moveto(dev, i->tag, p[t].x+dx, p[t].y+dy);
+	} else if(path->types[t] == gfx_lineTo) {
+	    lineto(dev, i->tag, p[t].x+dx, p[t].y+dy);
+	    lines++;
+	} else if(path->types[t] == gfx_splineTo) {
+	    plotxy_t s,e;
+	    s.x = path->controls[t].x+dx;e.x = p[t].x+dx;
+	    s.y = path->controls[t].y+dy;e.y = p[t].y+dy;
+	    splineto(dev, i->tag, s, e);
+	    splines++;
+	}
+    }
+    msg("<trace> drawgfxpath, %d lines, %d splines", lines, splines);
+}
+
+/* draw the outline of a polygon as shape records, without converting it to a gfxline first */
+static void drawgfxpoly(gfxdevice_t*dev, gfxpoly_t*poly, double dx, double dy)
+{
+    swfoutput_internal*i = (swfoutput_internal*)dev->internal;
+    i->fill = 1;
+
+    polydraw_internal_t p;
+    p.dev = dev;
+    p.dx = dx;
+    p.dy = dy;
+    p.lines = 0;
+    gfxdrawer_t d;
+    memset(&d, 0, sizeof(d));
+    d.internal = &p;
+    d.moveTo = polydraw_moveTo;
+    d.lineTo = polydraw_lineTo;
+    gfxpoly_draw(poly, &d);
+    msg("<trace> drawgfxpoly, %d lines", p.lines);
+}
+
 
 static void drawlink(gfxdevice_t*dev, ActionTAG*actions1, ActionTAG*actions2, gfxline_t*points, char mouseover, char*type, const char*url)
 {
@@ -2050,6 +2130,26 @@ int swf_setparameter(gfxdevice_t*dev, const char*name, const char*value)
 	i->config_ppmsubpixels = atof(value);
     } else if(!strcmp(name, "subpixels")) {
 	i->config_ppmsubpixels = i->config_jpegsubpixels = atof(value);
+    } else if(!strcmp(name, "quantize")) {
+	i->config_quantize = atof(value);
+    } else if(!strcmp(name, "dither")) {
+	i->config_dither = atoi(value);
+    } else if(!strcmp(name, "minpsnr")) {
+	i->config_minpsnr = atof(value);
+    } else if(!strcmp(name, "imagefilter")) {
+	if(!strcmp(value, "box")) {
+	    i->config_imagefilter = GFXIMAGE_FILTER_BOX;
+	} else if(!strcmp(value, "triangle")) {
+	    i->config_imagefilter = GFXIMAGE_FILTER_TRIANGLE;
+	} else if(!strcmp(value, "lanczos3")) {
+	    i->config_imagefilter = GFXIMAGE_FILTER_LANCZOS3;
+	} else {
+	    fprintf(stderr, "Unknown image filter '%s' (box, triangle or lanczos3)\n", value);
+	    return 1;
+	}
+    } else if(!strcmp(name, "imagethreads")) {
+	i->config_imagethreads = atoi(value);
+	gfximage_set_num_threads(i->config_imagethreads);
     } else if(!strcmp(name, "drawonlyshapes")) {
 	i->config_drawonlyshapes = atoi(value);
     } else if(!strcmp(name, "ignoredraworder")) {
@@ -2147,6 +2247,8 @@ int swf_setparameter(gfxdevice_t*dev, const char*name, const char*value)
 	if(val<0) val=0;
 	if(val>101) val=101;
 	i->config_jpegquality = val;
+    } else if(!strcmp(name, "jpegpassthrough")) {
+	i->config_jpegpassthrough = atoi(value);
     } else if(!strcmp(name, "splinequality")) {
 	int v = atoi(value);
 	v = 500-(v*5); // 100% = 0.25 pixel, 0% = 25 pixel
@@ -2172,6 +2274,13 @@ int swf_setparameter(gfxdevice_t*dev, const char*name, const char*value)
         printf("jpegsubpixels=<pixels>      resolution adjustment for jpeg images (same as jpegdpi, but in pixels)\n");
         printf("ppmsubpixels=<pixels        resolution adjustment for  lossless images (same as ppmdpi, but in pixels)\n");
         printf("subpixels=<pixels>          shortcut for setting both jpegsubpixels and ppmsubpixels\n");
+        printf("imagefilter=<filter>        filter for downscaling images: box (default), triangle or lanczos3\n");
+        printf("imagethreads=<num>          number of threads for rescaling and encoding large images (default: 1, 0 = one per processor)\n");
+        printf("quantize=<error>            store lossless images with more than 256 colors with a palette, too, if the\n");
+        printf("                            average error per color channel stays below <error> (e.g. 3)\n");
+        printf("dither                      dither quantized images\n");
+        printf("minpsnr=<dB>                try jpeg, palette, quantized and lossless versions of every image, and keep\n");
+        printf("                            the smallest one with a PSNR of at least <dB> (e.g. 35)\n");
         printf("drawonlyshapes              convert everything to shapes (currently broken)\n");
         printf("ignoredraworder             allow to perform a few optimizations for creating smaller SWFs\n");
         printf("linksopennewwindow          make links open a new browser window\n");
@@ -2195,6 +2304,7 @@ int swf_setparameter(gfxdevice_t*dev, const char*name, const char*value)
         printf("simpleviewer                Add next/previous buttons to the SWF\n");
         printf("animate                     insert a showframe tag after each placeobject (animate draw order of PDF files)\n");
         printf("jpegquality=<quality>       set compression quality of jpeg images\n");
+        printf("jpegpassthrough=0/1         store jpeg images which don't need to be scaled as they are (1)\n");
 	printf("splinequality=<value>       Set the quality of spline convertion to value (0-100, default: 100).\n");
 	printf("disablelinks                Disable links.\n");
     } else {
@@ -2271,7 +2381,7 @@ static int add_image(swfoutput_internal*i, gfximage_t*img, int targetwidth, int
     
     if(newsizex<sizex || newsizey<sizey) {
 	msg("<verbose> Scaling %dx%d image to %dx%d", sizex, sizey, newsizex, newsizey);
-	gfximage_t*ni = gfximage_rescale(img, newsizex, newsizey);
+	gfximage_t*ni = gfximage_rescale_filter(img, newsizex, newsizey, i->config_imagefilter);
 	newpic = (RGBA*)ni->data;
 	free(ni);
 	*newwidth = sizex = newsizex;
@@ -2282,17 +2392,20 @@ static int add_image(swfoutput_internal*i, gfximage_t*img, int targetwidth, int
 	*newheight = newsizey  = sizey;
     }
 
-    int num_colors = swf_ImageGetNumberOfPaletteEntries(mem,sizex,sizey,0);
-    int has_alpha = swf_ImageHasAlpha(mem,sizex,sizey);
-    
-    msg("<verbose> Drawing %dx%d %s%simage (id %d) at size %dx%d (%dx%d), %s%d colors",
-	    sizex, sizey, 
-	    has_alpha?(has_alpha==2?"semi-transparent ":"transparent "):"", 
-	    is_jpeg?"jpeg-":"", i->currentswfid+1,
-	    newsizex, newsizey,
-	    targetwidth, targetheight,
-	    /*newsizex, newsizey,*/
-	    num_colors>256?">":"", num_colors>256?256:num_colors);
+    if(maxloglevel >= LOGLEVEL_VERBOSE) {
+	/* the colors are counted again (and for real) by swf_AddImage */
+	int num_colors = swf_ImageGetNumberOfPaletteEntries(mem,sizex,sizey,0);
+	int has_alpha = swf_ImageHasAlpha(mem,sizex,sizey);
+	
+	msg("<verbose> Drawing %dx%d %s%simage (id %d) at size %dx%d (%dx%d), %s%d colors",
+		sizex, sizey, 
+		has_alpha?(has_alpha==2?"semi-transparent ":"transparent "):"", 
+		is_jpeg?"jpeg-":"", i->currentswfid+1,
+		newsizex, newsizey,
+		targetwidth, targetheight,
+		/*newsizex, newsizey,*/
+		num_colors>256?">":"", num_colors>256?256:num_colors);
+    }
 
     /*RGBA* pal = (RGBA*)rfx_alloc(sizeof(RGBA)*num_colors);
     swf_ImageGetNumberOfPaletteEntries(mem,sizex,sizey,pal);
@@ -2311,7 +2424,20 @@ static int add_image(swfoutput_internal*i, gfximage_t*img, int targetwidth, int
     if(cacheid<=0) {
 	bitid = getNewID(dev);
 
-	i->tag = swf_AddImage(i->tag, bitid, mem, sizex, sizey, i->config_jpegquality);
+	int jpeglen = 0;
+	const unsigned char*jpeg = 0;
+	if(is_jpeg && !newpic && i->config_jpegpassthrough && i->config_jpegquality<=100)
+	    jpeg = gfximage_get_jpeg(img, &jpeglen);
+	if(jpeg) {
+	    msg("<verbose> Storing original jpeg data (%d bytes)", jpeglen);
+	    i->tag = swf_InsertTag(i->tag, ST_DEFINEBITSJPEG2);
+	    swf_SetU16(i->tag, bitid);
+	    swf_SetBlock(i->tag, (U8*)jpeg, jpeglen);
+	} else if(i->config_minpsnr > 0) {
+	    i->tag = swf_AddImageAdaptive(i->tag, bitid, mem, sizex, sizey, i->config_jpegquality, i->config_minpsnr, i->config_imagethreads);
+	} else {
+	    i->tag = swf_AddImageQuantized(i->tag, bitid, mem, sizex, sizey, i->config_jpegquality, i->config_quantize, i->config_dither);
+	}
 	addImageToCache(dev, mem, sizex, sizey);
     } else {
 	bitid = cacheid;
@@ -2667,9 +2793,7 @@ static void swf_stroke(gfxdevice_t*dev, gfxline_t*line, gfxcoord_t width, gfxcol
 	    gfxline_fix_short_edges(line);
 	/* we need to convert the line into a polygon */
 	gfxpoly_t* poly = gfxpoly_from_stroke(line, width, cap_style, joint_style, miterLimit, DEFAULT_GRID);
-	gfxline_t*gfxline = gfxline_from_gfxpoly(poly);
-	dev->fill(dev, gfxline, color);
-	gfxline_free(gfxline);
+	swf_fillpoly(dev, poly, color);
 	gfxpoly_destroy(poly);
 	return;
     }
@@ -2696,22 +2820,18 @@ static void swf_stroke(gfxdevice_t*dev, gfxline_t*line, gfxcoord_t width, gfxcol
     drawgfxline(dev, line, 0);
 
     if(i->config_normalize_polygon_positions) {
-	free(line); //account for _move
+	gfxline_free(line); //account for _move
     }
 
 }
 
-static void swf_fill(gfxdevice_t*dev, gfxline_t*line, gfxcolor_t*color)
+/* fill a gfxline, a packed path or a gfxpoly (exactly one of them is set) */
+static void fillshape(gfxdevice_t*dev, gfxline_t*line, gfxpath_t*path, gfxpoly_t*poly, gfxbbox_t r, gfxcolor_t*color)
 {
     swfoutput_internal*i = (swfoutput_internal*)dev->internal;
-    if(line_is_empty(line))
-	return;
     if(!color->a)
 	return;
 
-    gfxbbox_t r = gfxline_getbbox(line);
-    int is_outside_page = !is_inside_page(dev, r.xmin, r.ymin) || !is_inside_page(dev, r.xmax, r.ymax);
-
     if(r.xmax - r.xmin < i->config_remove_small_polygons &&
        r.ymax - r.ymin < i->config_remove_small_polygons) {
 	msg("<verbose> Not drawing %.2fx%.2f polygon", r.xmax - r.xmin, r.ymax - r.ymin);
@@ -2723,14 +2843,24 @@ static void swf_fill(gfxdevice_t*dev, gfxline_t*line, gfxcolor_t*color)
     if(!i->config_ignoredraworder)
 	endshape(dev);
 
+    double startx = 0, starty = 0;
     if(i->config_normalize_polygon_positions) {
 	endshape(dev);
-	double startx = 0, starty = 0;
-	if(line && line->type == gfx_moveTo) {
-	    startx = line->x;
-	    starty = line->y;
+	if(line) {
+	    if(line->type == gfx_moveTo) {
+		startx = line->x;
+		starty = line->y;
+	    }
+	    line = gfxline_move(line, -startx, -starty);
+	} else if(path) {
+	    if(path->types[0] == gfx_moveTo) {
+		startx = path->points[0].x;
+		starty = path->points[0].y;
+	    }
+	} else {
+	    startx = r.xmin;
+	    starty = r.ymin;
 	}
-	line = gfxline_move(line, -startx, -starty);
 	i->shapeposx = (int)(startx*20);
 	i->shapeposy = (int)(starty*20);
     }
@@ -2738,7 +2868,12 @@ static void swf_fill(gfxdevice_t*dev, gfxline_t*line, gfxcolor_t*color)
     swfoutput_setfillcolor(dev, color->r, color->g, color->b, color->a);
     startshape(dev);
     startFill(dev);
-    drawgfxline(dev, line, 1);
+    if(line)
+	drawgfxline(dev, line, 1);
+    else if(path)
+	drawgfxpath(dev, path, 1, -startx, -starty);
+    else
+	drawgfxpoly(dev, poly, -startx, -starty);
     
     if(i->currentswfid==2 && r.xmin==0 && r.ymin==0 && r.xmax==i->max_x && r.ymax==i->max_y) {
 	if(i->config_watermark) {
@@ -2748,11 +2883,40 @@ static void swf_fill(gfxdevice_t*dev, gfxline_t*line, gfxcolor_t*color)
 
     msg("<trace> end of swf_fill (shapeid=%d)", i->shapeid);
 
-    if(i->config_normalize_polygon_positions) {
-	free(line); //account for _move
+    if(line && i->config_normalize_polygon_positions) {
+	gfxline_free(line); //account for _move
     }
 }
 
+static void swf_fill(gfxdevice_t*dev, gfxline_t*line, gfxcolor_t*color)
+{
+    if(line_is_empty(line))
+	return;
+    fillshape(dev, line, 0, 0, gfxline_getbbox(line), color);
+}
+
+/* like swf_fill, but for packed paths */
+static void swf_fillpath(gfxdevice_t*dev, gfxpath_t*path, gfxcolor_t*color)
+{
+    int t;
+    for(t=0;t<path->num;t++) {
+	if(path->types[t] != gfx_moveTo)
+	    break;
+    }
+    if(t == path->num)
+	return;
+    fillshape(dev, 0, path, 0, gfxpath_getbbox(path), color);
+}
+
+/* like swf_fill, but takes the outline directly from a polygon */
+static void swf_fillpoly(gfxdevice_t*dev, gfxpoly_t*poly, gfxcolor_t*color)
+{
+    gfxbbox_t r = gfxpoly_getbbox(poly);
+    if(r.xmin == r.xmax && r.ymin == r.ymax)
+	return;
+    fillshape(dev, 0, 0, poly, r, color);
+}
+
 static GRADIENT* gfxgradient_to_GRADIENT(gfxgradient_t*gradient)
 {
     int num = 0;
@@ -3093,10 +3257,10 @@ static void swf_drawchar(gfxdevice_t*dev, gfxfont_t*font, int glyph, gfxcolor_t*
 
     if(i->config_drawonlyshapes) {
         gfxglyph_t*g = &font->glyphs[glyph];
-        gfxline_t*line2 = gfxline_clone(g->line);
-        gfxline_transform(line2, matrix);
-	dev->fill(dev, line2, color);
-        gfxline_free(line2);
+        gfxpath_t*path = gfxpath_from_gfxline(g->line);
+        gfxpath_transform(path, matrix);
+	swf_fillpath(dev, path, color);
+        gfxpath_free(path);
         return;
     }
 
@@ -9,6 +9,11 @@
 #include "mem.h"
 #include "gfximage.h"
 #include "types.h"
+#include "os.h"
+#include "pixelops/pixelops.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 #ifdef HAVE_FFTW3
 #include <fftw3.h>
 #endif
@@ -49,68 +54,140 @@ void gfximage_save_png_quick(gfximage_t*image, const char*filename)
     png_write_quick(filename, (void*)image->data, image->width, image->height);
 }
 
-typedef struct scale_lookup {
-    int pos;
-    unsigned int weight;
-} scale_lookup_t;
+static gfximage_filter_t default_filter = GFXIMAGE_FILTER_BOX;
+static int num_threads = 1;
 
-typedef struct rgba_int {
-    unsigned int r,g,b,a;
-} rgba_int_t;
+void gfximage_set_filter(gfximage_filter_t filter)
+{
+    default_filter = filter;
+}
+
+void gfximage_set_num_threads(int num)
+{
+    num_threads = num;
+}
 
-static int bicubic = 0;
+static double filter_radius(gfximage_filter_t filter)
+{
+    switch(filter) {
+	case GFXIMAGE_FILTER_TRIANGLE: return 1.0;
+	case GFXIMAGE_FILTER_LANCZOS3: return 3.0;
+	default: return 0.5;
+    }
+}
 
-static scale_lookup_t**make_scale_lookup(int width, int newwidth)
+static double sinc(double x)
 {
-    scale_lookup_t*lookupx = (scale_lookup_t*)rfx_alloc((width>newwidth?width:newwidth)*2*sizeof(scale_lookup_t));
-    scale_lookup_t**lblockx = (scale_lookup_t**)rfx_alloc((newwidth+1)*sizeof(scale_lookup_t**));
-    double fx = ((double)width)/((double)newwidth);
-    double px = 0;
-    int x;
-    scale_lookup_t*p_x = lookupx;
-
-    if(newwidth<=width) {
-	for(x=0;x<newwidth;x++) {
-	    double ex = px + fx;
-	    int fromx = (int)px;
-	    int tox = (int)ex;
-	    double rem = fromx+1-px;
-	    int i = (int)(256/fx);
-	    int xweight = (int)(rem*256/fx);
-	    int xx;
-	    int w = 0;
-	    lblockx[x] = p_x;
-	    if(tox>=width) tox = width-1;
-	    for(xx=fromx;xx<=tox;xx++) {
-		if(xx==fromx && xx==tox) p_x->weight = 256;
-		else if(xx==fromx) p_x->weight = xweight;
-		else if(xx==tox) p_x->weight = 256-w;
-		else p_x->weight = i;
-		w+=p_x->weight;
-		p_x->pos = xx;
-		p_x++;
+    if(x==0)
+	return 1.0;
+    x *= M_PI;
+    return sin(x)/x;
+}
+
+static double filter_weight(gfximage_filter_t filter, double x)
+{
+    if(x<0) x=-x;
+    switch(filter) {
+	case GFXIMAGE_FILTER_TRIANGLE:
+	    return x<1.0 ? 1.0-x : 0;
+	case GFXIMAGE_FILTER_LANCZOS3:
+	    return x<3.0 ? sinc(x)*sinc(x/3.0) : 0;
+	default:
+	    return x<=0.5 ? 1.0 : 0;
+    }
+}
+
+/* weights for resampling one axis: destination pixel x is computed from
+   the bounds[x*2+1] source pixels starting at bounds[x*2], weighted with
+   weights[x*ksize] ... */
+typedef struct _resample_axis {
+    int ksize;
+    int*bounds;
+    short*weights;
+} resample_axis_t;
+
+static void resample_axis_init(resample_axis_t*axis, int size, int newsize, gfximage_filter_t filter)
+{
+    const int one = 1<<PIXELOPS_WEIGHT_BITS;
+    double scale = (double)size/newsize;
+    /* when downscaling, the filter is stretched so that it covers all the
+       source pixels that fall into a destination pixel */
+    double filterscale = scale>1.0 ? scale : 1.0;
+    /* a box filter would enlarge the image with nearest neighbour. Enlarge
+       bilinearly instead, like the old scaler did. */
+    if(filter == GFXIMAGE_FILTER_BOX && scale<1.0)
+	filter = GFXIMAGE_FILTER_TRIANGLE;
+    double support = filter_radius(filter)*filterscale;
+    int ksize = (int)ceil(support*2)+2;
+    double*w = (double*)rfx_alloc(ksize*sizeof(double));
+    int*q = (int*)rfx_alloc(ksize*sizeof(int));
+    int x,k;
+
+    axis->ksize = ksize;
+    axis->bounds = (int*)rfx_alloc(newsize*2*sizeof(int));
+    axis->weights = (short*)rfx_calloc(newsize*ksize*sizeof(short));
+
+    for(x=0;x<newsize;x++) {
+	double center = (x+0.5)*scale;
+	int from = (int)floor(center-support);
+	int to = (int)ceil(center+support);
+	if(from<0) from=0;
+	if(to>size) to=size;
+	if(to<=from) {
+	    /* can't happen, but be safe */
+	    from = (int)center<size ? (int)center : size-1;
+	    to = from+1;
+	}
+	int count = to-from;
+	double total = 0;
+	for(k=0;k<count;k++) {
+	    double pos = from+k;
+	    if(filter == GFXIMAGE_FILTER_BOX) {
+		/* how much of the source pixel falls into the destination pixel */
+		double l = pos > center-support ? pos : center-support;
+		double r = pos+1 < center+support ? pos+1 : center+support;
+		w[k] = r>l ? r-l : 0;
+	    } else {
+		w[k] = filter_weight(filter, (pos+0.5-center)/filterscale);
 	    }
-	    px = ex;
+	    total += w[k];
 	}
-    } else {
-	for(x=0;x<newwidth;x++) {
-	    int ix1 = (int)px;
-	    int ix2 = ((int)px)+1;
-	    double r = px-ix1;
-	    if(ix2>=width) ix2=width-1;
-	    lblockx[x] = p_x;
-	    if(bicubic)
-		r = -2*r*r*r+3*r*r;
-	    p_x[0].weight = (int)(256*(1-r));
-	    p_x[0].pos = ix1;
-	    p_x[1].weight = 256-p_x[0].weight;
-	    p_x[1].pos = ix2;
-	    p_x+=2;
-	    px += fx;
+	if(total == 0) {
+	    int nearest = (int)(center-from);
+	    if(nearest>=count) nearest=count-1;
+	    w[nearest] = total = 1.0;
+	}
+	/* convert to fixed point. Any rounding error goes into the largest
+	   weight, so that a solid color stays the same. */
+	int sum = 0, largest = 0;
+	for(k=0;k<count;k++) {
+	    q[k] = (int)floor(w[k]*one/total+0.5);
+	    sum += q[k];
+	    if(q[k] > q[largest])
+		largest = k;
 	}
+	q[largest] += one-sum;
+
+	/* drop zero weights on both ends */
+	int first = 0;
+	while(first<count-1 && !q[first])
+	    first++;
+	while(count>first+1 && !q[count-1])
+	    count--;
+
+	axis->bounds[x*2] = from+first;
+	axis->bounds[x*2+1] = count-first;
+	for(k=first;k<count;k++)
+	    axis->weights[x*ksize+k-first] = q[k];
     }
-    lblockx[newwidth] = p_x;
-    return lblockx;
+    rfx_free(w);
+    rfx_free(q);
+}
+
+static void resample_axis_destroy(resample_axis_t*axis)
+{
+    rfx_free(axis->bounds);
+    rfx_free(axis->weights);
 }
 
 static void encodeMonochromeImage(gfxcolor_t*data, int width, int height, gfxcolor_t*colors)
@@ -271,12 +348,54 @@ int gfximage_getNumberOfPaletteEntries(gfximage_t*img)
     return 2;
 }
 
-gfximage_t* gfximage_rescale_old(gfximage_t*image, int newwidth, int newheight)
+/* rows are resampled in blocks of this many, which are distributed
+   over the threads */
+#define RESAMPLE_ROWS 16
+
+typedef struct _resample_job {
+    gfxcolor_t*src;
+    gfxcolor_t*tmp;
+    gfxcolor_t*dest;
+    int width;
+    int newwidth;
+    int newheight;
+    /* source rows needed by the vertical pass */
+    int ymin, ymax;
+    resample_axis_t x, y;
+} resample_job_t;
+
+static void resample_horizontal(void*data, int nr)
+{
+    resample_job_t*job = (resample_job_t*)data;
+    int y1 = job->ymin + nr*RESAMPLE_ROWS;
+    int y2 = y1 + RESAMPLE_ROWS < job->ymax ? y1 + RESAMPLE_ROWS : job->ymax;
+    int y;
+    for(y=y1;y<y2;y++) {
+	pixelops_resample_h(&job->tmp[y*job->newwidth], &job->src[y*job->width], job->newwidth,
+			    job->x.bounds, job->x.weights, job->x.ksize);
+    }
+}
+
+static void resample_vertical(void*data, int nr)
+{
+    resample_job_t*job = (resample_job_t*)data;
+    const void**rows = (const void**)rfx_alloc(job->y.ksize*sizeof(void*));
+    int y1 = nr*RESAMPLE_ROWS;
+    int y2 = y1 + RESAMPLE_ROWS < job->newheight ? y1 + RESAMPLE_ROWS : job->newheight;
+    int y;
+    for(y=y1;y<y2;y++) {
+	int from = job->y.bounds[y*2];
+	int count = job->y.bounds[y*2+1];
+	int k;
+	for(k=0;k<count;k++)
+	    rows[k] = &job->tmp[(from+k)*job->newwidth];
+	pixelops_resample_v(&job->dest[y*job->newwidth], rows, &job->y.weights[y*job->y.ksize], count, job->newwidth);
+    }
+    rfx_free(rows);
+}
+
+gfximage_t* gfximage_rescale_filter(gfximage_t*image, int newwidth, int newheight, gfximage_filter_t filter)
 {
-    int x,y;
-    gfxcolor_t* newdata; 
-    scale_lookup_t *p, **lblockx,**lblocky;
-    rgba_int_t*tmpline;
     int monochrome = 0;
     gfxcolor_t monochrome_colors[2];
    
@@ -302,74 +421,55 @@ gfximage_t* gfximage_rescale_old(gfximage_t*image, int newwidth, int newheight)
         }
     }
 
-    tmpline = (rgba_int_t*)rfx_alloc(width*sizeof(rgba_int_t));
-    newdata = (gfxcolor_t*)rfx_alloc(newwidth*newheight*sizeof(gfxcolor_t));
-  
-    lblockx = make_scale_lookup(width, newwidth);
-    lblocky = make_scale_lookup(height, newheight);
-
-    for(p=lblocky[0];p<lblocky[newheight];p++)
-	p->pos*=width;
-
-    for(y=0;y<newheight;y++) {
-	gfxcolor_t*destline = &newdata[y*newwidth];
-	
-	/* create lookup table for y */
-	rgba_int_t*l = tmpline;
-	scale_lookup_t*p_y,*p_x;
-	memset(tmpline, 0, width*sizeof(rgba_int_t));
-	for(p_y=lblocky[y];p_y<lblocky[y+1];p_y++) {
-	    gfxcolor_t*line = &data[p_y->pos];
-	    scale_lookup_t*p_x;
-	    int weight = p_y->weight;
-	    for(x=0;x<width;x++) {
-		tmpline[x].r += line[x].r*weight;
-		tmpline[x].g += line[x].g*weight;
-		tmpline[x].b += line[x].b*weight;
-		tmpline[x].a += line[x].a*weight;
-	    }
-	}
-
-	/* process x direction */
-	p_x = lblockx[0];
-	for(x=0;x<newwidth;x++) {
-	    unsigned int r=0,g=0,b=0,a=0;
-	    scale_lookup_t*p_x_to = lblockx[x+1];
-	    do { 
-		rgba_int_t* col = &tmpline[p_x->pos];
-		unsigned int weight = p_x->weight;
-		r += col->r*weight;
-		g += col->g*weight;
-		b += col->b*weight;
-		a += col->a*weight;
-		p_x++;
-	    } while (p_x<p_x_to);
-
-	    destline->r = r >> 16;
-	    destline->g = g >> 16;
-	    destline->b = b >> 16;
-	    destline->a = a >> 16;
-	   
-	    destline++;
-	}
+    resample_job_t job;
+    job.src = data;
+    job.width = width;
+    job.newwidth = newwidth;
+    job.newheight = newheight;
+    resample_axis_init(&job.x, width, newwidth, filter);
+    resample_axis_init(&job.y, height, newheight, filter);
+    job.ymin = job.y.bounds[0];
+    job.ymax = job.y.bounds[(newheight-1)*2] + job.y.bounds[(newheight-1)*2+1];
+
+    job.dest = (gfxcolor_t*)rfx_alloc(newwidth*newheight*sizeof(gfxcolor_t));
+
+    /* small images aren't worth starting threads for */
+    int threads = num_threads;
+    if((U64)width*height + (U64)newwidth*newheight < 0x40000)
+	threads = 1;
+
+    if(newwidth == width) {
+	job.tmp = data;
+    } else {
+	job.tmp = (gfxcolor_t*)rfx_alloc(newwidth*height*sizeof(gfxcolor_t));
+	parallel_for((job.ymax-job.ymin+RESAMPLE_ROWS-1)/RESAMPLE_ROWS, resample_horizontal, &job, threads);
+    }
+    if(newheight == height) {
+	memcpy(job.dest, job.tmp, newwidth*newheight*sizeof(gfxcolor_t));
+    } else {
+	parallel_for((newheight+RESAMPLE_ROWS-1)/RESAMPLE_ROWS, resample_vertical, &job, threads);
     }
 
     if(monochrome)
-	decodeMonochromeImage(newdata, newwidth, newheight, monochrome_colors);
+	decodeMonochromeImage(job.dest, newwidth, newheight, monochrome_colors);
 
-    rfx_free(tmpline);
-    rfx_free(*lblockx);
-    rfx_free(lblockx);
-    rfx_free(*lblocky);
-    rfx_free(lblocky);
+    if(job.tmp != data)
+	rfx_free(job.tmp);
+    resample_axis_destroy(&job.x);
+    resample_axis_destroy(&job.y);
 
     gfximage_t*image2 = (gfximage_t*)malloc(sizeof(gfximage_t));
-    image2->data = newdata;
+    image2->data = job.dest;
     image2->width = newwidth;
     image2->height = newheight;
     return image2;
 }
 
+gfximage_t* gfximage_rescale(gfximage_t*image, int newwidth, int newheight)
+{
+    return gfximage_rescale_filter(image, newwidth, newheight, default_filter);
+}
+
 #ifdef HAVE_FFTW3
 gfximage_t* gfximage_rescale_fft(gfximage_t*image, int newwidth, int newheight)
 {
@@ -468,19 +568,6 @@ gfximage_t* gfximage_rescale_fft(gfximage_t*image, int newwidth, int newheight)
 }
 #endif
 
-#ifdef HAVE_FFTW3
-gfximage_t* gfximage_rescale(gfximage_t*image, int newwidth, int newheight)
-{
-    //return gfximage_rescale_fft(image, newwidth, newheight);
-    return gfximage_rescale_old(image, newwidth, newheight);
-}
-#else
-gfximage_t* gfximage_rescale(gfximage_t*image, int newwidth, int newheight)
-{
-    return gfximage_rescale_old(image, newwidth, newheight);
-}
-#endif
-
 bool gfximage_has_alpha(gfximage_t*img)
 {
     int size = img->width*img->height;
@@ -493,6 +580,73 @@ bool gfximage_has_alpha(gfximage_t*img)
     return 0;
 }
 
+/* The attachments are keyed by the pixel buffer, so that gfximage_t
+   doesn't need to change, and so that devices passing an image on (in a
+   copy of the gfximage_t struct, or in one of their own) keep them. */
+typedef struct _jpegattachment {
+    const gfxcolor_t*pixels;
+    int width, height;
+    const unsigned char*data;
+    int len;
+    struct _jpegattachment*next;
+} jpegattachment_t;
+
+static jpegattachment_t*attachments = 0;
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t attachments_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK_ATTACHMENTS pthread_mutex_lock(&attachments_mutex)
+#define UNLOCK_ATTACHMENTS pthread_mutex_unlock(&attachments_mutex)
+#else
+#define LOCK_ATTACHMENTS
+#define UNLOCK_ATTACHMENTS
+#endif
+
+void gfximage_attach_jpeg(gfximage_t*img, const unsigned char*data, int len)
+{
+    jpegattachment_t*a = (jpegattachment_t*)rfx_calloc(sizeof(jpegattachment_t));
+    a->pixels = img->data;
+    a->width = img->width;
+    a->height = img->height;
+    a->data = data;
+    a->len = len;
+    LOCK_ATTACHMENTS;
+    a->next = attachments;
+    attachments = a;
+    UNLOCK_ATTACHMENTS;
+}
+
+void gfximage_detach_jpeg(gfximage_t*img)
+{
+    LOCK_ATTACHMENTS;
+    jpegattachment_t**a = &attachments;
+    while(*a) {
+	if((*a)->pixels == img->data) {
+	    jpegattachment_t*next = (*a)->next;
+	    free(*a);
+	    *a = next;
+	} else {
+	    a = &(*a)->next;
+	}
+    }
+    UNLOCK_ATTACHMENTS;
+}
+
+const unsigned char* gfximage_get_jpeg(gfximage_t*img, int*len)
+{
+    const unsigned char*data = 0;
+    LOCK_ATTACHMENTS;
+    jpegattachment_t*a;
+    for(a=attachments;a;a=a->next) {
+	if(a->pixels == img->data && a->width == img->width && a->height == img->height) {
+	    data = a->data;
+	    *len = a->len;
+	    break;
+	}
+    }
+    UNLOCK_ATTACHMENTS;
+    return data;
+}
+
 void gfximage_free(gfximage_t*b)
 {
     free(b->data);
@@ -4,12 +4,43 @@
 #include <stdbool.h>
 #include "gfxdevice.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 gfximage_t*gfximage_new(int width, int height);
 void gfximage_save_jpeg(gfximage_t*image, const char*filename, int quality);
 void gfximage_save_png(gfximage_t*image, const char*filename);
 void gfximage_save_png_quick(gfximage_t*image, const char*filename);
+
+typedef enum {GFXIMAGE_FILTER_BOX, GFXIMAGE_FILTER_TRIANGLE, GFXIMAGE_FILTER_LANCZOS3} gfximage_filter_t;
+
+/* resample the image with the filter set by gfximage_set_filter() (default: box).
+   The box filter is only used for shrinking, images are enlarged with a
+   triangle (bilinear) filter. */
 gfximage_t* gfximage_rescale(gfximage_t*image, int newwidth, int newheight);
+gfximage_t* gfximage_rescale_filter(gfximage_t*image, int newwidth, int newheight, gfximage_filter_t filter);
+void gfximage_set_filter(gfximage_filter_t filter);
+/* number of threads used for rescaling large images (default: 1,
+   0 = one per processor) */
+void gfximage_set_num_threads(int num);
+
+/* Tell devices that the pixels of image are exactly what the given JPEG
+   file (baseline, YCbCr) decodes to, so that they may store the JPEG data
+   instead of compressing the pixels again. The data isn't copied, and
+   needs to stay around until gfximage_detach_jpeg() is called.
+   Devices which modify the pixels allocate a new image, and thereby
+   lose the attachment. */
+void gfximage_attach_jpeg(gfximage_t*image, const unsigned char*data, int len);
+void gfximage_detach_jpeg(gfximage_t*image);
+/* returns 0 if no JPEG data is attached */
+const unsigned char* gfximage_get_jpeg(gfximage_t*image, int*len);
+
 bool gfximage_has_alpha(gfximage_t*image);
 void gfximage_free(gfximage_t*b);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -44,20 +44,40 @@ void gfxpoly_destroy(gfxpoly_t*poly);
 
 /* constructors */
 gfxpoly_t* gfxpoly_from_fill(gfxline_t*line, double gridsize);
+gfxpoly_t* gfxpoly_from_path(gfxpath_t*path, double gridsize);
 gfxpoly_t* gfxpoly_from_stroke(gfxline_t*line, gfxcoord_t width, gfx_capType cap_style, gfx_joinType joint_style, gfxcoord_t miterLimit, double gridsize);
 
 /* operators */
 gfxpoly_t* gfxpoly_intersect(gfxpoly_t*p1, gfxpoly_t*p2);
 gfxpoly_t* gfxpoly_union(gfxpoly_t*p1, gfxpoly_t*p2);
+/* union of an arbitrary number of polygons, in a single sweep */
+gfxpoly_t* gfxpoly_union_many(gfxpoly_t**polys, int num);
+
+/* intersection with an axis-aligned box (faster than gfxpoly_intersect, as no
+   sweep is needed). The box is snapped to the polygon grid */
+gfxpoly_t* gfxpoly_intersect_box(gfxpoly_t*poly, gfxbbox_t*box);
 
 /* area functions */
 double gfxpoly_area(gfxpoly_t*p);
 double gfxpoly_intersection_area(gfxpoly_t*p1, gfxpoly_t*p2);
 
+/* number of threads used for processing big polygons (0 = one per cpu). The default is 1 */
+void gfxpoly_set_num_threads(int num);
+
 /* conversion functions */
 gfxpoly_t* gfxpoly_createbox(double x1, double y1,double x2, double y2, double gridsize);
+gfxbbox_t gfxpoly_getbbox(gfxpoly_t*poly);
+
+/* debugging: write a polygon to a (postscript) file, which can be
+   read back with gfxpoly_from_file */
+void gfxpoly_save(gfxpoly_t*poly, const char*filename);
+gfxpoly_t* gfxpoly_from_file(const char*filename, double gridsize);
+
 gfxline_t* gfxline_from_gfxpoly(gfxpoly_t*poly);
 gfxline_t* gfxline_from_gfxpoly_with_direction(gfxpoly_t*poly);
+/* send the outline of a polygon (the same path gfxline_from_gfxpoly returns)
+   to a drawer, without building a gfxline first. Only moveTo and lineTo are called */
+void gfxpoly_draw(gfxpoly_t*poly, gfxdrawer_t*draw);
 gfxline_t* gfxpoly_circular_to_evenodd(gfxline_t*line, double gridsize);
 
 #ifdef __cplusplus
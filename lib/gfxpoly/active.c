@@ -82,8 +82,22 @@ static inline double cmp(segment_t*s, point_t p1, point_t p2)
     return d;
 }
 
-#ifdef SPLAY
 static void actlist_splay_dump(actlist_t*a);
+
+static segment_t* actlist_find_list(actlist_t*a, point_t p1, point_t p2)
+{
+    segment_t*last=0, *s = a->list;
+    if(!s) return last;
+    while(s) {
+	double d = cmp(s, p1, p2);
+        if(d<0)
+            break;
+        last = s;
+        s = s->right;
+    }
+    return last;
+}
+
 segment_t* actlist_find(actlist_t*a, point_t p1, point_t p2)
 {
 #ifdef CHECKS
@@ -120,8 +134,11 @@ segment_t* actlist_find(actlist_t*a, point_t p1, point_t p2)
     }
 #endif
 #endif
+    if(!a->root) {
+	/* small list, no tree */
+	return actlist_find_list(a, p1, p2);
+    }
     segment_t*last=0, *s = a->root;
-    if(!s) return 0;
     double d=0;
     int depth = 0;
     while(s) {
@@ -193,23 +210,6 @@ segment_t* actlist_find(actlist_t*a, point_t p1, point_t p2)
 
     return last;
 }
-#else
-segment_t* actlist_find(actlist_t*a, point_t p1, point_t p2)
-{
-    segment_t*last=0, *s = a->list;
-    if(!s) return last;
-    while(s) {
-	double d = cmp(s, p1, p2);
-        if(d<0)
-            break;
-        last = s;
-        s = s->right;
-    }
-    return last;
-}
-#endif
-
-#ifdef SPLAY
 
 #define LINK(node,side,child) (node)->side = (child);if(child) {(child)->parent = (node);}
  //;fprintf(stderr, "[%d]->%s now [%d]\n", SEGNR(node), __STRING(side), SEGNR(child));
@@ -287,6 +287,14 @@ static int actlist_splay_walk(actlist_t*a, segment_t*s, segment_t**ss, segment_t
 static int actlist_splay_verify(actlist_t*a)
 {
     segment_t*c = a->list;
+    if(!a->root) {
+	/* list mode: no segment may have tree pointers */
+	for(;c;c=c->right) {
+	    if(c->parent || c->leftchild || c->rightchild)
+		return 0;
+	}
+	return 1;
+    }
     if(!actlist_splay_walk(a, a->root, &c, 0)) return 0;
     if(c) return 0;
     return 1;
@@ -433,15 +441,72 @@ static void actlist_splay(actlist_t*a, point_t p1, point_t p2)
     a->root->parent = 0;
 }
 
-#endif
+static segment_t* build_tree(segment_t**segs, int num, segment_t*parent)
+{
+    if(!num)
+	return 0;
+    int mid = num/2;
+    segment_t*s = segs[mid];
+    s->parent = parent;
+    s->leftchild = build_tree(segs, mid, s);
+    s->rightchild = build_tree(segs+mid+1, num-mid-1, s);
+    return s;
+}
+
+/* switch from list to tree mode by building a balanced tree over the list */
+static void actlist_build_tree(actlist_t*a)
+{
+    segment_t**segs = (segment_t**)malloc(sizeof(segment_t*)*a->size);
+    segment_t*s;
+    int num = 0;
+    for(s=a->list;s;s=s->right) {
+	segs[num++] = s;
+    }
+    assert(num == a->size);
+    a->root = build_tree(segs, num, 0);
+    free(segs);
+    assert(actlist_splay_verify(a));
+}
+
+static void actlist_drop_tree(actlist_t*a)
+{
+    segment_t*s;
+    for(s=a->list;s;s=s->right) {
+	s->parent = s->leftchild = s->rightchild = 0;
+    }
+    a->root = 0;
+}
+
+/* fill an empty active list with the given (sorted) segments */
+void actlist_set(actlist_t*a, segment_t**segs, int num)
+{
+    assert(!a->list && !a->root);
+    int t;
+    for(t=0;t<num;t++) {
+	segs[t]->left = t ? segs[t-1] : 0;
+	segs[t]->right = t<num-1 ? segs[t+1] : 0;
+    }
+    a->list = num ? segs[0] : 0;
+    a->size = num;
+    if(num >= ACTLIST_TREE_THRESHOLD) {
+	a->root = build_tree(segs, num, 0);
+    }
+    assert(actlist_splay_verify(a));
+}
+
+/* forget about all segments (without touching them) */
+void actlist_clear(actlist_t*a)
+{
+    a->list = 0;
+    a->root = 0;
+    a->size = 0;
+}
 
 static void actlist_insert_after(actlist_t*a, segment_t*left, segment_t*s)
 {
-#ifdef SPLAY
     //fprintf(stderr, "insert [%d] after [%d]\n", SEGNR(s), SEGNR(left));
     //actlist_splay_dump(a);
     //actlist_dump(a, s->a.y);
-#endif
 
     s->left = left;
     if(left) {
@@ -455,7 +520,6 @@ static void actlist_insert_after(actlist_t*a, segment_t*left, segment_t*s)
     if(s->right) 
         s->right->left = s;
 
-#ifdef SPLAY
     // we insert nodes not trees 
     assert(!s->leftchild);
     assert(!s->rightchild);
@@ -470,23 +534,24 @@ static void actlist_insert_after(actlist_t*a, segment_t*left, segment_t*s)
 	} else {
 	    LINK(s,rightchild,a->root);
 	}
+	a->root = s;
+	a->root->parent = 0;
     }
-    a->root = s;
-    a->root->parent = 0;
-  
-    assert(actlist_splay_verify(a));
-#endif
-
     a->size++;
+
+    if(!a->root && a->size >= ACTLIST_TREE_THRESHOLD) {
+	actlist_build_tree(a);
+    }
+    assert(actlist_splay_verify(a));
 }
 
 void actlist_delete(actlist_t*a, segment_t*s)
 {
-#ifdef SPLAY
-    assert(actlist_splay_verify(a));
-    move_to_root(a, s);
     assert(actlist_splay_verify(a));
-#endif
+    if(a->root) {
+	move_to_root(a, s);
+	assert(actlist_splay_verify(a));
+    }
     if(s->left) {
         s->left->right = s->right;
     } else {
@@ -497,7 +562,9 @@ void actlist_delete(actlist_t*a, segment_t*s)
     }
     s->left = s->right = 0;
     a->size--;
-#ifdef SPLAY
+    if(!a->root) {
+	return;
+    }
     assert(a->root == s);
     // delete root node
     if(!a->root->leftchild) {
@@ -542,9 +609,11 @@ void actlist_delete(actlist_t*a, segment_t*s)
     if(a->root) 
 	a->root->parent = 0;
     s->leftchild = s->rightchild = s->parent = 0;
-    
+
+    if(a->root && a->size < ACTLIST_TREE_THRESHOLD/2) {
+	actlist_drop_tree(a);
+    }
     assert(actlist_splay_verify(a));
-#endif
 }
 int actlist_size(actlist_t*a)
 {
@@ -579,9 +648,7 @@ void actlist_insert(actlist_t*a, point_t p1, point_t p2, segment_t*s)
 
 void actlist_swap(actlist_t*a, segment_t*s1, segment_t*s2)
 {
-#ifdef SPLAY
     assert(actlist_splay_verify(a));
-#endif
 #ifdef CHECKS
     /* test that s1 is to the left of s2- our swap
        code depends on that */
@@ -589,10 +656,6 @@ void actlist_swap(actlist_t*a, segment_t*s1, segment_t*s2)
     while(s && s!=s2) s = s->right;
     assert(s==s2);
 #endif
-/*#ifndef SPLAY
-    actlist_delete(a, s1);
-    actlist_insert_after(a, s2, s1);
-#else*/
     segment_t*s1l = s1->left;
     segment_t*s1r = s1->right;
     segment_t*s2l = s2->left;
@@ -607,7 +670,9 @@ void actlist_swap(actlist_t*a, segment_t*s1, segment_t*s2)
     if(s1r!=s2) s2->right = s1r; 
     else        s2->right = s1;
    
-#ifdef SPLAY
+    if(!a->root) {
+	return;
+    }
     if(s2->parent==s1) {
 	/* 
 	     s1            s2
@@ -687,7 +752,4 @@ void actlist_swap(actlist_t*a, segment_t*s1, segment_t*s2)
     if(s2->rightchild) s2->rightchild->parent = s2;
 
     assert(actlist_splay_verify(a));
-#endif
-
-//#endif
 }
@@ -3,13 +3,18 @@
 
 #include "poly.h"
 
+/* The active list is a linked list, with a splay tree on top of it once it
+   holds at least ACTLIST_TREE_THRESHOLD segments. For fewer segments, walking
+   the list is cheaper than maintaining the tree. */
+#ifndef ACTLIST_TREE_THRESHOLD
+#define ACTLIST_TREE_THRESHOLD 32
+#endif
+
 typedef struct _actlist
 {
     segment_t*list;
     int size;
-#ifdef SPLAY
-    segment_t*root;
-#endif
+    segment_t*root; // 0 as long as we're in list mode
 } actlist_t;
 
 #define actlist_left(a,s) ((s)->left)
@@ -23,6 +28,8 @@ void actlist_dump(actlist_t*a, int32_t y, double gridsize);
 segment_t* actlist_find(actlist_t*a, point_t p1, point_t p2);  // finds segment immediately to the left of p1 (breaking ties w/ p2)
 void actlist_insert(actlist_t*a, point_t p1, point_t p2, segment_t*s);
 void actlist_delete(actlist_t*a, segment_t*s);
+void actlist_set(actlist_t*a, segment_t**segs, int num);
+void actlist_clear(actlist_t*a);
 void actlist_swap(actlist_t*a, segment_t*s1, segment_t*s2);
 segment_t* actlist_leftmost(actlist_t*a);
 segment_t* actlist_rightmost(actlist_t*a);
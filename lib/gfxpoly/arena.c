@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include <memory.h>
+#include "../mem.h"
+#include "arena.h"
+
+#define ARENA_BLOCK_SIZE 65536
+#define ARENA_MAX_SPARE 16
+
+#define ALIGN(x) (((x)+7)&~7)
+#define BLOCK_HEADER ALIGN(sizeof(arenablock_t))
+
+arena_t* arena_new()
+{
+    arena_t*a = (arena_t*)rfx_calloc(sizeof(arena_t));
+    return a;
+}
+
+static arenablock_t* arena_newblock(arena_t*a, int size)
+{
+    arenablock_t*b = 0;
+    if(size <= ARENA_BLOCK_SIZE && a->spare) {
+	b = a->spare;
+	a->spare = b->next;
+	a->num_spare--;
+    } else {
+	if(size < ARENA_BLOCK_SIZE)
+	    size = ARENA_BLOCK_SIZE;
+	b = (arenablock_t*)rfx_alloc(BLOCK_HEADER + size);
+	b->size = size;
+    }
+    b->next = a->used;
+    a->used = b;
+    a->pos = 0;
+    return b;
+}
+
+void* arena_alloc(arena_t*a, int size)
+{
+    size = ALIGN(size);
+    arenablock_t*b = a->used;
+    if(!b || a->pos + size > b->size) {
+	b = arena_newblock(a, size);
+    }
+    void*data = (char*)b + BLOCK_HEADER + a->pos;
+    a->pos += size;
+    return data;
+}
+
+void arena_reset(arena_t*a)
+{
+    arenablock_t*b = a->used;
+    while(b) {
+	arenablock_t*next = b->next;
+	if(b->size == ARENA_BLOCK_SIZE && a->num_spare < ARENA_MAX_SPARE) {
+	    b->next = a->spare;
+	    a->spare = b;
+	    a->num_spare++;
+	} else {
+	    rfx_free(b);
+	}
+	b = next;
+    }
+    a->used = 0;
+    a->pos = 0;
+}
+
+void arena_destroy(arena_t*a)
+{
+    arena_reset(a);
+    arenablock_t*b = a->spare;
+    while(b) {
+	arenablock_t*next = b->next;
+	rfx_free(b);
+	b = next;
+    }
+    rfx_free(a);
+}
@@ -0,0 +1,24 @@
+#ifndef __arena_h__
+#define __arena_h__
+
+/* An arena hands out memory from big blocks, and releases all of it at once.
+   arena_reset() keeps (some of) the blocks around for the next user. */
+
+typedef struct _arenablock {
+    struct _arenablock*next;
+    int size;
+} arenablock_t;
+
+typedef struct _arena {
+    arenablock_t*used;
+    arenablock_t*spare;
+    int pos;
+    int num_spare;
+} arena_t;
+
+arena_t* arena_new();
+void* arena_alloc(arena_t*a, int size);
+void arena_reset(arena_t*a);
+void arena_destroy(arena_t*a);
+
+#endif
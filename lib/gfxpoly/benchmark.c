@@ -0,0 +1,504 @@
+/* Benchmark for the polygon library. Runs gfxpoly_from_fill, gfxpoly_from_stroke,
+   gfxpoly_process and gfxline_from_gfxpoly over a fixed set of inputs (random
+   polygons of increasing size, dense strokes, font outlines, and polygons saved
+   with gfxpoly_save, e.g. clip paths dumped by the polyops device) and writes
+   one JSON object per measurement to stdout.
+   With -c, results are compared against a previous run, and the program exits
+   with a nonzero status if anything got slower than the given threshold. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory.h>
+#include <math.h>
+#include <sys/time.h>
+#include "../gfxtools.h"
+#include "../gfxfont.h"
+#include "../os.h"
+#include "poly.h"
+#include "convert.h"
+#include "stroke.h"
+
+#ifdef CHECKS
+#error "benchmark must be compiled without CHECKS"
+#endif
+
+/* allocation statistics. These are only collected if the program is linked
+   with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free (see the
+   Makefile), otherwise allocs and peak_bytes are always reported as zero */
+
+static long long num_allocs = 0;
+static long long live_bytes = 0;
+static long long peak_bytes = 0;
+
+#if defined(TRACK_MALLOC) && defined(__GLIBC__)
+#include <malloc.h>
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void*ptr, size_t size);
+void __real_free(void*ptr);
+
+static void track(void*ptr, long long old)
+{
+    num_allocs++;
+    live_bytes += malloc_usable_size(ptr) - old;
+    if(live_bytes > peak_bytes)
+	peak_bytes = live_bytes;
+}
+void* __wrap_malloc(size_t size)
+{
+    void*ptr = __real_malloc(size);
+    if(ptr) track(ptr, 0);
+    return ptr;
+}
+void* __wrap_calloc(size_t n, size_t size)
+{
+    void*ptr = __real_calloc(n, size);
+    if(ptr) track(ptr, 0);
+    return ptr;
+}
+void* __wrap_realloc(void*ptr, size_t size)
+{
+    long long old = ptr?malloc_usable_size(ptr):0;
+    void*ptr2 = __real_realloc(ptr, size);
+    if(ptr2) track(ptr2, old);
+    else if(!size) live_bytes -= old;
+    return ptr2;
+}
+void __wrap_free(void*ptr)
+{
+    if(ptr)
+	live_bytes -= malloc_usable_size(ptr);
+    __real_free(ptr);
+}
+#endif
+
+static windcontext_t onepolygon = {1};
+
+static double gridsize = 0.05;
+static int max_repeats = 5;
+static int min_ms = 200;
+static char*fontfile = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+
+static double milliseconds()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec*1000.0 + tv.tv_usec/1000.0;
+}
+
+/* -------------------------------- inputs -------------------------------- */
+
+typedef struct _input {
+    char name[64];
+    int size;
+
+    /* exactly one of these is set. Polygons loaded from files
+       are processed one after the other, like a sequence of clips */
+    gfxline_t*fill;
+    gfxline_t*stroke;
+    gfxpoly_t**polys;
+    int num_polys;
+
+    double width;
+    struct _input*next;
+} input_t;
+
+static input_t*inputs = 0;
+static input_t*last_input = 0;
+
+static input_t* add_input(const char*name, int size)
+{
+    input_t*i = rfx_calloc(sizeof(input_t));
+    snprintf(i->name, sizeof(i->name), "%s", name);
+    i->size = size;
+    if(last_input)
+	last_input->next = i;
+    else
+	inputs = i;
+    last_input = i;
+    return i;
+}
+
+static unsigned int seed = 0x2345;
+static double rnd()
+{
+    seed = seed*1103515245+12345;
+    return ((seed>>8)&0xffff) / 65536.0;
+}
+
+static gfxline_t* mkpolygon(int num, char walk)
+{
+    gfxline_t*l = rfx_calloc(sizeof(gfxline_t)*(num+1));
+    /* keep the density constant, so that the number of intersections
+       grows (roughly) linearly with the number of points */
+    double size = sqrt(num)*20;
+    double x = size/2, y = size/2;
+    int t;
+    for(t=0;t<num;t++) {
+	if(walk) {
+	    x += (rnd()-0.5)*40;
+	    y += (rnd()-0.5)*40;
+	} else {
+	    x = rnd()*size;
+	    y = rnd()*size;
+	}
+	l[t].type = t?gfx_lineTo:gfx_moveTo;
+	l[t].x = x;
+	l[t].y = y;
+	l[t].next = &l[t+1];
+    }
+    l[num].type = gfx_lineTo;
+    l[num].x = l[0].x;
+    l[num].y = l[0].y;
+    return l;
+}
+
+static int count_segments(gfxline_t*l)
+{
+    int num = 0;
+    for(;l;l=l->next)
+	num += l->type != gfx_moveTo;
+    return num;
+}
+
+static gfxline_t* mkcircles(int num)
+{
+    gfxline_t*l = 0;
+    double size = sqrt(num)*40;
+    int t;
+    for(t=0;t<num;t++) {
+	double r = 5+rnd()*30;
+	l = gfxline_append(l, gfxline_makecircle(rnd()*size, rnd()*size, r, r));
+    }
+    return l;
+}
+
+static gfxline_t* mkpolylines(int num, int len)
+{
+    gfxline_t*l = rfx_calloc(sizeof(gfxline_t)*num*len);
+    double size = sqrt(num)*50;
+    int t, s;
+    for(t=0;t<num;t++) {
+	double x = rnd()*size, y = rnd()*size;
+	for(s=0;s<len;s++) {
+	    gfxline_t*p = &l[t*len+s];
+	    p->type = s?gfx_lineTo:gfx_moveTo;
+	    p->x = x;
+	    p->y = y;
+	    if(t*len+s+1 < num*len)
+		p->next = p+1;
+	    x += (rnd()-0.5)*20;
+	    y += (rnd()-0.5)*20;
+	}
+    }
+    return l;
+}
+
+static void add_random_inputs()
+{
+    int n;
+    char name[64];
+    /* fully random polygons have O(n^2) intersections, so stay small here */
+    for(n=50;n<=800;n*=4) {
+	sprintf(name, "random-%d", n);
+	add_input(name, n)->fill = mkpolygon(n, 0);
+    }
+    for(n=1000;n<=10000;n*=10) {
+	sprintf(name, "randomwalk-%d", n);
+	add_input(name, n)->fill = mkpolygon(n, 1);
+    }
+    for(n=100;n<=10000;n*=10) {
+	sprintf(name, "circles-%d", n);
+	gfxline_t*l = mkcircles(n);
+	add_input(name, count_segments(l))->fill = l;
+    }
+    for(n=100;n<=10000;n*=10) {
+	sprintf(name, "strokes-%d", n);
+	input_t*i = add_input(name, n*20);
+	i->stroke = mkpolylines(n, 20);
+	i->width = 2.0;
+    }
+}
+
+static void add_font_inputs(const char*filename)
+{
+    gfxfont_t*font = gfxfont_load("benchmark", filename, 0, 1.0);
+    if(!font) {
+	fprintf(stderr, "Couldn't load font %s- skipping font tests\n", filename);
+	return;
+    }
+    /* all glyphs, laid out as a page of text */
+    gfxline_t*page = 0;
+    int t, num = 0;
+    for(t=0;t<font->num_glyphs;t++) {
+	gfxline_t*l = gfxline_clone(font->glyphs[t].line);
+	if(!l)
+	    continue;
+	gfxmatrix_t m;
+	memset(&m, 0, sizeof(m));
+	m.m00 = m.m11 = 0.012;
+	m.tx = (num%80)*13;
+	m.ty = (num/80)*16;
+	gfxline_transform(l, &m);
+	page = gfxline_append(page, l);
+	num++;
+    }
+    add_input("font-page", count_segments(page))->fill = page;
+    gfxfont_free(font);
+}
+
+static void add_file_inputs(char**files, int num)
+{
+    input_t*i = 0;
+    int t;
+    for(t=0;t<num;t++) {
+	gfxpoly_t*poly = gfxpoly_from_file(files[t], gridsize);
+	if(!poly)
+	    continue;
+	if(!i) {
+	    const char*name = strrchr(files[t], '/');
+	    name = name?name+1:files[t];
+	    i = add_input(num>1?"files":name, 0);
+	    i->polys = (gfxpoly_t**)rfx_calloc(sizeof(gfxpoly_t*)*num);
+	}
+	i->polys[i->num_polys++] = poly;
+	i->size += gfxpoly_size(poly);
+    }
+}
+
+/* ------------------------------ measurement ----------------------------- */
+
+typedef struct _result {
+    double ms;
+    long long events;
+    long long allocs;
+    long long peak_bytes;
+} result_t;
+
+typedef enum {OP_FROM_FILL, OP_FROM_STROKE, OP_PROCESS, OP_TO_GFXLINE} op_t;
+static const char*op_names[] = {"from_fill", "from_stroke", "process", "to_gfxline"};
+
+static void* run_op(op_t op, input_t*i, gfxpoly_t*poly)
+{
+    switch(op) {
+	case OP_FROM_FILL:
+	    return gfxpoly_from_fill(i->fill, gridsize);
+	case OP_FROM_STROKE:
+	    return gfxpoly_from_stroke(i->stroke, i->width, gfx_capRound, gfx_joinRound, 1.0, gridsize);
+	case OP_PROCESS:
+	    return gfxpoly_process(poly, 0, &windrule_evenodd, &onepolygon, 0);
+	case OP_TO_GFXLINE:
+	    return gfxline_from_gfxpoly(poly);
+    }
+    return 0;
+}
+
+static void free_result(op_t op, void*data)
+{
+    if(op == OP_TO_GFXLINE)
+	gfxline_free((gfxline_t*)data);
+    else
+	gfxpoly_destroy((gfxpoly_t*)data);
+}
+
+/* run an operation (on all the given polygons) until it took at least min_ms
+   in total (but at most max_repeats times), and report the fastest run */
+static result_t measure(op_t op, input_t*i, gfxpoly_t**polys, int num)
+{
+    void**data = (void**)rfx_calloc(sizeof(void*)*num);
+    result_t r;
+    memset(&r, 0, sizeof(r));
+    r.ms = -1;
+    double total = 0;
+    int t;
+    for(t=0;t<max_repeats && (t<1 || total<min_ms);t++) {
+	long long allocs = num_allocs;
+	long long live = live_bytes;
+	peak_bytes = live_bytes;
+	uint64_t events = gfxpoly_events_processed();
+
+	double t1 = milliseconds();
+	int j;
+	for(j=0;j<num;j++)
+	    data[j] = run_op(op, i, polys?polys[j]:0);
+	double t2 = milliseconds();
+
+	r.events = gfxpoly_events_processed() - events;
+	r.allocs = num_allocs - allocs;
+	r.peak_bytes = peak_bytes - live;
+	for(j=0;j<num;j++)
+	    free_result(op, data[j]);
+
+	if(r.ms<0 || t2-t1 < r.ms)
+	    r.ms = t2-t1;
+	total += t2-t1;
+    }
+    rfx_free(data);
+    return r;
+}
+
+typedef struct _baseline {
+    char input[64];
+    char op[32];
+    double ms;
+    struct _baseline*next;
+} baseline_t;
+
+static baseline_t*baseline = 0;
+static double threshold = 10.0;
+static int num_regressions = 0;
+
+static void read_baseline(const char*filename)
+{
+    FILE*fi = fopen(filename, "rb");
+    if(!fi) {
+	perror(filename);
+	exit(1);
+    }
+    char line[512];
+    while(fgets(line, sizeof(line), fi)) {
+	baseline_t b;
+	memset(&b, 0, sizeof(b));
+	if(sscanf(line, "{\"input\": \"%63[^\"]\", \"op\": \"%31[^\"]\", \"size\": %*d, \"ms\": %lf", b.input, b.op, &b.ms) != 3)
+	    continue;
+	baseline_t*n = malloc(sizeof(baseline_t));
+	*n = b;
+	n->next = baseline;
+	baseline = n;
+    }
+    fclose(fi);
+}
+
+static void compare(input_t*i, op_t op, result_t*r)
+{
+    baseline_t*b;
+    for(b=baseline;b;b=b->next) {
+	if(strcmp(b->input, i->name) || strcmp(b->op, op_names[op]))
+	    continue;
+	/* don't bother with timings below the timer resolution */
+	if(b->ms < 0.5 && r->ms < 0.5)
+	    return;
+	double change = (r->ms - b->ms) * 100.0 / b->ms;
+	if(change > threshold) {
+	    fprintf(stderr, "REGRESSION: %s %s: %.3fms -> %.3fms (%+.1f%%)\n", i->name, op_names[op], b->ms, r->ms, change);
+	    num_regressions++;
+	} else if(change < -threshold) {
+	    fprintf(stderr, "improvement: %s %s: %.3fms -> %.3fms (%+.1f%%)\n", i->name, op_names[op], b->ms, r->ms, change);
+	}
+	return;
+    }
+}
+
+static void report(input_t*i, op_t op, result_t*r)
+{
+    /* events/sec for the sweep, input segments/sec for everything else */
+    double count = op==OP_PROCESS ? r->events : i->size;
+    double rate = r->ms>0 ? count*1000.0/r->ms : 0;
+    printf("{\"input\": \"%s\", \"op\": \"%s\", \"size\": %d, \"ms\": %.3f, \"events\": %lld, \"rate\": %.0f, \"allocs\": %lld, \"peak_bytes\": %lld}\n",
+	    i->name, op_names[op], i->size, r->ms, r->events, rate, r->allocs, r->peak_bytes);
+    fflush(stdout);
+    if(baseline)
+	compare(i, op, r);
+}
+
+static void benchmark(input_t*i)
+{
+    result_t r;
+    gfxpoly_t**polys = i->polys;
+    int num = i->num_polys, t;
+    if(i->fill || i->stroke) {
+	op_t op = i->fill?OP_FROM_FILL:OP_FROM_STROKE;
+	r = measure(op, i, 0, 1);
+	report(i, op, &r);
+	num = 1;
+	polys = (gfxpoly_t**)rfx_calloc(sizeof(gfxpoly_t*));
+	polys[0] = (gfxpoly_t*)run_op(op, i, 0);
+    }
+
+    r = measure(OP_PROCESS, i, polys, num);
+    report(i, OP_PROCESS, &r);
+
+    gfxpoly_t**processed = (gfxpoly_t**)rfx_calloc(sizeof(gfxpoly_t*)*num);
+    for(t=0;t<num;t++)
+	processed[t] = gfxpoly_process(polys[t], 0, &windrule_evenodd, &onepolygon, 0);
+    r = measure(OP_TO_GFXLINE, i, processed, num);
+    report(i, OP_TO_GFXLINE, &r);
+    for(t=0;t<num;t++)
+	gfxpoly_destroy(processed[t]);
+    rfx_free(processed);
+
+    if(polys != i->polys) {
+	gfxpoly_destroy(polys[0]);
+	rfx_free(polys);
+    }
+}
+
+static void usage(const char*name)
+{
+    printf("Usage: %s [options] [polygon files...]\n", name);
+    printf("-f <file.ttf>   font to use for the font outline test (default: %s)\n", fontfile);
+    printf("-c <file>       compare against the results of a previous run\n");
+    printf("-t <percent>    slowdown which counts as a regression (default: %.0f)\n", threshold);
+    printf("-r <num>        maximum number of repetitions per measurement (default: %d)\n", max_repeats);
+    printf("-j <num>        number of threads for gfxpoly_process (default: 1)\n");
+    printf("-q              only use the given polygon files\n");
+    printf("polygon files are written by gfxpoly_save, e.g. by the polyops device with -s dumpclips=<prefix>.\n");
+    printf("They are processed one after the other, and reported together as a single input.\n");
+}
+
+int main(int argn, char*argv[])
+{
+    char builtin = 1;
+    int t;
+    gfxpoly_set_num_threads(1);
+    for(t=1;t<argn;t++) {
+	char*a = argv[t];
+	if(a[0] != '-' || !a[1]) {
+	    continue;
+	} else if(!strcmp(a, "-q")) {
+	    builtin = 0;
+	} else if(strchr("fctrj", a[1]) && !a[2] && t+1<argn) {
+	    char*v = argv[++t];
+	    switch(a[1]) {
+		case 'f': fontfile = v; break;
+		case 'c': read_baseline(v); break;
+		case 't': threshold = atof(v); break;
+		case 'r': max_repeats = atoi(v); break;
+		case 'j': gfxpoly_set_num_threads(atoi(v)); break;
+	    }
+	    argv[t-1] = argv[t] = 0;
+	} else {
+	    usage(argv[0]);
+	    exit(strcmp(a, "-h")?1:0);
+	}
+    }
+    if(max_repeats < 1)
+	max_repeats = 1;
+
+    if(builtin) {
+	add_random_inputs();
+	add_font_inputs(fontfile);
+    }
+    char**files = (char**)rfx_calloc(sizeof(char*)*argn);
+    int num_files = 0;
+    for(t=1;t<argn;t++) {
+	if(argv[t] && strcmp(argv[t], "-q"))
+	    files[num_files++] = argv[t];
+    }
+    add_file_inputs(files, num_files);
+
+    input_t*i;
+    for(i=inputs;i;i=i->next) {
+	benchmark(i);
+    }
+
+    if(baseline) {
+	if(num_regressions) {
+	    fprintf(stderr, "%d regression(s) (threshold %.0f%%)\n", num_regressions, threshold);
+	    return 1;
+	}
+	fprintf(stderr, "no regressions (threshold %.0f%%)\n", threshold);
+    }
+    return 0;
+}
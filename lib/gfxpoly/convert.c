@@ -54,6 +54,41 @@ static void convert_gfxline(gfxline_t*line, polywriter_t*w, double gridsize)
     }
 }
 
+/* same as convert_gfxline, for packed paths */
+static void convert_gfxpath(gfxpath_t*path, polywriter_t*w, double gridsize)
+{
+    assert(!path->num || path->types[0] == gfx_moveTo);
+    double lastx=0,lasty=0;
+    double z = 1.0 / gridsize;
+    gfxpoint_t*p = path->points;
+    int n;
+    for(n=0;n<path->num;n++) {
+        if(path->types[n] == gfx_moveTo) {
+	    if(n+1 < path->num && path->types[n+1] != gfx_moveTo && (p[n].x!=lastx || p[n].y!=lasty)) {
+		w->moveto(w, convert_coord(p[n].x,z), convert_coord(p[n].y,z));
+	    }
+        } else if(path->types[n] == gfx_lineTo) {
+            w->lineto(w, convert_coord(p[n].x,z), convert_coord(p[n].y,z));
+	} else if(path->types[n] == gfx_splineTo) {
+	    gfxpoint_t*c = &path->controls[n];
+            int parts = (int)(sqrt(fabs(p[n].x-2*c->x+lastx) + 
+                                   fabs(p[n].y-2*c->y+lasty))*SUBFRACTION);
+            if(!parts) parts = 1;
+	    double stepsize = 1.0/parts;
+            int i;
+	    for(i=0;i<parts;i++) {
+		double t = (double)i*stepsize;
+		double sx = (p[n].x*t*t + 2*c->x*t*(1-t) + lastx*(1-t)*(1-t));
+		double sy = (p[n].y*t*t + 2*c->y*t*(1-t) + lasty*(1-t)*(1-t));
+		w->lineto(w, convert_coord(sx,z), convert_coord(sy,z));
+	    }
+	    w->lineto(w, convert_coord(p[n].x,z), convert_coord(p[n].y,z));
+        }
+	lastx = p[n].x;
+	lasty = p[n].y;
+    }
+}
+
 static char* readline(FILE*fi)
 {
     char c;
@@ -81,6 +116,7 @@ static void convert_file(const char*filename, polywriter_t*w, double gridsize)
     FILE*fi = fopen(filename, "rb");
     if(!fi) {
         perror(filename);
+        return;
     }
     double z = 1.0 / gridsize;
     int count = 0;
@@ -103,8 +139,9 @@ static void convert_file(const char*filename, polywriter_t*w, double gridsize)
                 fprintf(stderr, "invalid command: %s\n", s);
             }
         } else if(sscanf(line, "%% gridsize %lf", &g) == 1) {
+	    /* files written by gfxpoly_save() store grid coordinates */
 	    gridsize = g;
-	    z = 1.0 / gridsize;
+	    z = 1.0;
 	    w->setgridsize(w, g);
         }
         free(line);
@@ -131,8 +168,9 @@ void finish_segment(compactpoly_t*data)
 {
     if(data->num_points <= 1)
 	return;
-    point_t*p = malloc(sizeof(point_t)*data->num_points);
-    gfxpolystroke_t*s = rfx_calloc(sizeof(gfxpolystroke_t));
+    /* allocate the stroke and its points in one go */
+    gfxpolystroke_t*s = rfx_calloc(sizeof(gfxpolystroke_t) + sizeof(point_t)*data->num_points);
+    point_t*p = (point_t*)(s+1);
     s->fs = &edgestyle_default;
     s->next = data->poly->strokes;
     data->poly->strokes = s;
@@ -250,6 +288,14 @@ gfxpoly_t* gfxpoly_from_fill(gfxline_t*line, double gridsize)
     convert_gfxline(line, &writer, gridsize);
     return (gfxpoly_t*)writer.finish(&writer);
 }
+gfxpoly_t* gfxpoly_from_path(gfxpath_t*path, double gridsize)
+{
+    polywriter_t writer;
+    gfxpolywriter_init(&writer);
+    writer.setgridsize(&writer, gridsize);
+    convert_gfxpath(path, &writer, gridsize);
+    return (gfxpoly_t*)writer.finish(&writer);
+}
 gfxpoly_t* gfxpoly_from_file(const char*filename, double gridsize)
 {
     polywriter_t writer;
@@ -264,7 +310,8 @@ void gfxpoly_destroy(gfxpoly_t*poly)
     gfxpolystroke_t*stroke = poly->strokes;
     while(stroke) {
 	gfxpolystroke_t*next = stroke->next;
-	free(stroke->points);
+	if(stroke->points != (point_t*)(stroke+1))
+	    free(stroke->points);
 	free(stroke);
 	stroke = next;
     }
@@ -417,12 +464,12 @@ gfxline_t*gfxline_from_gfxpoly(gfxpoly_t*poly)
 }
 #endif
 
-static gfxline_t*mkgfxline(gfxpoly_t*poly, char preserve_direction)
+/* walk the strokes of a polygon, joining them into as few paths as possible */
+static void draw_strokes(gfxpoly_t*poly, char preserve_direction, gfxdrawer_t*draw)
 {
     gfxpolystroke_t*stroke;
-    int count = 0;
     if(!poly->strokes)
-	return 0;
+	return;
     dict_t*d = dict_new2(&point_type);
     dict_t*todo = dict_new2(&ptr_type);
     gfxpolystroke_t*stroke_min= poly->strokes;
@@ -431,7 +478,6 @@ static gfxline_t*mkgfxline(gfxpoly_t*poly, char preserve_direction)
     for(stroke=poly->strokes;stroke;stroke=stroke->next) {
 	dict_put(todo, stroke, stroke);
 	assert(stroke->num_points>1);
-	count += stroke->num_points;
 	if(stroke->dir == DIR_UP) {
 	    dict_put(d, &stroke->points[stroke->num_points-1], stroke);
 	    if(!preserve_direction)
@@ -448,8 +494,6 @@ static gfxline_t*mkgfxline(gfxpoly_t*poly, char preserve_direction)
 	}
     }
     gfxpolystroke_t*next_todo = poly->strokes;
-    gfxline_t*l = malloc(sizeof(gfxline_t)*count);
-    count = 0;
     stroke = stroke_min;
     
     point_t last = {INVALID_COORD, INVALID_COORD};
@@ -479,20 +523,12 @@ static gfxline_t*mkgfxline(gfxpoly_t*poly, char preserve_direction)
 	    }
 	}
 	if(last.x != stroke->points[pos].x || last.y != stroke->points[pos].y) {
-	    l[count].x = stroke->points[pos].x * poly->gridsize;
-	    l[count].y = stroke->points[pos].y * poly->gridsize;
-	    l[count].type = gfx_moveTo;
-	    l[count].next = &l[count+1];
-	    count++;
+	    draw->moveTo(draw, stroke->points[pos].x * poly->gridsize, stroke->points[pos].y * poly->gridsize);
 	    assert(!should_connect);
 	}
 	pos += incr;
 	for(t=1;t<stroke->num_points;t++) {
-	    l[count].x = stroke->points[pos].x * poly->gridsize;
-	    l[count].y = stroke->points[pos].y * poly->gridsize;
-	    l[count].type = gfx_lineTo;
-	    l[count].next = &l[count+1];
-	    count++;
+	    draw->lineTo(draw, stroke->points[pos].x * poly->gridsize, stroke->points[pos].y * poly->gridsize);
 	    pos += incr;
 	}
 	last = stroke->points[pos-incr];
@@ -513,10 +549,61 @@ static gfxline_t*mkgfxline(gfxpoly_t*poly, char preserve_direction)
 	    next_todo = next_todo->next;
 	}
     }
-    l[count-1].next = 0;
     dict_destroy(todo);
     dict_destroy(d);
-    return l;
+}
+
+void gfxpoly_draw(gfxpoly_t*poly, gfxdrawer_t*draw)
+{
+    draw_strokes(poly, 0, draw);
+}
+
+/* a drawer which writes into a preallocated gfxline array */
+typedef struct _arraydraw_internal {
+    gfxline_t*l;
+    int count;
+} arraydraw_internal_t;
+
+static void arraydraw_add(gfxdrawer_t*d, gfx_linetype type, gfxcoord_t x, gfxcoord_t y)
+{
+    arraydraw_internal_t*i = (arraydraw_internal_t*)d->internal;
+    gfxline_t*l = &i->l[i->count++];
+    l->x = x;
+    l->y = y;
+    l->type = type;
+    l->next = l+1;
+}
+static void arraydraw_moveTo(gfxdrawer_t*d, gfxcoord_t x, gfxcoord_t y)
+{
+    arraydraw_add(d, gfx_moveTo, x, y);
+}
+static void arraydraw_lineTo(gfxdrawer_t*d, gfxcoord_t x, gfxcoord_t y)
+{
+    arraydraw_add(d, gfx_lineTo, x, y);
+}
+
+static gfxline_t*mkgfxline(gfxpoly_t*poly, char preserve_direction)
+{
+    gfxpolystroke_t*stroke;
+    int count = 0;
+    for(stroke=poly->strokes;stroke;stroke=stroke->next) {
+	count += stroke->num_points;
+    }
+    if(!count)
+	return 0;
+
+    arraydraw_internal_t i;
+    i.l = malloc(sizeof(gfxline_t)*count);
+    i.count = 0;
+    gfxdrawer_t d;
+    memset(&d, 0, sizeof(d));
+    d.internal = &i;
+    d.moveTo = arraydraw_moveTo;
+    d.lineTo = arraydraw_lineTo;
+    draw_strokes(poly, preserve_direction, &d);
+
+    i.l[i.count-1].next = 0;
+    return i.l;
 }
 
 gfxline_t*gfxline_from_gfxpoly(gfxpoly_t*poly)
@@ -548,3 +635,268 @@ gfxpoly_t* gfxpoly_createbox(double x1, double y1,double x2, double y2, double g
     return poly;
 }
 
+gfxbbox_t gfxpoly_getbbox(gfxpoly_t*poly)
+{
+    gfxbbox_t bbox = {0,0,0,0};
+    gfxpolystroke_t*stroke = poly->strokes;
+    if(!stroke)
+	return bbox;
+    int32_t xmin = stroke->points[0].x, xmax = xmin;
+    int32_t ymin = stroke->points[0].y, ymax = ymin;
+    for(;stroke;stroke=stroke->next) {
+	int t;
+	/* points are sorted by y */
+	if(stroke->points[0].y < ymin)
+	    ymin = stroke->points[0].y;
+	if(stroke->points[stroke->num_points-1].y > ymax)
+	    ymax = stroke->points[stroke->num_points-1].y;
+	for(t=0;t<stroke->num_points;t++) {
+	    int32_t x = stroke->points[t].x;
+	    if(x < xmin) xmin = x;
+	    if(x > xmax) xmax = x;
+	}
+    }
+    bbox.xmin = xmin * poly->gridsize;
+    bbox.ymin = ymin * poly->gridsize;
+    bbox.xmax = xmax * poly->gridsize;
+    bbox.ymax = ymax * poly->gridsize;
+    return bbox;
+}
+
+typedef struct _borderpiece {
+    int32_t v1,v2;
+    int dir; // +1 or -1
+} borderpiece_t;
+
+typedef struct _border {
+    char horizontal;
+    int32_t pos;
+    borderpiece_t*pieces;
+    int num;
+    int size;
+} border_t;
+
+typedef struct _clipwriter {
+    gfxpoly_t*poly;
+    gfxpolystroke_t*stroke; // the stroke we're cutting
+    point_t*points;
+    int num_points;
+    int32_t x1,y1,x2,y2;
+    border_t border[4];
+} clipwriter_t;
+
+static void clip_flush(clipwriter_t*w)
+{
+    if(w->num_points > 1) {
+	gfxpolystroke_t*s = rfx_calloc(sizeof(gfxpolystroke_t) + sizeof(point_t)*w->num_points);
+	s->fs = w->stroke->fs;
+	s->dir = w->stroke->dir;
+	s->num_points = s->points_size = w->num_points;
+	s->points = (point_t*)(s+1);
+	memcpy(s->points, w->points, sizeof(point_t)*w->num_points);
+	s->next = w->poly->strokes;
+	w->poly->strokes = s;
+    }
+    w->num_points = 0;
+}
+static void border_add(border_t*b, int32_t v1, int32_t v2, int dir)
+{
+    if(b->num == b->size) {
+	b->size = b->size ? b->size*2 : 16;
+	b->pieces = rfx_realloc(b->pieces, sizeof(borderpiece_t)*b->size);
+    }
+    if(v1 > v2) {
+	int32_t v = v1;v1 = v2;v2 = v;
+	dir = -dir;
+    }
+    b->pieces[b->num].v1 = v1;
+    b->pieces[b->num].v2 = v2;
+    b->pieces[b->num].dir = dir;
+    b->num++;
+}
+static inline void clip_add_point(clipwriter_t*w, int32_t x, int32_t y)
+{
+    if(x < w->x1) x = w->x1;
+    if(x > w->x2) x = w->x2;
+    if(y < w->y1) y = w->y1;
+    if(y > w->y2) y = w->y2;
+    if(w->num_points) {
+	point_t*last = &w->points[w->num_points-1];
+	if(last->x == x && last->y == y)
+	    return;
+	/* Parts of the polygon outside of the box end up as lines on the
+	   box border, often in pairs which cancel each other out. Collect
+	   them separately, and sum them up later. */
+	border_t*b = 0;
+	if(last->x == x && (x == w->x1 || x == w->x2)) {
+	    b = &w->border[x == w->x2];
+	    border_add(b, last->y, y, w->stroke->dir == DIR_DOWN ? 1 : -1);
+	} else if(last->y == y && (y == w->y1 || y == w->y2)) {
+	    b = &w->border[2 + (y == w->y2)];
+	    border_add(b, last->x, x, w->stroke->dir == DIR_DOWN ? 1 : -1);
+	}
+	if(b)
+	    clip_flush(w);
+    }
+    w->points[w->num_points].x = x;
+    w->points[w->num_points].y = y;
+    w->num_points++;
+}
+
+typedef struct _borderevent {
+    int32_t v;
+    int dir;
+} borderevent_t;
+
+static int compare_borderevents(const void*_e1, const void*_e2)
+{
+    borderevent_t*e1 = (borderevent_t*)_e1;
+    borderevent_t*e2 = (borderevent_t*)_e2;
+    if(e1->v != e2->v)
+	return e1->v < e2->v ? -1 : 1;
+    return 0;
+}
+
+/* replace the lines on a box border by as few lines as possible
+   with the same winding numbers */
+static void border_finish(clipwriter_t*w, border_t*b, edgestyle_t*fs)
+{
+    if(!b->num)
+	return;
+    borderevent_t*events = rfx_alloc(sizeof(borderevent_t)*b->num*2);
+    int t;
+    for(t=0;t<b->num;t++) {
+	events[t*2].v = b->pieces[t].v1;
+	events[t*2].dir = b->pieces[t].dir;
+	events[t*2+1].v = b->pieces[t].v2;
+	events[t*2+1].dir = -b->pieces[t].dir;
+    }
+    qsort(events, b->num*2, sizeof(borderevent_t), compare_borderevents);
+
+    int wind = 0;
+    for(t=0;t<b->num*2;) {
+	int32_t v = events[t].v;
+	while(t<b->num*2 && events[t].v == v) {
+	    wind += events[t].dir;
+	    t++;
+	}
+	if(!wind || t == b->num*2)
+	    continue;
+	int32_t v2 = events[t].v;
+	int n = wind<0 ? -wind : wind;
+	while(n--) {
+	    gfxpolystroke_t*s = rfx_calloc(sizeof(gfxpolystroke_t) + sizeof(point_t)*2);
+	    s->fs = fs;
+	    s->dir = wind>0 ? DIR_DOWN : DIR_UP;
+	    s->num_points = s->points_size = 2;
+	    s->points = (point_t*)(s+1);
+	    if(b->horizontal) {
+		s->points[0].x = v; s->points[0].y = b->pos;
+		s->points[1].x = v2; s->points[1].y = b->pos;
+	    } else {
+		s->points[0].x = b->pos; s->points[0].y = v;
+		s->points[1].x = b->pos; s->points[1].y = v2;
+	    }
+	    s->next = w->poly->strokes;
+	    w->poly->strokes = s;
+	}
+    }
+    rfx_free(events);
+    rfx_free(b->pieces);
+}
+
+static inline int32_t x_at(point_t a, point_t b, int32_t y)
+{
+    return a.x + (int32_t)floor((double)(b.x - a.x) * (y - a.y) / (b.y - a.y) + 0.5);
+}
+static inline int32_t y_at(point_t a, point_t b, int32_t x)
+{
+    return a.y + (int32_t)floor((double)(b.y - a.y) * (x - a.x) / (b.x - a.x) + 0.5);
+}
+static inline int32_t clamp_y(int32_t y, int32_t ymin, int32_t ymax)
+{
+    return y < ymin ? ymin : (y > ymax ? ymax : y);
+}
+
+/* Cut a polygon to an axis-aligned box, without a sweep.
+   This is Sutherland-Hodgman clipping, applied to strokes: every part
+   of the polygon outside of the box is moved onto the nearest box border.
+   That doesn't change the winding number of any point inside the box (and
+   makes it zero outside), so the result is a valid (even/odd or circular)
+   polygon describing the intersection. */
+gfxpoly_t* gfxpoly_intersect_box(gfxpoly_t*poly, gfxbbox_t*box)
+{
+    double z = 1.0 / poly->gridsize;
+    clipwriter_t w;
+    memset(&w, 0, sizeof(w));
+    w.x1 = (int32_t)floor(box->xmin * z + 0.5);
+    w.y1 = (int32_t)floor(box->ymin * z + 0.5);
+    w.x2 = (int32_t)floor(box->xmax * z + 0.5);
+    w.y2 = (int32_t)floor(box->ymax * z + 0.5);
+    w.border[0].pos = w.x1;
+    w.border[1].pos = w.x2;
+    w.border[2].pos = w.y1;
+    w.border[3].pos = w.y2;
+    w.border[2].horizontal = w.border[3].horizontal = 1;
+
+    w.poly = rfx_calloc(sizeof(gfxpoly_t));
+    w.poly->gridsize = poly->gridsize;
+    if(w.x1 >= w.x2 || w.y1 >= w.y2)
+	return w.poly;
+
+    int size = 0;
+    edgestyle_t*fs = &edgestyle_default;
+    gfxpolystroke_t*stroke;
+    for(stroke=poly->strokes;stroke;stroke=stroke->next) {
+	/* every segment produces at most six points */
+	if(stroke->num_points*6 > size) {
+	    size = stroke->num_points*6;
+	    w.points = rfx_realloc(w.points, sizeof(point_t)*size);
+	}
+	w.stroke = stroke;
+	w.num_points = 0;
+	fs = stroke->fs;
+
+	int t;
+	for(t=0;t<stroke->num_points-1;t++) {
+	    point_t a = stroke->points[t];
+	    point_t b = stroke->points[t+1];
+	    clip_add_point(&w, a.x, a.y);
+	    if(a.y == b.y || b.y <= w.y1 || a.y >= w.y2) {
+		clip_add_point(&w, b.x, b.y);
+		continue;
+	    }
+	    point_t p1 = a, p2 = b;
+	    if(a.y < w.y1) {
+		p1.x = x_at(a, b, w.y1);
+		p1.y = w.y1;
+		clip_add_point(&w, p1.x, p1.y);
+	    }
+	    if(b.y > w.y2) {
+		p2.x = x_at(a, b, w.y2);
+		p2.y = w.y2;
+	    }
+	    /* points where the segment crosses the left or right border */
+	    int32_t c1 = p1.y, c2 = p1.y;
+	    char has1 = (p1.x < w.x1) != (p2.x < w.x1);
+	    char has2 = (p1.x > w.x2) != (p2.x > w.x2);
+	    if(has1) c1 = clamp_y(y_at(a, b, w.x1), p1.y, p2.y);
+	    if(has2) c2 = clamp_y(y_at(a, b, w.x2), p1.y, p2.y);
+	    if(has1 && has2 && c2 < c1) {
+		clip_add_point(&w, w.x2, c2);
+		clip_add_point(&w, w.x1, c1);
+	    } else {
+		if(has1) clip_add_point(&w, w.x1, c1);
+		if(has2) clip_add_point(&w, w.x2, c2);
+	    }
+	    clip_add_point(&w, p2.x, p2.y);
+	    clip_add_point(&w, b.x, b.y);
+	}
+	clip_flush(&w);
+    }
+    int t;
+    for(t=0;t<4;t++)
+	border_finish(&w, &w.border[t], fs);
+    rfx_free(w.points);
+    return w.poly;
+}
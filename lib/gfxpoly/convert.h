@@ -18,13 +18,17 @@ void gfxdrawer_target_poly(gfxdrawer_t*d, double gridsize);
 
 void gfxpolywriter_init(polywriter_t*w);
 gfxpoly_t* gfxpoly_from_fill(gfxline_t*line, double gridsize);
+gfxpoly_t* gfxpoly_from_path(gfxpath_t*path, double gridsize);
 gfxpoly_t* gfxpoly_from_file(const char*filename, double gridsize);
 void gfxpoly_destroy(gfxpoly_t*poly);
 
 gfxline_t*gfxline_from_gfxpoly(gfxpoly_t*poly);
 gfxline_t*gfxline_from_gfxpoly_with_direction(gfxpoly_t*poly); // preserves up/down
+void gfxpoly_draw(gfxpoly_t*poly, gfxdrawer_t*draw);
 
 gfxline_t* gfxpoly_circular_to_evenodd(gfxline_t*line, double gridsize);
 gfxpoly_t* gfxpoly_createbox(double x1, double y1,double x2, double y2, double gridsize);
+gfxbbox_t gfxpoly_getbbox(gfxpoly_t*poly);
+gfxpoly_t* gfxpoly_intersect_box(gfxpoly_t*poly, gfxbbox_t*box);
 
 #endif //__poly_convert_h__
@@ -12,6 +12,12 @@
 #include "convert.h"
 #include "heap.h"
 #include "moments.h"
+#include "arena.h"
+#include "../os.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 #ifdef HAVE_MD5
 #include "MD5.h"
@@ -106,6 +112,18 @@ static inline int compare_events_simple(const void*_a,const void*_b)
     return 0;
 }
 
+/* orders segments by end point, direction and polygon */
+static inline int segment_cmp_key(segment_t*a, segment_t*b)
+{
+    if(a->a.y != b->a.y) return a->a.y < b->a.y ? -1 : 1;
+    if(a->a.x != b->a.x) return a->a.x < b->a.x ? -1 : 1;
+    if(a->b.y != b->b.y) return a->b.y < b->b.y ? -1 : 1;
+    if(a->b.x != b->b.x) return a->b.x < b->b.x ? -1 : 1;
+    if(a->dir != b->dir) return a->dir < b->dir ? -1 : 1;
+    if(a->polygon_nr != b->polygon_nr) return a->polygon_nr < b->polygon_nr ? -1 : 1;
+    return 0;
+}
+
 static inline int compare_events(const void*_a,const void*_b)
 {
     event_t* a = (event_t*)_a;
@@ -124,12 +142,17 @@ static inline int compare_events(const void*_a,const void*_b)
     */
     d = b->type - a->type;
     if(d) return d;
-    return 0;
 
-    /* I don't see any reason why we would need to order by x- at least as long
-       as we do horizontal lines in a seperate pass */
-    //d = b->p.x - a->p.x;
-    //return d;
+    /* Segments starting in the same point end up in the active list in the order
+       we process them. Make that order not depend on how the events happen to be
+       arranged in the heap, so that it can be reconstructed (see band_init) */
+    if(a->type == EVENT_START) {
+	d = b->p.x - a->p.x;
+	if(d) return d;
+	d = segment_cmp_key(b->s1, a->s1);
+	if(d) return d;
+    }
+    return 0;
 }
 
 #define COMPARE_EVENTS(x,y) (compare_events(x,y)>0)
@@ -151,11 +174,58 @@ typedef struct _horizdata {
     horizontal_t*data;
     int num;
     int size;
+    horizontal_t**open;
+    struct _hevent*events;
+    int events_size;
 } horizdata_t;
 
+/* A segment crossing the boundary between two bands of a parallel sweep */
+typedef struct _bandseg {
+    gfxpolystroke_t*stroke;
+    int pos; // the segment goes from stroke->points[pos] to stroke->points[pos+1]
+    int polygon_nr;
+    windstate_t wind;
+    edgestyle_t*fs_out;
+
+    /* entering a band: the first point the segment received in it (and how
+       to draw the edge leading there). leaving a band: the last point it received.
+       if it didn't receive any, "from" is where it entered the band */
+    char has_point;
+    point_t p;
+    edgestyle_t*p_fs;
+    segment_dir_t p_dir;
+    int from;
+} bandseg_t;
+
+/* output strokes, hashed by their last point */
+typedef struct _strokeend {
+    gfxpolystroke_t*stroke;
+    struct _strokeend*next;
+} strokeend_t;
+
+/* Memory used during a sweep. There's one of these per thread, and it's
+   kept around between gfxpoly_process() calls, so that small polygons
+   don't spend most of their time in malloc(). Events and segments come
+   from the arena (and are recycled through the free lists), and
+   are all released at once when the sweep is done. */
+typedef struct _sweepmem {
+    arena_t*arena;
+    event_t*free_events;
+    segment_t*free_segments;
+    actlist_t*actlist;
+    queue_t queue;
+    xrow_t*xrow;
+    horizdata_t horiz;
+    strokeend_t**stroke_ends;
+    int stroke_ends_size;
+    uint64_t events_processed;
+} sweepmem_t;
+
 typedef struct _status {
     int32_t y;
     double gridsize;
+    sweepmem_t*mem;
+    bandseg_t*seams;
     actlist_t*actlist;
     queue_t queue;
     xrow_t*xrow;
@@ -166,8 +236,11 @@ typedef struct _status {
     horizdata_t horiz;
 
     gfxpolystroke_t*strokes;
+    strokeend_t**stroke_ends;
+    int stroke_ends_size;
+    int num_stroke_ends;
+    int num_events;
 #ifdef CHECKS
-    dict_t*seen_crossings; //list of crossing we saw so far
     dict_t*intersecting_segs; //list of segments intersecting in this scanline
     dict_t*segs_with_point; //lists of segments that received a point in this scanline
 #endif
@@ -369,14 +442,21 @@ void gfxpoly_save_arrows(gfxpoly_t*poly, const char*filename)
     fclose(fi);
 }
 
-inline static event_t* event_new()
+inline static event_t* event_new(status_t*status)
 {
-    event_t*e = rfx_calloc(sizeof(event_t));
+    sweepmem_t*mem = status->mem;
+    event_t*e = mem->free_events;
+    if(e) {
+	mem->free_events = (event_t*)e->s1;
+    } else {
+	e = (event_t*)arena_alloc(mem->arena, sizeof(event_t));
+    }
     return e;
 }
-inline static void event_free(event_t*e)
+inline static void event_free(status_t*status, event_t*e)
 {
-    free(e);
+    e->s1 = (segment_t*)status->mem->free_events;
+    status->mem->free_events = e;
 }
 
 static void event_dump(status_t*status, event_t*e)
@@ -469,32 +549,29 @@ static void segment_init(segment_t*s, int32_t x1, int32_t y1, int32_t x2, int32_
     p.x = max32(s->a.x, s->b.x);
     assert(LINE_EQ(p, s) >= 0);
 #endif
-
-#ifndef DONT_REMEMBER_CROSSINGS
-    dict_init2(&s->scheduled_crossings, &ptr_type, 0);
-#endif
 }
 
-static segment_t* segment_new(point_t a, point_t b, int polygon_nr, segment_dir_t dir)
+static segment_t* segment_new(status_t*status, point_t a, point_t b, int polygon_nr, segment_dir_t dir)
 {
-    segment_t*s = (segment_t*)rfx_calloc(sizeof(segment_t));
+    sweepmem_t*mem = status->mem;
+    segment_t*s = mem->free_segments;
+    if(s) {
+	mem->free_segments = s->right;
+    } else {
+	s = (segment_t*)arena_alloc(mem->arena, sizeof(segment_t));
+    }
+    memset(s, 0, sizeof(segment_t));
     segment_init(s, a.x, a.y, b.x, b.y, polygon_nr, dir);
     return s;
 }
 
-static void segment_clear(segment_t*s)
+static void segment_destroy(status_t*status, segment_t*s)
 {
-#ifndef DONT_REMEMBER_CROSSINGS
-    dict_clear(&s->scheduled_crossings);
-#endif
-}
-static void segment_destroy(segment_t*s)
-{
-    segment_clear(s);
-    free(s);
+    s->right = status->mem->free_segments;
+    status->mem->free_segments = s;
 }
 
-static void advance_stroke(queue_t*queue, hqueue_t*hqueue, gfxpolystroke_t*stroke, int polygon_nr, int pos, double gridsize)
+static void advance_stroke(status_t*status, hqueue_t*hqueue, gfxpolystroke_t*stroke, int polygon_nr, int pos)
 {
     if(!stroke) 
 	return;
@@ -503,7 +580,7 @@ static void advance_stroke(queue_t*queue, hqueue_t*hqueue, gfxpolystroke_t*strok
        before horizontal events */
     while(pos < stroke->num_points-1) {
 	assert(stroke->points[pos].y <= stroke->points[pos+1].y);
-	s = segment_new(stroke->points[pos], stroke->points[pos+1], polygon_nr, stroke->dir);
+	s = segment_new(status, stroke->points[pos], stroke->points[pos+1], polygon_nr, stroke->dir);
 	s->fs = stroke->fs;
 	pos++;
 	s->stroke = 0;
@@ -512,17 +589,17 @@ static void advance_stroke(queue_t*queue, hqueue_t*hqueue, gfxpolystroke_t*strok
 	/*if(l->tmp)
 	    s->nr = l->tmp;*/
 	fprintf(stderr, "[%d] (%.2f,%.2f) -> (%.2f,%.2f) %s (stroke %p, %d more to come)\n",
-		s->nr, s->a.x * gridsize, s->a.y * gridsize, 
-		s->b.x * gridsize, s->b.y * gridsize,
+		s->nr, s->a.x * status->gridsize, s->a.y * status->gridsize, 
+		s->b.x * status->gridsize, s->b.y * status->gridsize,
 		s->dir==DIR_UP?"up":"down", stroke, stroke->num_points - 1 - pos);
 #endif
-	event_t* e = event_new();
+	event_t* e = event_new(status);
 	e->type = s->delta.y ? EVENT_START : EVENT_HORIZONTAL;
 	e->p = s->a;
 	e->s1 = s;
 	e->s2 = 0;
 	
-	if(queue) queue_put(queue, e);
+	if(!hqueue) queue_put(&status->queue, e);
 	else hqueue_put(hqueue, e);
 
 	if(e->type != EVENT_HORIZONTAL) {
@@ -535,7 +612,7 @@ static void advance_stroke(queue_t*queue, hqueue_t*hqueue, gfxpolystroke_t*strok
     }
 }
 
-static void gfxpoly_enqueue(gfxpoly_t*p, queue_t*queue, hqueue_t*hqueue, int polygon_nr)
+static void gfxpoly_enqueue(status_t*status, gfxpoly_t*p, hqueue_t*hqueue, int polygon_nr)
 {
     int t;
     gfxpolystroke_t*stroke = p->strokes;
@@ -548,7 +625,7 @@ static void gfxpoly_enqueue(gfxpoly_t*p, queue_t*queue, hqueue_t*hqueue, int pol
 	    assert(stroke->points[s].y <= stroke->points[s+1].y);
 	}
 #endif
-	advance_stroke(queue, hqueue, stroke, polygon_nr, 0, p->gridsize);
+	advance_stroke(status, hqueue, stroke, polygon_nr, 0);
     }
 }
 
@@ -556,7 +633,7 @@ static void schedule_endpoint(status_t*status, segment_t*s)
 {
     // schedule end point of segment
     assert(s->b.y > status->y);
-    event_t*e = event_new();
+    event_t*e = event_new(status);
     e->type = EVENT_END;
     e->p = s->b;
     e->s1 = s;
@@ -600,18 +677,14 @@ static void schedule_crossing(status_t*status, segment_t*s1, segment_t*s2)
         return;
     }
 
-#ifndef DONT_REMEMBER_CROSSINGS
-    if(dict_contains(&s1->scheduled_crossings, (void*)(ptroff_t)s2->nr)) {
-        /* FIXME: this whole segment hashing thing is really slow */
+    if(s1->crossing_right == s2) {
+        /* s1 and s2 were neighbors before, and the crossing event we scheduled
+           back then is still in the queue */
 #ifdef DEBUG
         fprintf(stderr, "[%d] doesn't intersect with [%d] because: we already scheduled this intersection\n", s1->nr, s2->nr);
-//	DICT_ITERATE_KEY(&s1->scheduled_crossings, void*, x) {
-//	    fprintf(stderr, "[%d]<->[%d]\n", s1->nr, (int)(ptroff_t)x);
-//	}
 #endif
-        return; // we already know about this one
+        return;
     }
-#endif
 
     double det = (double)s1->delta.x*s2->delta.y - (double)s1->delta.y*s2->delta.x;
     if(!det) {
@@ -656,9 +729,6 @@ static void schedule_crossing(status_t*status, segment_t*s1, segment_t*s2)
     }
     if(asign2>0 && bsign2>0)  {
         // segment1 is completely to the right of segment2
-#ifndef DONT_REMEMBER_CROSSINGS
-	assert(0);
-#endif
 #ifdef DEBUG
             fprintf(stderr, "[%d] doesn't intersect with [%d] because: [%d] is completely to the left of [%d]\n", s1->nr, s2->nr, s2->nr, s1->nr);
 #endif
@@ -684,9 +754,6 @@ static void schedule_crossing(status_t*status, segment_t*s1, segment_t*s2)
 
     if(asign1<0 && bsign1<0) {
         // segment2 is completely to the left of segment1
-#ifndef DONT_REMEMBER_CROSSINGS
-	assert(0);
-#endif
 #ifdef DEBUG
             fprintf(stderr, "[%d] doesn't intersect with [%d] because: [%d] is completely to the left of [%d]\n", s1->nr, s2->nr, s1->nr, s2->nr);
 #endif
@@ -700,12 +767,10 @@ static void schedule_crossing(status_t*status, segment_t*s1, segment_t*s2)
         return;
     }
 
-#ifdef DONT_REMEMBER_CROSSINGS
     /* s2 crosses s1 from *left* to *right*. This is a crossing we already processed- 
        there's not way s2 would be to the left of s1 otherwise */
     if(asign1<0 && bsign1>0) return;
     if(asign2>0 && bsign2<0) return;
-#endif
 
     assert(!(asign1<0 && bsign1>0));
     assert(!(asign2>0 && bsign2<0));
@@ -722,27 +787,17 @@ static void schedule_crossing(status_t*status, segment_t*s1, segment_t*s2)
 #ifdef CHECKS
     assert(p.x >= s1->minx && p.x <= s1->maxx);
     assert(p.x >= s2->minx && p.x <= s2->maxx);
-
-    point_t pair;
-    pair.x = s1->nr;
-    pair.y = s2->nr;
-#ifndef DONT_REMEMBER_CROSSINGS
-    assert(!dict_contains(status->seen_crossings, &pair));
-    dict_put(status->seen_crossings, &pair, 0);
-#endif
 #endif
 #ifdef DEBUG
     fprintf(stderr, "schedule crossing between [%d] and [%d] at (%d,%d)\n", s1->nr, s2->nr, p.x, p.y);
 #endif
 
-#ifndef DONT_REMEMBER_CROSSINGS
-    /* we insert into each other's intersection history because these segments might switch
-       places and we still want to look them up quickly after they did */
-    dict_put(&s1->scheduled_crossings, (void*)(ptroff_t)(s2->nr), 0);
-    dict_put(&s2->scheduled_crossings, (void*)(ptroff_t)(s1->nr), 0);
-#endif
+    /* remember that this event is pending. If another segment gets inserted
+       between s1 and s2 and removed again before the crossing happens, we
+       don't need to put a second event for the same crossing into the queue. */
+    s1->crossing_right = s2;
 
-    event_t* e = event_new();
+    event_t* e = event_new(status);
     e->type = EVENT_CROSS;
     e->p = p;
     e->s1 = s1;
@@ -790,18 +845,49 @@ static inline box_t box_new(int32_t x, int32_t y)
 
 static void store_horizontal(status_t*status, point_t p1, point_t p2, edgestyle_t*fs, segment_dir_t dir, int polygon_nr);
 
+static inline unsigned int stroke_end_hash(status_t*status, point_t p)
+{
+    unsigned int h = (uint32_t)p.x*0x9e3779b1u ^ (uint32_t)p.y*0x85ebca6bu;
+    return (h^(h>>15)) & (status->stroke_ends_size-1);
+}
+
+static void stroke_ends_grow(status_t*status)
+{
+    int oldsize = status->stroke_ends_size;
+    strokeend_t**old = status->stroke_ends;
+    status->stroke_ends_size *= 2;
+    status->stroke_ends = (strokeend_t**)rfx_calloc(sizeof(strokeend_t*)*status->stroke_ends_size);
+    int t;
+    for(t=0;t<oldsize;t++) {
+	strokeend_t*e = old[t];
+	while(e) {
+	    strokeend_t*next = e->next;
+	    gfxpolystroke_t*stroke = e->stroke;
+	    unsigned int h = stroke_end_hash(status, stroke->points[stroke->num_points-1]);
+	    e->next = status->stroke_ends[h];
+	    status->stroke_ends[h] = e;
+	    e = next;
+	}
+    }
+    rfx_free(old);
+}
+
 static void append_stroke(status_t*status, point_t a, point_t b, segment_dir_t dir, edgestyle_t*fs)
 {
-    gfxpolystroke_t*stroke = status->strokes;
     /* find a stoke to attach this segment to. It has to have an endpoint
        matching our start point, and a matching edgestyle */
-    while(stroke) {
+    unsigned int h = stroke_end_hash(status, a);
+    strokeend_t*e = status->stroke_ends[h], *prev = 0;
+    while(e) {
+	gfxpolystroke_t*stroke = e->stroke;
 	point_t p = stroke->points[stroke->num_points-1];
 	if(p.x == a.x && p.y == a.y && stroke->fs == fs && stroke->dir == dir)
 	    break;
-	stroke = stroke->next;
+	prev = e;
+	e = e->next;
     }
-    if(!stroke) {
+    gfxpolystroke_t*stroke;
+    if(!e) {
 	stroke = rfx_calloc(sizeof(gfxpolystroke_t));
 	stroke->dir = dir;
 	stroke->fs = fs;
@@ -811,12 +897,28 @@ static void append_stroke(status_t*status, point_t a, point_t b, segment_dir_t d
 	stroke->points = rfx_calloc(sizeof(point_t)*stroke->points_size);
 	stroke->points[0] = a;
 	stroke->num_points = 1;
-    } else if(stroke->num_points == stroke->points_size) {
-	assert(stroke->fs);
-	stroke->points_size *= 2;
-	stroke->points = rfx_realloc(stroke->points, sizeof(point_t)*stroke->points_size);
+	if(++status->num_stroke_ends > status->stroke_ends_size)
+	    stroke_ends_grow(status);
+	e = (strokeend_t*)arena_alloc(status->mem->arena, sizeof(strokeend_t));
+	e->stroke = stroke;
+    } else {
+	stroke = e->stroke;
+	if(prev)
+	    prev->next = e->next;
+	else
+	    status->stroke_ends[h] = e->next;
+	if(stroke->num_points == stroke->points_size) {
+	    assert(stroke->fs);
+	    stroke->points_size *= 2;
+	    stroke->points = rfx_realloc(stroke->points, sizeof(point_t)*stroke->points_size);
+	}
     }
     stroke->points[stroke->num_points++] = b;
+
+    /* the stroke now ends at b */
+    h = stroke_end_hash(status, b);
+    e->next = status->stroke_ends[h];
+    status->stroke_ends[h] = e;
 }
 
 static void insert_point_into_segment(status_t*status, segment_t*s, point_t p)
@@ -829,6 +931,20 @@ static void insert_point_into_segment(status_t*status, segment_t*s, point_t p)
     assert(s->fs_out_ok);
 #endif
 
+    if(s->seam) {
+	/* first point of a segment that entered this band from the band above.
+	   Where it came from is only known to that band, so leave drawing
+	   the edge to gfxpoly_process_parallel */
+	bandseg_t*b = &status->seams[s->seam-1];
+	b->has_point = 1;
+	b->p = p;
+	b->p_fs = s->fs_out;
+	b->p_dir = s->wind.is_filled?DIR_DOWN:DIR_UP;
+	s->seam = 0;
+	s->pos = p;
+	return;
+    }
+
     if(s->pos.y != p.y) {
 	/* non horizontal line- copy to output */
 	if(s->fs_out) {
@@ -1049,7 +1165,7 @@ static void add_points_to_ending_segments(status_t*status, int32_t y)
 #endif
         }
         // now that this is done, too, we can also finally free this segment
-        segment_destroy(seg);
+        segment_destroy(status, seg);
         seg = next;
     }
     status->ending_segments = 0;
@@ -1187,6 +1303,10 @@ void horiz_destroy(horizdata_t*horiz)
 {
     if(horiz->data) rfx_free(horiz->data);
     horiz->data = 0;
+    if(horiz->open) rfx_free(horiz->open);
+    horiz->open = 0;
+    if(horiz->events) rfx_free(horiz->events);
+    horiz->events = 0;
 }
 
 static windstate_t get_horizontal_first_windstate(status_t*status, int x1, int x2)
@@ -1280,7 +1400,18 @@ static int compare_hevents(const void *_e1, const void *_e2)
     hevent_t*e2 = (hevent_t*)_e2;
     int diff = e1->x - e2->x;
     if(diff) return diff;
-    return e1->type - e2->type; //schedule hotpixel before hend
+    diff = e1->type - e2->type; //schedule hotpixel before hend
+    if(diff) return diff;
+    if(!e1->h || !e2->h) return 0;
+    /* make the order of overlapping horizontals independent of the order
+       in which they were stored */
+    diff = e1->h->x1 - e2->h->x1;
+    if(diff) return diff;
+    diff = e1->h->x2 - e2->h->x2;
+    if(diff) return diff;
+    diff = e1->h->dir - e2->h->dir;
+    if(diff) return diff;
+    return e1->h->polygon_nr - e2->h->polygon_nr;
 }
 
 static hevents_t hevents_fill(status_t*status)
@@ -1288,8 +1419,14 @@ static hevents_t hevents_fill(status_t*status)
     horizdata_t*horiz = &status->horiz;
     xrow_t*xrow = status->xrow;
 
+    int size = horiz->num*2 + xrow->num;
+    if(size > horiz->events_size) {
+	horiz->events_size = size;
+	horiz->events = rfx_realloc(horiz->events, sizeof(hevent_t)*size);
+    }
+
     hevents_t e;
-    e.events = malloc(sizeof(hevent_t)*(horiz->num*2 + xrow->num));
+    e.events = horiz->events;
     e.num = 0;
 
     int t;
@@ -1324,7 +1461,7 @@ static void process_horizontals(status_t*status)
 
     hevents_t events = hevents_fill(status);
     int num_open = 0;
-    horizontal_t**open = malloc(sizeof(horizontal_t*)*horiz->num);
+    horizontal_t**open = horiz->open;
 
     int s,t;
     for(t=0;t<events.num;t++) {
@@ -1368,8 +1505,6 @@ static void process_horizontals(status_t*status)
 	    break;
 	}
     }
-    free(open);
-    free(events.events);
 }
 
 static void store_horizontal(status_t*status, point_t p1, point_t p2, edgestyle_t*fs, segment_dir_t dir, int polygon_nr)
@@ -1391,6 +1526,7 @@ static void store_horizontal(status_t*status, point_t p1, point_t p2, edgestyle_
 	    status->horiz.size = 16;
 	status->horiz.size *= 2;
 	status->horiz.data = rfx_realloc(status->horiz.data, sizeof(status->horiz.data[0])*status->horiz.size);
+	status->horiz.open = rfx_realloc(status->horiz.open, sizeof(status->horiz.open[0])*status->horiz.size);
     }
     horizontal_t*h = &status->horiz.data[status->horiz.num++];
     h->y = p1.y;
@@ -1414,8 +1550,8 @@ static void event_apply(status_t*status, event_t*e)
             segment_t*s = e->s1;
             intersect_with_horizontal(status, s);
 	    store_horizontal(status, s->a, s->b, s->fs, s->dir, s->polygon_nr);
-	    advance_stroke(&status->queue, 0, s->stroke, s->polygon_nr, s->stroke_pos, status->gridsize);
-            segment_destroy(s);e->s1=0;
+	    advance_stroke(status, 0, s->stroke, s->polygon_nr, s->stroke_pos);
+            segment_destroy(status, s);e->s1=0;
             break;
         }
         case EVENT_END: {
@@ -1436,7 +1572,7 @@ static void event_apply(status_t*status, event_t*e)
 	    /* schedule segment for xrow handling */
             s->left = 0; s->right = status->ending_segments;
             status->ending_segments = s;
-	    advance_stroke(&status->queue, 0, s->stroke, s->polygon_nr, s->stroke_pos, status->gridsize);
+	    advance_stroke(status, 0, s->stroke, s->polygon_nr, s->stroke_pos);
             break;
         }
         case EVENT_START: {
@@ -1454,6 +1590,8 @@ static void event_apply(status_t*status, event_t*e)
             break;
         }
         case EVENT_CROSS: {
+	    if(e->s1->crossing_right == e->s2)
+		e->s1->crossing_right = 0;
             // exchange two segments
             if(e->s1->right == e->s2) {
 		assert(e->s2->left == e->s1);
@@ -1463,22 +1601,8 @@ static void event_apply(status_t*status, event_t*e)
 #ifdef DEBUG
 		fprintf(stderr, "Ignore this crossing ([%d] not next to [%d])\n", e->s1->nr, e->s2->nr);
 #endif
-#ifndef DONT_REMEMBER_CROSSINGS
                 /* ignore this crossing for now (there are some line segments in between).
                    it'll get rescheduled as soon as the "obstacles" are gone */
-                char del1 = dict_del(&e->s1->scheduled_crossings, (void*)(ptroff_t)e->s2->nr);
-                char del2 = dict_del(&e->s2->scheduled_crossings, (void*)(ptroff_t)e->s1->nr);
-                assert(del1 && del2);
-#endif
-#ifdef CHECKS
-                point_t pair;
-                pair.x = e->s1->nr;
-                pair.y = e->s2->nr;
-#ifndef DONT_REMEMBER_CROSSINGS
-                assert(dict_contains(status->seen_crossings, &pair));
-                dict_del(status->seen_crossings, &pair);
-#endif
-#endif
             }
         }
     }
@@ -1501,98 +1625,163 @@ static void check_status(status_t*status)
 }
 #endif
 
-gfxpoly_t* gfxpoly_process(gfxpoly_t*poly1, gfxpoly_t*poly2, windrule_t*windrule, windcontext_t*context, moments_t*moments)
+static sweepmem_t* sweepmem_new()
 {
-    current_polygon = poly1;
+    sweepmem_t*mem = (sweepmem_t*)rfx_calloc(sizeof(sweepmem_t));
+    mem->arena = arena_new();
+    mem->actlist = actlist_new();
+    mem->xrow = xrow_new();
+    mem->stroke_ends_size = 256;
+    mem->stroke_ends = (strokeend_t**)rfx_calloc(sizeof(strokeend_t*)*mem->stroke_ends_size);
+    return mem;
+}
 
-    status_t status;
-    memset(&status, 0, sizeof(status_t));
-    status.gridsize = poly1->gridsize;
-    status.windrule = windrule;
-    status.context = context;
-    status.actlist = actlist_new();
-
-    queue_init(&status.queue);
-    gfxpoly_enqueue(poly1, &status.queue, 0, /*polygon nr*/0);
-    if(poly2) {
-	assert(poly1->gridsize == poly2->gridsize);
-	gfxpoly_enqueue(poly2, &status.queue, 0, /*polygon nr*/1);
-    }
+static void sweepmem_destroy(void*_mem)
+{
+    sweepmem_t*mem = (sweepmem_t*)_mem;
+    arena_destroy(mem->arena);
+    actlist_destroy(mem->actlist);
+    queue_destroy(&mem->queue);
+    xrow_destroy(mem->xrow);
+    horiz_destroy(&mem->horiz);
+    rfx_free(mem->stroke_ends);
+    rfx_free(mem);
+}
 
-#ifdef CHECKS
-    status.seen_crossings = dict_new2(&point_type);
+#ifdef HAVE_PTHREAD_H
+static pthread_key_t sweepmem_key;
+static pthread_once_t sweepmem_once = PTHREAD_ONCE_INIT;
+static void sweepmem_key_init()
+{
+    pthread_key_create(&sweepmem_key, sweepmem_destroy);
+}
+#endif
+
+static sweepmem_t* sweepmem_get()
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_once(&sweepmem_once, sweepmem_key_init);
+    sweepmem_t*mem = (sweepmem_t*)pthread_getspecific(sweepmem_key);
+    if(!mem) {
+	mem = sweepmem_new();
+	pthread_setspecific(sweepmem_key, mem);
+    }
+#else
+    static sweepmem_t*mem = 0;
+    if(!mem)
+	mem = sweepmem_new();
 #endif
+    return mem;
+}
+
+static void status_init(status_t*status, double gridsize, windrule_t*windrule, windcontext_t*context)
+{
+    memset(status, 0, sizeof(status_t));
+    status->gridsize = gridsize;
+    status->windrule = windrule;
+    status->context = context;
+
+    sweepmem_t*mem = sweepmem_get();
+    status->mem = mem;
+    status->actlist = mem->actlist;
+    status->queue = mem->queue;
+    status->xrow = mem->xrow;
+    status->horiz = mem->horiz;
+    status->stroke_ends = mem->stroke_ends;
+    status->stroke_ends_size = mem->stroke_ends_size;
+}
+
+static void status_finish(status_t*status)
+{
+    sweepmem_t*mem = status->mem;
+
+    /* hand the buffers back, and release all events and segments */
+    actlist_clear(status->actlist);
+    mem->queue = status->queue;
+    mem->queue.size = 0;
+    mem->horiz = status->horiz;
+    horiz_reset(&mem->horiz);
+    xrow_reset(mem->xrow);
+    /* every stroke has exactly one entry, at its last point */
+    gfxpolystroke_t*stroke;
+    for(stroke=status->strokes;stroke;stroke=stroke->next)
+	status->stroke_ends[stroke_end_hash(status, stroke->points[stroke->num_points-1])] = 0;
+    mem->stroke_ends = status->stroke_ends;
+    mem->stroke_ends_size = status->stroke_ends_size;
+    mem->free_events = 0;
+    mem->free_segments = 0;
+    arena_reset(mem->arena);
+}
+
+/* process all events above scanline yend */
+static void sweep(status_t*status, int32_t yend, moments_t*moments)
+{
     int32_t lasty = INT_MIN;
     if(moments) {
         memset(moments, 0, sizeof(moments_t));
     }
 
-    status.xrow = xrow_new();
-
-    event_t*e = queue_get(&status.queue);
-    while(e) {
+    event_t*e = queue_get(&status->queue);
+    while(e && e->p.y < yend) {
 	assert(e->s1->fs);
-        status.y = e->p.y;
+        status->y = e->p.y;
 #ifdef CHECKS
-	assert(status.y > lasty);
-        status.intersecting_segs = dict_new2(&ptr_type);
-        status.segs_with_point = dict_new2(&ptr_type);
+	assert(status->y > lasty);
+        status->intersecting_segs = dict_new2(&ptr_type);
+        status->segs_with_point = dict_new2(&ptr_type);
 #endif
 
 #ifdef DEBUG
-        fprintf(stderr, "----------------------------------- %.2f\n", status.y * status.gridsize);
-        actlist_dump(status.actlist, status.y-1, status.gridsize);
+        fprintf(stderr, "----------------------------------- %.2f\n", status->y * status->gridsize);
+        actlist_dump(status->actlist, status->y-1, status->gridsize);
 #endif
 #ifdef CHECKS
-        actlist_verify(status.actlist, status.y-1);
+        actlist_verify(status->actlist, status->y-1);
 #endif
         if(moments && lasty > INT_MIN) {
-            moments_update(moments, status.actlist, lasty, status.y);
+            moments_update(moments, status->actlist, lasty, status->y);
         }
 
-        xrow_reset(status.xrow);
-	horiz_reset(&status.horiz);
+        xrow_reset(status->xrow);
+	horiz_reset(&status->horiz);
 
         do {
-            xrow_add(status.xrow, e->p.x);
-            event_apply(&status, e);
-	    event_free(e);
-            e = queue_get(&status.queue);
-        } while(e && status.y == e->p.y);
-
-        xrow_sort(status.xrow);
+            xrow_add(status->xrow, e->p.x);
+            status->num_events++;
+            event_apply(status, e);
+	    event_free(status, e);
+            e = queue_get(&status->queue);
+        } while(e && status->y == e->p.y);
+
+        xrow_sort(status->xrow);
         segrange_t range;
         memset(&range, 0, sizeof(range));
 #ifdef DEBUG
-        actlist_dump(status.actlist, status.y, status.gridsize);
-	xrow_dump(status.xrow, status.gridsize);
+        actlist_dump(status->actlist, status->y, status->gridsize);
+	xrow_dump(status->xrow, status->gridsize);
 #endif
-        add_points_to_positively_sloped_segments(&status, status.y, &range);
-        add_points_to_negatively_sloped_segments(&status, status.y, &range);
-        add_points_to_ending_segments(&status, status.y);
+        add_points_to_positively_sloped_segments(status, status->y, &range);
+        add_points_to_negatively_sloped_segments(status, status->y, &range);
+        add_points_to_ending_segments(status, status->y);
 
-        recalculate_windings(&status, &range);
+        recalculate_windings(status, &range);
         
-	actlist_verify(status.actlist, status.y);
-	process_horizontals(&status);
+	actlist_verify(status->actlist, status->y);
+	process_horizontals(status);
 #ifdef CHECKS
-        check_status(&status);
-        dict_destroy(status.intersecting_segs);
-        dict_destroy(status.segs_with_point);
+        check_status(status);
+        dict_destroy(status->intersecting_segs);
+        dict_destroy(status->segs_with_point);
 #endif
-	lasty = status.y;
+	lasty = status->y;
     }
-#ifdef CHECKS
-    dict_destroy(status.seen_crossings);
-#endif
-    actlist_destroy(status.actlist);
-    queue_destroy(&status.queue);
-    horiz_destroy(&status.horiz);
-    xrow_destroy(status.xrow);
+}
 
+static gfxpoly_t* gfxpoly_new_from_strokes(double gridsize, gfxpolystroke_t*strokes)
+{
     gfxpoly_t*p = (gfxpoly_t*)malloc(sizeof(gfxpoly_t));
-    p->gridsize = poly1->gridsize;
-    p->strokes = status.strokes;
+    p->gridsize = gridsize;
+    p->strokes = strokes;
 
 #ifdef CHECKS
     /* we only add segments with non-empty edgestyles to strokes in
@@ -1606,6 +1795,441 @@ gfxpoly_t* gfxpoly_process(gfxpoly_t*poly1, gfxpoly_t*poly2, windrule_t*windrule
     return p;
 }
 
+/* In a parallel sweep, the y range is split into bands, which are swept
+   independently. The active list at the top of a band is reconstructed from
+   the input data, and compared against what the band above left behind once
+   both are done. If they don't match, the band is swept again, starting from
+   the right state, so the result is always the same as that of a serial sweep. */
+static int num_threads = 1;
+
+void gfxpoly_set_num_threads(int num)
+{
+    num_threads = num;
+}
+
+/* number of sweep events processed so far by operations started from the
+   calling thread (for benchmarking). Band sweeps are counted for the thread
+   that started the parallel sweep. */
+uint64_t gfxpoly_events_processed()
+{
+    return sweepmem_get()->events_processed;
+}
+
+#ifndef PARALLEL_MIN_SEGMENTS
+#define PARALLEL_MIN_SEGMENTS 4096
+#endif
+
+typedef struct _band {
+    gfxpoly_t*poly1;
+    gfxpoly_t*poly2;
+    windrule_t*windrule;
+    windcontext_t*context;
+
+    /* we process scanlines y1 <= y < y2 */
+    int32_t y1, y2;
+
+    bandseg_t*in;
+    int num_in;
+    bandseg_t*out;
+    int num_out;
+
+    gfxpolystroke_t*strokes;
+    int num_events;
+} band_t;
+
+/* returns the segment of the stroke that's crossing from scanline y-1 to y, or -1 */
+static int stroke_find_active(gfxpolystroke_t*stroke, int32_t y)
+{
+    int min = 0, max = stroke->num_points-1;
+    /* find the first segment that doesn't end above y */
+    while(min < max) {
+	int mid = (min+max)/2;
+	if(stroke->points[mid+1].y < y)
+	    min = mid+1;
+	else
+	    max = mid;
+    }
+    if(min < stroke->num_points-1 && stroke->points[min].y < y && stroke->points[min+1].y >= y)
+	return min;
+    return -1;
+}
+
+/* returns the first segment of the stroke starting at or below y, or -1 */
+static int stroke_find_start(gfxpolystroke_t*stroke, int32_t y)
+{
+    int min = 0, max = stroke->num_points-1;
+    while(min < max) {
+	int mid = (min+max)/2;
+	if(stroke->points[mid].y < y)
+	    min = mid+1;
+	else
+	    max = mid;
+    }
+    return min < stroke->num_points-1 ? min : -1;
+}
+
+static void band_enqueue(status_t*status, gfxpoly_t*p, int polygon_nr, int32_t y)
+{
+    gfxpolystroke_t*stroke = p->strokes;
+    for(;stroke;stroke=stroke->next) {
+	int pos;
+	if(y == INT_MIN) {
+	    pos = 0;
+	} else {
+	    /* strokes in the active list continue once their current segment ends */
+	    if(stroke_find_active(stroke, y) >= 0)
+		continue;
+	    pos = stroke_find_start(stroke, y);
+	    if(pos < 0)
+		continue;
+	}
+	advance_stroke(status, 0, stroke, polygon_nr, pos);
+    }
+}
+
+static int band_collect_poly(bandseg_t*in, int num, gfxpoly_t*p, int polygon_nr, int32_t y)
+{
+    gfxpolystroke_t*stroke = p->strokes;
+    for(;stroke;stroke=stroke->next) {
+	int pos = stroke_find_active(stroke, y);
+	if(pos >= 0) {
+	    if(in) {
+		memset(&in[num], 0, sizeof(bandseg_t));
+		in[num].stroke = stroke;
+		in[num].pos = pos;
+		in[num].polygon_nr = polygon_nr;
+	    }
+	    num++;
+	}
+    }
+    return num;
+}
+
+/* compares two segments, both spanning scanline y, by their x position just below y.
+   (We abuse the pos field of the segment to hold y) */
+static int compare_segments_below(const void*_s1, const void*_s2)
+{
+    segment_t*s1 = *(segment_t**)_s1;
+    segment_t*s2 = *(segment_t**)_s2;
+    int32_t y = s1->pos.y;
+
+    /* x = n/delta.y. Coordinates are < 2^26, so this all fits into 64 bit */
+    int64_t n1 = (int64_t)s1->a.x*s1->delta.y + (int64_t)s1->delta.x*(y - s1->a.y);
+    int64_t n2 = (int64_t)s2->a.x*s2->delta.y + (int64_t)s2->delta.x*(y - s2->a.y);
+    int64_t q1 = n1 / s1->delta.y, r1 = n1 % s1->delta.y;
+    int64_t q2 = n2 / s2->delta.y, r2 = n2 % s2->delta.y;
+    if(r1 < 0) {q1--;r1 += s1->delta.y;}
+    if(r2 < 0) {q2--;r2 += s2->delta.y;}
+    if(q1 != q2) return q1 < q2 ? -1 : 1;
+    int64_t d = r1*s2->delta.y - r2*s1->delta.y;
+    if(d) return d < 0 ? -1 : 1;
+
+    /* same x position: compare slopes */
+    d = (int64_t)s1->delta.x*s2->delta.y - (int64_t)s2->delta.x*s1->delta.y;
+    if(d) return d < 0 ? -1 : 1;
+
+    /* segments on top of each other are in the order they were inserted */
+    return segment_cmp_key(s1, s2);
+}
+
+static void band_sweep(band_t*band, char reconstruct)
+{
+    status_t status;
+    status_init(&status, band->poly1->gridsize, band->windrule, band->context);
+    int32_t y = band->y1;
+
+    if(y != INT_MIN) {
+	status.y = y - 1;
+	if(reconstruct) {
+	    int num = band_collect_poly(0, 0, band->poly1, 0, y);
+	    if(band->poly2)
+		num = band_collect_poly(0, num, band->poly2, 1, y);
+	    band->in = (bandseg_t*)rfx_alloc(sizeof(bandseg_t)*(num?num:1));
+	    num = band_collect_poly(band->in, 0, band->poly1, 0, y);
+	    if(band->poly2)
+		num = band_collect_poly(band->in, num, band->poly2, 1, y);
+	    band->num_in = num;
+	}
+
+	int t;
+	segment_t**segs = (segment_t**)rfx_alloc(sizeof(segment_t*)*(band->num_in?band->num_in:1));
+	for(t=0;t<band->num_in;t++) {
+	    bandseg_t*b = &band->in[t];
+	    segment_t*s = segment_new(&status, b->stroke->points[b->pos], b->stroke->points[b->pos+1], 
+		                      b->polygon_nr, b->stroke->dir);
+	    s->fs = b->stroke->fs;
+	    s->stroke = b->stroke;
+	    s->stroke_pos = b->pos+1;
+	    s->pos.x = s->a.x;
+	    s->pos.y = y - 1;
+	    s->seam = t+1;
+	    segs[t] = s;
+	}
+	if(reconstruct) {
+	    qsort(segs, band->num_in, sizeof(segment_t*), compare_segments_below);
+	    bandseg_t*in = (bandseg_t*)rfx_alloc(sizeof(bandseg_t)*(band->num_in?band->num_in:1));
+	    for(t=0;t<band->num_in;t++) {
+		in[t] = band->in[segs[t]->seam-1];
+		segs[t]->seam = t+1;
+	    }
+	    rfx_free(band->in);
+	    band->in = in;
+	}
+	status.seams = band->in;
+
+	actlist_set(status.actlist, segs, band->num_in);
+	windstate_t wind = status.windrule->start(status.context);
+	for(t=0;t<band->num_in;t++) {
+	    segment_t*s = segs[t];
+	    s->wind = status.windrule->add(status.context, wind, s->fs, s->dir, s->polygon_nr);
+	    s->fs_out = status.windrule->diff(&wind, &s->wind);
+#ifdef CHECKS
+	    s->fs_out_ok = 1;
+#endif
+	    wind = s->wind;
+	    band->in[t].wind = s->wind;
+	    band->in[t].fs_out = s->fs_out;
+	}
+	for(t=0;t<band->num_in;t++) {
+	    schedule_endpoint(&status, segs[t]);
+	    if(t)
+		schedule_crossing(&status, segs[t-1], segs[t]);
+	}
+	rfx_free(segs);
+    }
+
+    band_enqueue(&status, band->poly1, 0, y);
+    if(band->poly2)
+	band_enqueue(&status, band->poly2, 1, y);
+
+    sweep(&status, band->y2, 0);
+
+    band->num_out = actlist_size(status.actlist);
+    band->out = (bandseg_t*)rfx_calloc(sizeof(bandseg_t)*(band->num_out?band->num_out:1));
+    segment_t*s = actlist_leftmost(status.actlist);
+    int t = 0;
+    for(;s;s=s->right) {
+	bandseg_t*b = &band->out[t++];
+	b->stroke = s->stroke;
+	b->pos = s->stroke_pos-1;
+	b->polygon_nr = s->polygon_nr;
+	b->wind = s->wind;
+	b->fs_out = s->fs_out;
+	if(s->seam) {
+	    b->from = s->seam-1;
+	} else {
+	    b->has_point = 1;
+	    b->p = s->pos;
+	}
+    }
+    band->strokes = status.strokes;
+    band->num_events += status.num_events;
+    status_finish(&status);
+}
+
+static void band_worker(void*data, int nr)
+{
+    band_t*bands = (band_t*)data;
+    band_sweep(&bands[nr], 1);
+}
+
+/* check whether a band started out with the state the band above it left behind */
+static char band_seam_ok(band_t*above, band_t*band)
+{
+    if(above->num_out != band->num_in)
+	return 0;
+    int t;
+    for(t=0;t<band->num_in;t++) {
+	bandseg_t*b1 = &above->out[t];
+	bandseg_t*b2 = &band->in[t];
+	if(b1->stroke != b2->stroke || b1->pos != b2->pos) {
+	    /* could still be a segment with exactly the same properties */
+	    point_t*p1 = &b1->stroke->points[b1->pos];
+	    point_t*p2 = &b2->stroke->points[b2->pos];
+	    if(p1[0].x != p2[0].x || p1[0].y != p2[0].y ||
+	       p1[1].x != p2[1].x || p1[1].y != p2[1].y ||
+	       b1->stroke->dir != b2->stroke->dir ||
+	       b1->stroke->fs != b2->stroke->fs ||
+	       b1->polygon_nr != b2->polygon_nr)
+		return 0;
+	}
+	if(b1->wind.is_filled != b2->wind.is_filled ||
+	   b1->wind.wind_nr != b2->wind.wind_nr ||
+	   b1->fs_out != b2->fs_out)
+	    return 0;
+    }
+    return 1;
+}
+
+static void band_free(band_t*band)
+{
+    if(band->in) rfx_free(band->in);
+    if(band->out) rfx_free(band->out);
+    band->in = band->out = 0;
+    band->num_in = band->num_out = 0;
+}
+
+static void strokes_destroy(gfxpolystroke_t*stroke)
+{
+    while(stroke) {
+	gfxpolystroke_t*next = stroke->next;
+	free(stroke->points);
+	free(stroke);
+	stroke = next;
+    }
+}
+
+static int compare_ys(const void*_i1, const void*_i2)
+{
+    int32_t i1 = *(int32_t*)_i1;
+    int32_t i2 = *(int32_t*)_i2;
+    return i1 < i2 ? -1 : (i1 > i2 ? 1 : 0);
+}
+
+static int collect_start_ys(gfxpoly_t*p, int32_t*ys, int num)
+{
+    gfxpolystroke_t*stroke = p->strokes;
+    for(;stroke;stroke=stroke->next) {
+	int t;
+	for(t=0;t<stroke->num_points-1;t++) {
+	    ys[num++] = stroke->points[t].y;
+	}
+    }
+    return num;
+}
+
+static gfxpoly_t* gfxpoly_process_parallel(gfxpoly_t*poly1, gfxpoly_t*poly2, windrule_t*windrule, windcontext_t*context, int num_bands)
+{
+    /* split the y range such that every band gets roughly the same number of segments */
+    int num = gfxpoly_size(poly1) + (poly2?gfxpoly_size(poly2):0);
+    int32_t*ys = (int32_t*)rfx_alloc(sizeof(int32_t)*num);
+    num = collect_start_ys(poly1, ys, 0);
+    if(poly2)
+	num = collect_start_ys(poly2, ys, num);
+    qsort(ys, num, sizeof(int32_t), compare_ys);
+
+    band_t*bands = (band_t*)rfx_calloc(sizeof(band_t)*num_bands);
+    int t, n = 0;
+    int32_t lasty = INT_MIN;
+    for(t=0;t<num_bands;t++) {
+	int32_t y = t ? ys[(int)((double)num*t/num_bands)] : INT_MIN;
+	if(t && y <= lasty)
+	    continue;
+	bands[n].poly1 = poly1;
+	bands[n].poly2 = poly2;
+	bands[n].windrule = windrule;
+	bands[n].context = context;
+	bands[n].y1 = y;
+	if(n)
+	    bands[n-1].y2 = y;
+	lasty = y;
+	n++;
+    }
+    bands[n-1].y2 = INT_MAX;
+    num_bands = n;
+    rfx_free(ys);
+
+    parallel_for(num_bands, band_worker, bands, num_bands);
+
+    /* sew the bands together. Segments crossing a seam need an edge from
+       the last point they received above the seam to the first point below it */
+    gfxpolystroke_t*seam_strokes = 0;
+    point_t*last = (point_t*)rfx_alloc(sizeof(point_t)*(bands[0].num_out+1));
+    for(t=0;t<bands[0].num_out;t++) {
+	last[t] = bands[0].out[t].p;
+    }
+    for(t=1;t<num_bands;t++) {
+	band_t*band = &bands[t];
+	if(!band_seam_ok(&bands[t-1], band)) {
+	    /* the reconstructed active list didn't match. Start over,
+	       from what the band above left behind */
+	    band_free(band);
+	    strokes_destroy(band->strokes);
+	    band->num_in = bands[t-1].num_out;
+	    band->in = (bandseg_t*)rfx_alloc(sizeof(bandseg_t)*(band->num_in?band->num_in:1));
+	    memcpy(band->in, bands[t-1].out, sizeof(bandseg_t)*band->num_in);
+	    int s;
+	    for(s=0;s<band->num_in;s++) {
+		band->in[s].has_point = 0;
+	    }
+	    band_sweep(band, 0);
+	}
+	int s;
+	for(s=0;s<band->num_in;s++) {
+	    bandseg_t*b = &band->in[s];
+	    if(b->has_point && b->p_fs) {
+		gfxpolystroke_t*stroke = (gfxpolystroke_t*)rfx_calloc(sizeof(gfxpolystroke_t));
+		stroke->dir = b->p_dir;
+		stroke->fs = b->p_fs;
+		stroke->num_points = stroke->points_size = 2;
+		stroke->points = (point_t*)rfx_alloc(sizeof(point_t)*2);
+		stroke->points[0] = last[s];
+		stroke->points[1] = b->p;
+		stroke->next = seam_strokes;
+		seam_strokes = stroke;
+	    }
+	}
+	point_t*next = (point_t*)rfx_alloc(sizeof(point_t)*(band->num_out+1));
+	for(s=0;s<band->num_out;s++) {
+	    bandseg_t*b = &band->out[s];
+	    next[s] = b->has_point ? b->p : last[b->from];
+	}
+	rfx_free(last);
+	last = next;
+	band_free(&bands[t-1]);
+    }
+    rfx_free(last);
+    band_free(&bands[num_bands-1]);
+    sweepmem_t*mem = sweepmem_get();
+    for(t=0;t<num_bands;t++) {
+	mem->events_processed += bands[t].num_events;
+    }
+
+    gfxpolystroke_t*strokes = seam_strokes;
+    for(t=num_bands-1;t>=0;t--) {
+	gfxpolystroke_t*stroke = bands[t].strokes;
+	if(!stroke)
+	    continue;
+	while(stroke->next)
+	    stroke = stroke->next;
+	stroke->next = strokes;
+	strokes = bands[t].strokes;
+    }
+    rfx_free(bands);
+    return gfxpoly_new_from_strokes(poly1->gridsize, strokes);
+}
+
+gfxpoly_t* gfxpoly_process(gfxpoly_t*poly1, gfxpoly_t*poly2, windrule_t*windrule, windcontext_t*context, moments_t*moments)
+{
+    current_polygon = poly1;
+    if(poly2) {
+	assert(poly1->gridsize == poly2->gridsize);
+    }
+
+    int threads = num_threads ? num_threads : get_num_cpus();
+    if(threads > 1 && !moments) {
+	int size = gfxpoly_size(poly1) + (poly2?gfxpoly_size(poly2):0);
+	if(size >= PARALLEL_MIN_SEGMENTS)
+	    return gfxpoly_process_parallel(poly1, poly2, windrule, context, threads);
+    }
+
+    status_t status;
+    status_init(&status, poly1->gridsize, windrule, context);
+
+    gfxpoly_enqueue(&status, poly1, 0, /*polygon nr*/0);
+    if(poly2) {
+	gfxpoly_enqueue(&status, poly2, 0, /*polygon nr*/1);
+    }
+
+    sweep(&status, INT_MAX, moments);
+    assert(!actlist_size(status.actlist));
+
+    gfxpolystroke_t*strokes = status.strokes;
+    status.mem->events_processed += status.num_events;
+    status_finish(&status);
+    return gfxpoly_new_from_strokes(poly1->gridsize, strokes);
+}
+
 static windcontext_t onepolygon = {1};
 static windcontext_t twopolygons = {2};
 gfxpoly_t* gfxpoly_intersect(gfxpoly_t*p1, gfxpoly_t*p2)
@@ -1616,6 +2240,37 @@ gfxpoly_t* gfxpoly_union(gfxpoly_t*p1, gfxpoly_t*p2)
 {
     return gfxpoly_process(p1, p2, &windrule_union, &twopolygons, 0);
 }
+gfxpoly_t* gfxpoly_union_many(gfxpoly_t**polys, int num)
+{
+    if(!num)
+	return 0;
+
+    /* Bring every polygon into normal form first. In the result of an
+       even/odd sweep, edges are oriented such that the winding number is
+       1 inside and 0 outside, so after concatenating all of them, the
+       winding number of a point is the number of polygons containing it.
+       One circular (non-zero) sweep over everything then yields the union. */
+    gfxpolystroke_t*strokes = 0;
+    int t;
+    for(t=num-1;t>=0;t--) {
+	gfxpoly_t*p = gfxpoly_process(polys[t], 0, &windrule_evenodd, &onepolygon, 0);
+	if(num==1)
+	    return p;
+	gfxpolystroke_t*stroke = p->strokes;
+	if(stroke) {
+	    while(stroke->next)
+		stroke = stroke->next;
+	    stroke->next = strokes;
+	    strokes = p->strokes;
+	}
+	p->strokes = 0;
+	gfxpoly_destroy(p);
+    }
+    gfxpoly_t*all = gfxpoly_new_from_strokes(polys[0]->gridsize, strokes);
+    gfxpoly_t*result = gfxpoly_process(all, 0, &windrule_circular, &onepolygon, 0);
+    gfxpoly_destroy(all);
+    return result;
+}
 double gfxpoly_area(gfxpoly_t*p)
 {
     moments_t moments;
@@ -6,10 +6,6 @@
 #include "../types.h"
 #include "wind.h"
 
-/* features */
-#define SPLAY
-#define DONT_REMEMBER_CROSSINGS
-
 typedef enum {EVENT_CROSS, EVENT_END, EVENT_START, EVENT_HORIZONTAL} eventtype_t;
 typedef enum {SLOPE_POSITIVE, SLOPE_NEGATIVE} slope_t;
 
@@ -53,11 +49,9 @@ typedef struct _segment {
     windstate_t wind;
     ptroff_t nr;
 
-#ifdef SPLAY
     struct _segment*parent;
     struct _segment*leftchild;
     struct _segment*rightchild;
-#endif
     struct _segment*left;
     struct _segment*right;
     char changed;
@@ -67,9 +61,12 @@ typedef struct _segment {
     gfxpolystroke_t*stroke;
     int stroke_pos;
 
-#ifndef DONT_REMEMBER_CROSSINGS
-    dict_t scheduled_crossings;
-#endif
+    /* right neighbor we have a crossing event in the queue with */
+    struct _segment*crossing_right;
+
+    /* parallel sweep: index (+1) into the band's seam array, as long as
+       this segment hasn't received a point in the current band */
+    int seam;
 } segment_t;
 
 typedef struct _moments {
@@ -102,9 +99,12 @@ void gfxpoly_dump(gfxpoly_t*poly);
 void gfxpoly_save(gfxpoly_t*poly, const char*filename);
 void gfxpoly_save_arrows(gfxpoly_t*poly, const char*filename);
 gfxpoly_t* gfxpoly_process(gfxpoly_t*poly1, gfxpoly_t*poly2, windrule_t*windrule, windcontext_t*context, moments_t*moments);
+void gfxpoly_set_num_threads(int num);
+uint64_t gfxpoly_events_processed();
 
 gfxpoly_t* gfxpoly_intersect(gfxpoly_t*p1, gfxpoly_t*p2);
 gfxpoly_t* gfxpoly_union(gfxpoly_t*p1, gfxpoly_t*p2);
+gfxpoly_t* gfxpoly_union_many(gfxpoly_t**polys, int num);
 double gfxpoly_area(gfxpoly_t*p);
 double gfxpoly_intersection_area(gfxpoly_t*p1, gfxpoly_t*p2);
 
@@ -3,7 +3,9 @@
 #include <memory.h>
 #include <math.h>
 #include <sys/times.h>
+#include <sys/time.h>
 #include "../gfxtools.h"
+#include "../os.h"
 #include "poly.h"
 #include "convert.h"
 #include "renderpoly.h"
@@ -139,12 +141,166 @@ int test_speed()
     gfxline_free(b);
 }
 
+/* lots of long, thin, slanted stripes, most of which are active at the
+   same time- this stresses the active list */
+int test_hatching()
+{
+    int num = 5000;
+    /* all stripes in one block, so that gfxline_free() frees them in one go */
+    gfxline_t*b = malloc(sizeof(gfxline_t)*5*num);
+    int t;
+    for(t=0;t<num;t++) {
+        /* parallel, so they never intersect, but with staggered start and end points */
+        double y1 = (t*37)%500;
+        double y2 = 1000+(t*53)%500;
+        double x = t*0.5;
+        gfxline_t*l = &b[t*5];
+        l[0].type = gfx_moveTo;l[0].next = &l[1];
+        l[1].type = gfx_lineTo;l[1].next = &l[2];
+        l[2].type = gfx_lineTo;l[2].next = &l[3];
+        l[3].type = gfx_lineTo;l[3].next = &l[4];
+        l[4].type = gfx_lineTo;l[4].next = t<num-1 ? &l[5] : 0;
+        l[0].x = x+y1/20;      l[0].y = y1;
+        l[1].x = x+y1/20+0.25; l[1].y = y1;
+        l[2].x = x+y2/20+0.25; l[2].y = y2;
+        l[3].x = x+y2/20;      l[3].y = y2;
+        l[4].x = x+y1/20;      l[4].y = y1;
+    }
+    gfxpoly_t*poly = gfxpoly_from_fill(b, 0.05);
+    gfxpoly_t*poly2 = gfxpoly_process(poly, 0, &windrule_evenodd, &onepolygon, 0);
+    gfxpoly_destroy(poly);
+    gfxpoly_destroy(poly2);
+    gfxline_free(b);
+}
+
+static int compare_edges(const void*_e1, const void*_e2)
+{
+    const int32_t*e1 = _e1;
+    const int32_t*e2 = _e2;
+    int t;
+    for(t=0;t<5;t++) {
+	if(e1[t] != e2[t])
+	    return e1[t] < e2[t] ? -1 : 1;
+    }
+    return 0;
+}
+
+/* all edges of a polygon, sorted, as (x1,y1,x2,y2,dir) */
+static int32_t* get_edges(gfxpoly_t*poly, int*num)
+{
+    int n = gfxpoly_size(poly), i = 0;
+    int32_t*e = malloc(sizeof(int32_t)*5*(n+1));
+    gfxpolystroke_t*stroke;
+    for(stroke=poly->strokes;stroke;stroke=stroke->next) {
+	int t;
+	for(t=0;t<stroke->num_points-1;t++) {
+	    e[i*5+0] = stroke->points[t].x;
+	    e[i*5+1] = stroke->points[t].y;
+	    e[i*5+2] = stroke->points[t+1].x;
+	    e[i*5+3] = stroke->points[t+1].y;
+	    e[i*5+4] = stroke->dir;
+	    i++;
+	}
+    }
+    qsort(e, n, sizeof(int32_t)*5, compare_edges);
+    *num = n;
+    return e;
+}
+
+static int milliseconds()
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec*1000 + tv.tv_usec/1000;
+}
+
+/* sweep a big polygon both serially and in parallel bands, and make sure the
+   results are the same */
+int test_parallel(int threads)
+{
+    gfxline_t* b = mkchessboard();
+    b = make_circles(b, 400);
+    gfxpoly_t*poly = gfxpoly_from_fill(b, 0.05);
+
+    gfxpoly_set_num_threads(1);
+    int t1 = milliseconds();
+    gfxpoly_t*poly1 = gfxpoly_process(poly, 0, &windrule_evenodd, &onepolygon, 0);
+    int t2 = milliseconds();
+    gfxpoly_set_num_threads(threads);
+    gfxpoly_t*poly2 = gfxpoly_process(poly, 0, &windrule_evenodd, &onepolygon, 0);
+    int t3 = milliseconds();
+
+    int num1, num2;
+    int32_t*e1 = get_edges(poly1, &num1);
+    int32_t*e2 = get_edges(poly2, &num2);
+    char ok = num1 == num2 && !memcmp(e1, e2, sizeof(int32_t)*5*num1);
+    printf("parallel (%d threads): serial %dms, parallel %dms%s\n", threads, t2-t1, t3-t2, ok?"":", RESULTS DIFFER");
+    free(e1);
+    free(e2);
+
+    gfxpoly_destroy(poly);
+    gfxpoly_destroy(poly1);
+    gfxpoly_destroy(poly2);
+    gfxline_free(b);
+    return ok;
+}
+
+/* union a few hundred circles, once pairwise and once in a single sweep */
+int test_union_many()
+{
+    int num = 300, t;
+    gfxpoly_t**polys = (gfxpoly_t**)malloc(sizeof(gfxpoly_t*)*num);
+    unsigned int c = 0;
+    for(t=0;t<num;t++) {
+	c = crc32_add_byte(c, t);
+	int x = c%1000;
+	c = crc32_add_byte(c, t);
+	int y = c%1000;
+	gfxline_t*l = gfxline_makecircle(x,y,30,30);
+	polys[t] = gfxpoly_from_fill(l, 0.05);
+	gfxline_free(l);
+    }
+
+    int t1 = milliseconds();
+    gfxpoly_t*poly1 = gfxpoly_process(polys[0], 0, &windrule_evenodd, &onepolygon, 0);
+    for(t=1;t<num;t++) {
+	gfxpoly_t*old = poly1;
+	poly1 = gfxpoly_union(poly1, polys[t]);
+	gfxpoly_destroy(old);
+    }
+    int t2 = milliseconds();
+    gfxpoly_t*poly2 = gfxpoly_union_many(polys, num);
+    int t3 = milliseconds();
+
+    double a1 = gfxpoly_area(poly1);
+    double a2 = gfxpoly_area(poly2);
+    char ok = fabs(a1-a2) < a1*0.001;
+    printf("union of %d polygons: pairwise %dms, union_many %dms%s\n", num, t2-t1, t3-t2, ok?"":", RESULTS DIFFER");
+
+    for(t=0;t<num;t++)
+	gfxpoly_destroy(polys[t]);
+    free(polys);
+    gfxpoly_destroy(poly1);
+    gfxpoly_destroy(poly2);
+    return ok;
+}
+
 int main(int argn, char*argv[])
 {
     struct tms t1,t2;
     times(&t1);
     test_speed();
     times(&t2);
-    printf("%d\n", t2.tms_utime - t1.tms_utime);
+    printf("chessboard: %d\n", t2.tms_utime - t1.tms_utime);
+    times(&t1);
+    test_hatching();
+    times(&t2);
+    printf("hatching: %d\n", t2.tms_utime - t1.tms_utime);
+
+    int threads = argn>1 ? atoi(argv[1]) : get_num_cpus();
+    if(threads < 2)
+	threads = 2;
+    test_parallel(threads);
+    test_union_many();
 }
 
@@ -28,6 +28,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include "gfxtools.h"
+#include "pixelops/pixelops.h"
 #include "gfxfont.h"
 #include "jpeg.h"
 #include "q.h"
@@ -133,6 +134,66 @@ void gfxdrawer_target_gfxline(gfxdrawer_t*d)
     d->result = linedraw_result;
 }
 
+static void pathdraw_moveTo(gfxdrawer_t*d, gfxcoord_t x, gfxcoord_t y)
+{
+    gfxpath_moveTo((gfxpath_t*)d->internal, x, y);
+    d->x = x;
+    d->y = y;
+}
+static void pathdraw_lineTo(gfxdrawer_t*d, gfxcoord_t x, gfxcoord_t y)
+{
+    gfxpath_t*path = (gfxpath_t*)d->internal;
+    if(!path->num) {
+	/* see linedraw_lineTo */
+	pathdraw_moveTo(d, x, y);
+	return;
+    }
+    gfxpath_lineTo(path, x, y);
+    d->x = x;
+    d->y = y;
+}
+static void pathdraw_splineTo(gfxdrawer_t*d, gfxcoord_t sx, gfxcoord_t sy, gfxcoord_t x, gfxcoord_t y)
+{
+    gfxpath_t*path = (gfxpath_t*)d->internal;
+    if(!path->num) {
+	pathdraw_moveTo(d, x, y);
+	return;
+    }
+    gfxpath_splineTo(path, sx, sy, x, y);
+    d->x = x;
+    d->y = y;
+}
+static void pathdraw_close(gfxdrawer_t*d)
+{
+    gfxpath_t*path = (gfxpath_t*)d->internal;
+    int t;
+    for(t=path->num-1;t>=0;t--) {
+	if(path->types[t] == gfx_moveTo) {
+	    if(t < path->num-1)
+		pathdraw_lineTo(d, path->points[t].x, path->points[t].y);
+	    break;
+	}
+    }
+}
+static void* pathdraw_result(gfxdrawer_t*d)
+{
+    void*result = d->internal;
+    memset(d, 0, sizeof(gfxdrawer_t));
+    return result;
+}
+
+void gfxdrawer_target_gfxpath(gfxdrawer_t*d)
+{
+    d->x = 0x7fffffff;
+    d->y = 0x7fffffff;
+    d->internal = gfxpath_new(0);
+    d->moveTo = pathdraw_moveTo;
+    d->lineTo = pathdraw_lineTo;
+    d->splineTo = pathdraw_splineTo;
+    d->close = pathdraw_close;
+    d->result = pathdraw_result;
+}
+
 typedef struct _qspline_abc
 {
     double ax,bx,cx;
@@ -807,6 +868,141 @@ void gfxline_transform(gfxline_t*line, gfxmatrix_t*matrix)
     }
 }
 
+gfxpath_t* gfxpath_new(int size)
+{
+    gfxpath_t*path = (gfxpath_t*)rfx_calloc(sizeof(gfxpath_t));
+    if(size < 8)
+	size = 8;
+    path->size = size;
+    path->types = (unsigned char*)rfx_alloc(size);
+    path->points = (gfxpoint_t*)rfx_alloc(sizeof(gfxpoint_t)*size);
+    path->controls = (gfxpoint_t*)rfx_alloc(sizeof(gfxpoint_t)*size);
+    return path;
+}
+
+void gfxpath_free(gfxpath_t*path)
+{
+    rfx_free(path->types);
+    rfx_free(path->points);
+    rfx_free(path->controls);
+    memset(path, 0, sizeof(gfxpath_t));
+    rfx_free(path);
+}
+
+static inline void gfxpath_add(gfxpath_t*path, gfx_linetype type, gfxcoord_t sx, gfxcoord_t sy, gfxcoord_t x, gfxcoord_t y)
+{
+    if(path->num == path->size) {
+	path->size *= 2;
+	path->types = (unsigned char*)rfx_realloc(path->types, path->size);
+	path->points = (gfxpoint_t*)rfx_realloc(path->points, sizeof(gfxpoint_t)*path->size);
+	path->controls = (gfxpoint_t*)rfx_realloc(path->controls, sizeof(gfxpoint_t)*path->size);
+    }
+    int t = path->num++;
+    path->types[t] = type;
+    path->points[t].x = x;
+    path->points[t].y = y;
+    path->controls[t].x = sx;
+    path->controls[t].y = sy;
+}
+void gfxpath_moveTo(gfxpath_t*path, gfxcoord_t x, gfxcoord_t y)
+{
+    gfxpath_add(path, gfx_moveTo, 0, 0, x, y);
+}
+void gfxpath_lineTo(gfxpath_t*path, gfxcoord_t x, gfxcoord_t y)
+{
+    gfxpath_add(path, gfx_lineTo, 0, 0, x, y);
+}
+void gfxpath_splineTo(gfxpath_t*path, gfxcoord_t sx, gfxcoord_t sy, gfxcoord_t x, gfxcoord_t y)
+{
+    gfxpath_add(path, gfx_splineTo, sx, sy, x, y);
+}
+
+gfxpath_t* gfxpath_from_gfxline(gfxline_t*line)
+{
+    int num = 0;
+    gfxline_t*l;
+    for(l=line;l;l=l->next)
+	num++;
+    gfxpath_t*path = gfxpath_new(num);
+    for(l=line;l;l=l->next) {
+	if(l->type == gfx_splineTo)
+	    gfxpath_add(path, gfx_splineTo, l->sx, l->sy, l->x, l->y);
+	else
+	    gfxpath_add(path, l->type, 0, 0, l->x, l->y);
+    }
+    return path;
+}
+
+gfxline_t* gfxline_from_gfxpath(gfxpath_t*path)
+{
+    if(!path->num)
+	return 0;
+    gfxline_t*line = (gfxline_t*)rfx_alloc(sizeof(gfxline_t)*path->num);
+    int t;
+    for(t=0;t<path->num;t++) {
+	line[t].type = path->types[t];
+	line[t].x = path->points[t].x;
+	line[t].y = path->points[t].y;
+	line[t].sx = path->controls[t].x;
+	line[t].sy = path->controls[t].y;
+	line[t].next = &line[t+1];
+    }
+    line[path->num-1].next = 0;
+    return line;
+}
+
+gfxpath_t* gfxpath_clone(gfxpath_t*path)
+{
+    gfxpath_t*c = gfxpath_new(path->num);
+    memcpy(c->types, path->types, path->num);
+    memcpy(c->points, path->points, sizeof(gfxpoint_t)*path->num);
+    memcpy(c->controls, path->controls, sizeof(gfxpoint_t)*path->num);
+    c->num = path->num;
+    return c;
+}
+
+void gfxpath_transform(gfxpath_t*path, gfxmatrix_t*m)
+{
+    int t;
+    gfxpoint_t*p = path->points;
+    for(t=0;t<path->num;t++) {
+	double x = m->m00*p[t].x + m->m10*p[t].y + m->tx;
+	double y = m->m01*p[t].x + m->m11*p[t].y + m->ty;
+	p[t].x = x;
+	p[t].y = y;
+    }
+    p = path->controls;
+    for(t=0;t<path->num;t++) {
+	if(path->types[t] == gfx_splineTo) {
+	    double x = m->m00*p[t].x + m->m10*p[t].y + m->tx;
+	    double y = m->m01*p[t].x + m->m11*p[t].y + m->ty;
+	    p[t].x = x;
+	    p[t].y = y;
+	}
+    }
+}
+
+/* same as gfxline_getbbox */
+gfxbbox_t gfxpath_getbbox(gfxpath_t*path)
+{
+    gfxbbox_t bbox = {0,0,0,0};
+    char last = 0;
+    int t;
+    for(t=0;t<path->num;t++) {
+	if(path->types[t] == gfx_moveTo) {
+	    last = 1;
+	    continue;
+	}
+	if(last)
+	    bbox = gfxbbox_expand_to_point(bbox, path->points[t-1].x, path->points[t-1].y);
+	if(path->types[t] == gfx_splineTo)
+	    bbox = gfxbbox_expand_to_point(bbox, path->controls[t].x, path->controls[t].y);
+	bbox = gfxbbox_expand_to_point(bbox, path->points[t].x, path->points[t].y);
+	last = 0;
+    }
+    return bbox;
+}
+
 void gfxmatrix_dump(gfxmatrix_t*m, FILE*fi, char*prefix)
 {
     fprintf(fi, "%s%f %f | %f\n", prefix, m->m00, m->m10, m->tx);
@@ -983,6 +1179,7 @@ gfxbbox_t* gfxline_isrectangle(gfxline_t*_l)
         return 0;
 
     gfxline_t*l = gfxline_clone(_l);
+    gfxline_t*first = l;
     gfxline_optimize(l);
 
     double x1=0,x2=0,y1=0,y2=0;
@@ -995,6 +1192,11 @@ gfxbbox_t* gfxline_isrectangle(gfxline_t*_l)
         double x = l->x;
         double y = l->y;
 
+        if(l->type == gfx_splineTo) {
+            /* curved edges, even if they connect corners */
+            fail=1;break;
+        }
+
         char top=0,left=0;
 
         if(xc==2 && x!=x1 && x!=x2) {fail=1;break;}
@@ -1026,8 +1228,8 @@ gfxbbox_t* gfxline_isrectangle(gfxline_t*_l)
         /* mark which corners have been touched so far */
         corners |= 1<<pos;
     }
+    gfxline_free(first);
     if(fail) {
-        gfxline_free(l);
         return 0;
     }
 
@@ -1044,33 +1246,14 @@ gfxbbox_t* gfxline_isrectangle(gfxline_t*_l)
 
 void gfximage_transform(gfximage_t*img, gfxcxform_t*cxform)
 {
-    int t;
-    int size = img->width*img->height;
-
-    int rr,rg,rb,ra, tr;
-    int gr,gg,gb,ga, tg;
-    int br,bg,bb,ba, tb;
-    int ar,ag,ab,aa, ta;
-    rr = (int)(cxform->rr*256);gr = (int)(cxform->gr*256);
-    rg = (int)(cxform->rg*256);gg = (int)(cxform->gg*256);
-    rb = (int)(cxform->rb*256);gb = (int)(cxform->gb*256);
-    ra = (int)(cxform->ra*256);ga = (int)(cxform->ga*256);
-    br = (int)(cxform->br*256);ar = (int)(cxform->ar*256);tr = (int)(cxform->tr*256);
-    bg = (int)(cxform->bg*256);ag = (int)(cxform->ag*256);tg = (int)(cxform->tg*256);
-    bb = (int)(cxform->bb*256);ab = (int)(cxform->ab*256);tb = (int)(cxform->tb*256);
-    ba = (int)(cxform->ba*256);aa = (int)(cxform->aa*256);ta = (int)(cxform->ta*256);
-
-    for(t=0;t<size;t++) {
-	gfxcolor_t*pixel = &img->data[t];
-	unsigned char r = (pixel->r * rr + pixel->g * rg + pixel->b * rb + pixel->a * ra + tr) / 256;
-	unsigned char g = (pixel->r * gr + pixel->g * gg + pixel->b * gb + pixel->a * ga + tg) / 256;
-	unsigned char b = (pixel->r * br + pixel->g * bg + pixel->b * bb + pixel->a * ba + tb) / 256;
-	unsigned char a = (pixel->r * ar + pixel->g * ag + pixel->b * ab + pixel->a * aa + ta) / 256;
-	pixel->r = r;
-	pixel->g = g;
-	pixel->b = b;
-	pixel->a = a;
-    }
+    /* one row (factors for a,r,g,b, then the offset) per output channel */
+    int m[20] = {
+	(int)(cxform->aa*256), (int)(cxform->ar*256), (int)(cxform->ag*256), (int)(cxform->ab*256), (int)(cxform->ta*256),
+	(int)(cxform->ra*256), (int)(cxform->rr*256), (int)(cxform->rg*256), (int)(cxform->rb*256), (int)(cxform->tr*256),
+	(int)(cxform->ga*256), (int)(cxform->gr*256), (int)(cxform->gg*256), (int)(cxform->gb*256), (int)(cxform->tg*256),
+	(int)(cxform->ba*256), (int)(cxform->br*256), (int)(cxform->bg*256), (int)(cxform->bb*256), (int)(cxform->tb*256),
+    };
+    pixelops_cxform(img->data, img->width*img->height, m);
 }
 void gfxline_dump(gfxline_t*line, FILE*fi, char*prefix)
 {
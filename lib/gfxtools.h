@@ -47,6 +47,18 @@ typedef struct _gfxpoint
     gfxcoord_t x,y;
 } gfxpoint_t;
 
+/* a path, like gfxline_t, but stored in arrays instead of a linked list.
+   Entry t has the type types[t] and the end point points[t]. For splines,
+   controls[t] is the control point (it's zero for all other entries) */
+typedef struct _gfxpath
+{
+    unsigned char*types;
+    gfxpoint_t*points;
+    gfxpoint_t*controls;
+    int num;
+    int size;
+} gfxpath_t;
+
 typedef struct _gfxfontlist
 {
     gfxfont_t*font;
@@ -55,6 +67,7 @@ typedef struct _gfxfontlist
 } gfxfontlist_t;
 
 void gfxdrawer_target_gfxline(gfxdrawer_t*d);
+void gfxdrawer_target_gfxpath(gfxdrawer_t*d);
 
 void gfxtool_draw_dashed_line(gfxdrawer_t*d, gfxline_t*line, float*dashes, float phase);
 gfxline_t* gfxtool_dash_line(gfxline_t*line, float*dashes, float phase);
@@ -121,6 +134,18 @@ void gfxline_normalize(gfxline_t*line, double sizex, double sizey);
 
 gfxbbox_t gfxbbox_transform(gfxbbox_t*bbox, gfxmatrix_t*m);
 
+gfxpath_t* gfxpath_new(int size);
+void gfxpath_free(gfxpath_t*path);
+void gfxpath_moveTo(gfxpath_t*path, gfxcoord_t x, gfxcoord_t y);
+void gfxpath_lineTo(gfxpath_t*path, gfxcoord_t x, gfxcoord_t y);
+void gfxpath_splineTo(gfxpath_t*path, gfxcoord_t sx, gfxcoord_t sy, gfxcoord_t x, gfxcoord_t y);
+gfxpath_t* gfxpath_from_gfxline(gfxline_t*line);
+/* returns a gfxline in a single memory block (gfxline_free() knows how to free it) */
+gfxline_t* gfxline_from_gfxpath(gfxpath_t*path);
+gfxpath_t* gfxpath_clone(gfxpath_t*path);
+void gfxpath_transform(gfxpath_t*path, gfxmatrix_t*matrix);
+gfxbbox_t gfxpath_getbbox(gfxpath_t*path);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,7 @@
 #include <assert.h>
 #include <math.h>
 #include "../rfxswf.h"
+#include "../pixelops/pixelops.h"
 #include "h263tables.h"
 #include "dct.h"
 
@@ -241,23 +242,9 @@ static void getmvdregion(block_t* bb, YUV*pic, int posx, int posy, int mvdx, int
 
 static void rgb2yuv(YUV*dest, RGBA*src, int dlinex, int slinex, int width, int height)
 {
-    int x,y;
+    int y;
     for(y=0;y<height;y++) {
-	for(x=0;x<width;x++) {
-	    int r,g,b;
-	    r = src[y*slinex+x].r;
-	    g = src[y*slinex+x].g;
-	    b = src[y*slinex+x].b;
-	    /*dest[y*dlinex+x].y = (r*0.299 + g*0.587 + b*0.114);
-	    dest[y*dlinex+x].u = (r*-0.169 + g*-0.332 + b*0.500 + 128.0);
-	    dest[y*dlinex+x].v = (r*0.500 + g*-0.419 + b*-0.0813 + 128.0);*/
-
-	    //dest[y*dlinex+x].y = 128;//(r*((int)( 0.299*256)) + g*((int)( 0.587*256)) + b*((int)( 0.114 *256)))>>8;
-
-	    dest[y*dlinex+x].y = (r*((int)( 0.299*256)) + g*((int)( 0.587*256)) + b*((int)( 0.114 *256)))>>8;
-	    dest[y*dlinex+x].u = (r*((int)(-0.169*256)) + g*((int)(-0.332*256)) + b*((int)( 0.500 *256))+ 128*256)>>8;
-	    dest[y*dlinex+x].v = (r*((int)( 0.500*256)) + g*((int)(-0.419*256)) + b*((int)(-0.0813*256))+ 128*256)>>8;
-	}
+	pixelops_argb_to_yuv(&dest[y*dlinex], &src[y*slinex], width);
     }
 }
 
@@ -274,17 +261,9 @@ static void copyregion(VIDEOSTREAM*s, YUV*dest, YUV*src, int bx, int by)
 
 static void yuv2rgb(RGBA*dest, YUV*src, int linex, int width, int height)
 {
-    int x,y;
+    int y;
     for(y=0;y<height;y++) {
-	for(x=0;x<width;x++) {
-	    int u,v,yy;
-	    u = src[y*linex+x].u;
-	    v = src[y*linex+x].v;
-	    yy = src[y*linex+x].y;
-	    dest[y*linex+x].r = truncate256(yy + ((360*(v-128))>>8));
-	    dest[y*linex+x].g = truncate256(yy - ((88*(u-128)+183*(v-128))>>8));
-	    dest[y*linex+x].b = truncate256(yy + ((455 * (u-128))>>8));
-	}
+	pixelops_yuv_to_argb(&dest[y*linex], &src[y*linex], width);
     }
 }
 static void copy_block_pic(VIDEOSTREAM*s, YUV*dest, block_t*b, int bx, int by)
@@ -44,21 +44,14 @@ extern "C" {
 #endif // HAVE_JPEGLIB
 
 #include "../rfxswf.h"
+#include "../pixelops/pixelops.h"
+#include "../os.h"
 
 #define OUTBUFFER_SIZE 0x8000
 
 int swf_ImageHasAlpha(RGBA*img, int width, int height)
 {
-    int len = width*height;
-    int t;
-    int hasalpha=0;
-    for(t=0;t<len;t++) {
-	if(img[t].a >= 4 && img[t].a < 0xfc)
-	    return 2;
-	if(img[t].a < 4)
-	    hasalpha=1;
-    }
-    return hasalpha;
+    return pixelops_has_alpha(img, width*height);
 }
 
 /*int swf_ImageGetNumberOfPaletteEntries(RGBA*img, int width, int height, RGBA*palette)
@@ -102,70 +95,414 @@ int swf_ImageHasAlpha(RGBA*img, int width, int height)
     return palsize;
 }*/
 
-int swf_ImageGetNumberOfPaletteEntries(RGBA*img, int width, int height, RGBA*palette)
+/* position of a color in the palette. This used to be the bucket of
+   the color in the lookup table, and is kept so that the palettes (and
+   hence the SWF files) don't change. */
+static inline int palette_bucket(U32 col32)
 {
-    int len = width*height;
-    int t;
-    int palsize = 0;
-    U32* pal;
-    int size[256];
-    int palette_overflow = 0;
-    U32 lastcol32 = 0;
+    U32 hash = (col32 >> 17) ^ col32;
+    hash ^= ((hash>>8) + 1) ^ hash;
+    return hash & 255;
+}
+
+/* number of pixels (at most n) starting at p which have color col32.
+   Compares two pixels at a time. */
+static inline int color_run(const U32*p, int n, U32 col32)
+{
+    U64 col64 = (U64)col32<<32 | col32;
+    int t = 0;
+    while(t+2 <= n) {
+	U64 two;
+	memcpy(&two, &p[t], 8);
+	if(two != col64)
+	    break;
+	t += 2;
+    }
+    if(t < n && p[t] == col32)
+	t++;
+    return t;
+}
+
+#define COLORMAP_SIZE 1024 // power of two, at least 4*256
+
+/* incremental color scan, so that images can also be passed one row
+   at a time (see swf_SetLosslessImageRows) */
+typedef struct _palscan {
+    U32 keys[COLORMAP_SIZE];
+    U16 slots[COLORMAP_SIZE]; // palette index+1, 0 = empty
+    U32 pal[256]; // in order of first appearance
+    int palsize;
+    U32 lastcol32;
+    int lastindex;
+} palscan_t;
+
+static void palscan_init(palscan_t*scan, U32 firstcol32)
+{
+    memset(scan->slots, 0, sizeof(scan->slots));
+    scan->palsize = 0;
+    scan->lastcol32 = firstcol32^0xffffffff; // don't match
+    scan->lastindex = 0;
+}
 
-    pal = (U32*)malloc(65536*sizeof(U32));
+/* stores the (unsorted) palette index of every pixel in dest, if set.
+   Returns 0 if the row contains a 257th color. */
+static int palscan_row(palscan_t*scan, const U32*src, int width, U8*dest)
+{
+    int x = 0;
+    while(x<width) {
+	U32 col32 = src[x];
+	if(col32 == scan->lastcol32) {
+	    int len = color_run(&src[x], width-x, col32);
+	    if(dest)
+		memset(&dest[x], scan->lastindex, len);
+	    x += len;
+	    continue;
+	}
+	U32 h = col32 ^ (col32 >> 16);
+	h *= 0x85ebca6b;
+	h = (h ^ (h >> 13)) & (COLORMAP_SIZE-1);
+	while(scan->slots[h] && scan->keys[h] != col32)
+	    h = (h+1)&(COLORMAP_SIZE-1);
+	if(!scan->slots[h]) {
+	    if(scan->palsize==256)
+		return 0;
+	    scan->keys[h] = col32;
+	    scan->pal[scan->palsize++] = col32;
+	    scan->slots[h] = scan->palsize;
+	}
+	scan->lastcol32 = col32;
+	scan->lastindex = scan->slots[h]-1;
+	if(dest)
+	    dest[x] = scan->lastindex;
+	x++;
+    }
+    return 1;
+}
 
-    memset(size, 0, sizeof(size));
+/* sorts the palette by bucket, keeping the order of first appearance
+   within each bucket, and remaps the indices accordingly */
+static int palscan_finish(palscan_t*scan, RGBA*palette, U8*indices, int width, int height, int bpl)
+{
+    U8 remap[256];
+    int count[257];
+    int x, y, t;
+    memset(count, 0, sizeof(count));
+    for(t=0;t<scan->palsize;t++)
+	count[palette_bucket(scan->pal[t])+1]++;
+    for(t=0;t<256;t++)
+	count[t+1] += count[t];
+    char identity = 1;
+    for(t=0;t<scan->palsize;t++) {
+	int pos = count[palette_bucket(scan->pal[t])]++;
+	remap[t] = pos;
+	if(palette)
+	    palette[pos] = *(RGBA*)&scan->pal[t];
+	if(pos != t)
+	    identity = 0;
+    }
+    if(indices && !identity) {
+	for(y=0;y<height;y++) {
+	    U8*dest = &indices[y*bpl];
+	    for(x=0;x<width;x++)
+		dest[x] = remap[dest[x]];
+	}
+    }
+    return scan->palsize;
+}
+
+/* Collects the colors of an image in a single pass. Returns the number
+   of colors, or width*height if there are more than 256 (the scan stops
+   at the 257th color). If palette is set, the colors are stored there.
+   If indices is set, it receives the palette index of every pixel, with
+   bpl bytes per line. */
+int swf_ImageGetPalette(RGBA*img, int width, int height, RGBA*palette, U8*indices, int bpl)
+{
+    palscan_t scan;
+    int y;
 
     if(sizeof(RGBA)!=sizeof(U32))
 	fprintf(stderr, "rfxswf: sizeof(RGBA)!=sizeof(U32))");
+    if(width<=0 || height<=0)
+	return 0;
+
+    palscan_init(&scan, *(U32*)&img[0]);
+    for(y=0;y<height;y++) {
+	if(!palscan_row(&scan, (U32*)&img[y*width], width, indices ? &indices[y*bpl] : 0))
+	    return width*height;
+    }
 
-    lastcol32 = (*(U32*)&img[0])^0xffffffff; // don't match
+    if(!palette && !indices)
+	return scan.palsize;
+    return palscan_finish(&scan, palette, indices, width, height, bpl);
+}
 
-    for(t=0;t<len;t++) {
-	RGBA col = img[t];
-	U32 col32 = *(U32*)&img[t];
-	int i;
-	int csize;
-	U32 hash;
-	U32* cpal;
-	if(col32 == lastcol32)
-	    continue;
-	hash = (col32 >> 17) ^ col32;
-	hash ^= ((hash>>8) + 1) ^ hash;
-	hash &= 255;
-
-	csize = size[hash];
-	cpal = &pal[hash*256];
-	for(i=0;i<csize;i++) {
-	    if(col32 == cpal[i])
-		break;
+int swf_ImageGetNumberOfPaletteEntries(RGBA*img, int width, int height, RGBA*palette)
+{
+    return swf_ImageGetPalette(img, width, height, palette, 0, 0);
+}
+
+/* ------------------------------ quantization ------------------------------ */
+
+/* Colors are counted in bins of 5 bits per color channel and 16 alpha
+   levels, with fully transparent and fully opaque pixels in bins of
+   their own. Median cut splits the bins into boxes, and every box becomes
+   one palette entry (the average of its pixels). */
+#define QBINS (1<<19)
+
+static inline int quant_bin(int a, int r, int g, int b)
+{
+    int alevel = a==0 ? 0 : (a==255 ? 15 : 1+(a*14)/256);
+    return (r>>3)<<14 | (g>>3)<<9 | (b>>3)<<4 | alevel;
+}
+
+typedef struct _qslot {
+    U32 bin;
+    U32 count;
+    int key; // for sorting
+    double sum[4]; // a, r, g, b
+} qslot_t;
+
+typedef struct _qbox {
+    int start, end; // slots
+    U32 count;
+    int channel; // the one with the largest range
+    int range;
+} qbox_t;
+
+/* position of a bin along a channel (0=a, 1=r, 2=g, 3=b), in 8 bit units */
+static inline int quant_bin_pos(U32 bin, int channel)
+{
+    switch(channel) {
+	case 0: return (bin&15)*17;
+	case 1: return (bin>>14&31)<<3;
+	case 2: return (bin>>9&31)<<3;
+	default: return (bin>>4&31)<<3;
+    }
+}
+
+static void quant_box_update(qbox_t*box, qslot_t*slots)
+{
+    int min[4] = {255,255,255,255}, max[4] = {0,0,0,0};
+    int t, c;
+    box->count = 0;
+    for(t=box->start;t<box->end;t++) {
+	box->count += slots[t].count;
+	for(c=0;c<4;c++) {
+	    int v = quant_bin_pos(slots[t].bin, c);
+	    if(v<min[c]) min[c] = v;
+	    if(v>max[c]) max[c] = v;
 	}
-	if(i==csize) {
-	    if(palsize==256) {
-		palette_overflow = 1;
-		break;
+    }
+    box->channel = 0;
+    box->range = -1;
+    for(c=0;c<4;c++) {
+	if(max[c]-min[c] > box->range) {
+	    box->range = max[c]-min[c];
+	    box->channel = c;
+	}
+    }
+}
+
+static int quant_compare_slots(const void*_s1, const void*_s2)
+{
+    const qslot_t*s1 = (const qslot_t*)_s1;
+    const qslot_t*s2 = (const qslot_t*)_s2;
+    return s1->key - s2->key;
+}
+
+/* splits boxes until there are numcolors of them, or none can be split */
+static int quant_median_cut(qslot_t*slots, int numslots, qbox_t*boxes, int numcolors)
+{
+    int numboxes = 1;
+    boxes[0].start = 0;
+    boxes[0].end = numslots;
+    quant_box_update(&boxes[0], slots);
+    while(numboxes < numcolors) {
+	/* split the box with the most pixels times its largest extent */
+	int t, best = -1;
+	double bestscore = 0;
+	for(t=0;t<numboxes;t++) {
+	    double score = (double)boxes[t].count * boxes[t].range;
+	    if(boxes[t].end - boxes[t].start >= 2 && score > bestscore) {
+		bestscore = score;
+		best = t;
 	    }
-	    cpal[size[hash]++] = col32;
-	    palsize++;
 	}
-	lastcol32 = col32;
+	if(best<0)
+	    break;
+	qbox_t*box = &boxes[best];
+	for(t=box->start;t<box->end;t++)
+	    slots[t].key = quant_bin_pos(slots[t].bin, box->channel);
+	qsort(&slots[box->start], box->end - box->start, sizeof(qslot_t), quant_compare_slots);
+	/* split at the median pixel, but leave at least one slot on each side */
+	U32 half = box->count/2;
+	U32 sum = slots[box->start].count;
+	int split = box->start+1;
+	while(split < box->end-1 && sum < half) {
+	    sum += slots[split].count;
+	    split++;
+	}
+	qbox_t*box2 = &boxes[numboxes++];
+	box2->start = split;
+	box2->end = box->end;
+	box->end = split;
+	quant_box_update(box, slots);
+	quant_box_update(box2, slots);
     }
-    if(palette_overflow) {
-	free(pal);
-	return width*height;
+    return numboxes;
+}
+
+static inline int clamp255(int v)
+{
+    return v<0 ? 0 : (v>255 ? 255 : v);
+}
+
+/* maps every pixel to the palette entry of its bin, and returns the
+   summed square error */
+static double quant_map(RGBA*img, int width, int height, U32*binslot, RGBA*palette, U8*indices, int bpl, char*has_alpha)
+{
+    double error = 0;
+    int x, y;
+    for(y=0;y<height;y++) {
+	RGBA*src = &img[y*width];
+	U8*dest = &indices[y*bpl];
+	for(x=0;x<width;x++) {
+	    int i = binslot[quant_bin(src[x].a, src[x].r, src[x].g, src[x].b)];
+	    int da = src[x].a - palette[i].a;
+	    int dr = src[x].r - palette[i].r;
+	    int dg = src[x].g - palette[i].g;
+	    int db = src[x].b - palette[i].b;
+	    error += da*da + dr*dr + dg*dg + db*db;
+	    if(src[x].a != 255)
+		*has_alpha = 1;
+	    dest[x] = i;
+	}
     }
-    if(palette) {
-	int i = 0;
-	for(t=0;t<256;t++) {
-	    int s;
-	    int csize = size[t];
-	    U32* cpal = &pal[t*256];
-	    for(s=0;s<csize;s++)
-		palette[i++] = *(RGBA*)(&cpal[s]);
+    return error;
+}
+
+/* Floyd-Steinberg dithers an opaque image, and returns the summed square
+   error against the original pixels */
+static double quant_dither(RGBA*img, int width, int height, RGBA*palette, int numcolors, U8*indices, int bpl)
+{
+    double error = 0;
+    int t, x, y, c;
+    /* nearest palette entry for the center of a bin, computed on demand */
+    U16*nearest = (U16*)rfx_alloc(QBINS*sizeof(U16));
+    for(t=0;t<QBINS;t++)
+	nearest[t] = 0xffff;
+    /* error of the current and of the next line, with one pixel
+       of padding on each side */
+    int*err = (int*)rfx_calloc((width+2)*3*2*sizeof(int));
+    int*cur = err+3, *next = err+(width+2)*3+3;
+    for(y=0;y<height;y++) {
+	RGBA*src = &img[y*width];
+	U8*dest = &indices[y*bpl];
+	memset(next-3, 0, (width+2)*3*sizeof(int));
+	for(x=0;x<width;x++) {
+	    int r = clamp255(src[x].r + cur[x*3+0]/16);
+	    int g = clamp255(src[x].g + cur[x*3+1]/16);
+	    int b = clamp255(src[x].b + cur[x*3+2]/16);
+	    int bin = quant_bin(255, r, g, b);
+	    if(nearest[bin] == 0xffff) {
+		int cr = (r&~7)+4, cg = (g&~7)+4, cb = (b&~7)+4;
+		int best = 0x7fffffff, i;
+		for(i=0;i<numcolors;i++) {
+		    int dr = cr - palette[i].r, dg = cg - palette[i].g, db = cb - palette[i].b;
+		    int d = dr*dr + dg*dg + db*db;
+		    if(d < best) {
+			best = d;
+			nearest[bin] = i;
+		    }
+		}
+	    }
+	    int i = nearest[bin];
+	    dest[x] = i;
+	    int dr = src[x].r - palette[i].r;
+	    int dg = src[x].g - palette[i].g;
+	    int db = src[x].b - palette[i].b;
+	    error += dr*dr + dg*dg + db*db;
+	    int e[3] = {r - palette[i].r, g - palette[i].g, b - palette[i].b};
+	    for(c=0;c<3;c++) {
+		cur[(x+1)*3+c] += e[c]*7;
+		next[(x-1)*3+c] += e[c]*3;
+		next[x*3+c] += e[c]*5;
+		next[(x+1)*3+c] += e[c];
+	    }
 	}
+	int*tmp = cur; cur = next; next = tmp;
     }
-    free(pal);
-    return palsize;
+    rfx_free(err);
+    rfx_free(nearest);
+    return error;
+}
+
+/* Reduces an image to a palette of at most numcolors colors (median cut).
+   Returns the number of palette entries, or 0 if the root mean square
+   error per channel would be larger than maxerror. If dither is set,
+   opaque images are Floyd-Steinberg dithered, unless the dithered image
+   would exceed maxerror, in which case they are not dithered.
+   indices receives the palette index of every pixel, with bpl bytes
+   per line. */
+int swf_ImageQuantize(RGBA*img, int width, int height, int numcolors, double maxerror, char dither, RGBA*palette, U8*indices, int bpl)
+{
+    int size = width*height;
+    int t, c;
+    if(size<=0 || numcolors<2 || numcolors>256)
+	return 0;
+
+    U32*binslot = (U32*)rfx_calloc(QBINS*sizeof(U32)); // slot+1, 0 = unused
+    int numslots = 0;
+    for(t=0;t<size;t++) {
+	int bin = quant_bin(img[t].a, img[t].r, img[t].g, img[t].b);
+	if(!binslot[bin])
+	    binslot[bin] = ++numslots;
+    }
+    qslot_t*slots = (qslot_t*)rfx_calloc(numslots*sizeof(qslot_t));
+    for(t=0;t<size;t++) {
+	int bin = quant_bin(img[t].a, img[t].r, img[t].g, img[t].b);
+	qslot_t*s = &slots[binslot[bin]-1];
+	s->bin = bin;
+	s->count++;
+	s->sum[0] += img[t].a;
+	s->sum[1] += img[t].r;
+	s->sum[2] += img[t].g;
+	s->sum[3] += img[t].b;
+    }
+
+    qbox_t boxes[256];
+    int numboxes = quant_median_cut(slots, numslots, boxes, numcolors);
+
+    /* the palette, and where every bin goes (the slots were reordered) */
+    for(t=0;t<numboxes;t++) {
+	double sum[4] = {0,0,0,0};
+	int s;
+	for(s=boxes[t].start;s<boxes[t].end;s++) {
+	    for(c=0;c<4;c++)
+		sum[c] += slots[s].sum[c];
+	    binslot[slots[s].bin] = t;
+	}
+	palette[t].a = (U8)(sum[0]/boxes[t].count+0.5);
+	palette[t].r = (U8)(sum[1]/boxes[t].count+0.5);
+	palette[t].g = (U8)(sum[2]/boxes[t].count+0.5);
+	palette[t].b = (U8)(sum[3]/boxes[t].count+0.5);
+    }
+    rfx_free(slots);
+
+    double maxsum = maxerror*maxerror*4*size;
+    char has_alpha = 0;
+    if(quant_map(img, width, height, binslot, palette, indices, bpl, &has_alpha) > maxsum) {
+	rfx_free(binslot);
+	return 0;
+    }
+    /* dithering usually increases the error of single pixels, so it's
+       checked again, against the original pixels */
+    if(dither && !has_alpha &&
+       quant_dither(img, width, height, palette, numboxes, indices, bpl) > maxsum) {
+	quant_map(img, width, height, binslot, palette, indices, bpl, &has_alpha);
+    }
+    rfx_free(binslot);
+    return numboxes;
 }
 
 
@@ -765,23 +1102,11 @@ int swf_SetLosslessBits(TAG * t, U16 width, U16 height, void *bitmap, U8 bitmap_
     return res;
 }
 
-int swf_SetLosslessBitsIndexed(TAG * t, U16 width, U16 height, U8 * bitmap, RGBA * palette, U16 ncolors)
+/* writes the header of a BMF_8BIT image, and starts the zlib stream
+   with the palette */
+static int lossless_indexed_start(TAG * t, U16 width, U16 height, RGBA * pal, U16 ncolors, z_stream * zs)
 {
-    RGBA *pal = palette;
-    int bps = BYTES_PER_SCANLINE(width);
     int res = 0;
-
-    if (!pal)			// create default palette for grayscale images
-    {
-	int i;
-	pal = (RGBA*)rfx_alloc(256 * sizeof(RGBA));
-	for (i = 0; i < 256; i++) {
-	    pal[i].r = pal[i].g = pal[i].b = i;
-	    pal[i].a = 0xff;
-	}
-	ncolors = 256;
-    }
-
     if ((ncolors < 2) || (ncolors > 256) || (!t)) {
 	fprintf(stderr, "rfxswf: unsupported number of colors: %d\n",
 		ncolors);
@@ -793,70 +1118,92 @@ int swf_SetLosslessBitsIndexed(TAG * t, U16 width, U16 height, U8 * bitmap, RGBA
     swf_SetU16(t, height);
     swf_SetU8(t, ncolors - 1);	// number of pal entries
 
-    {
-	z_stream zs;
+    memset(zs, 0x00, sizeof(z_stream));
+    zs->zalloc = Z_NULL;
+    zs->zfree = Z_NULL;
 
-	memset(&zs, 0x00, sizeof(z_stream));
-	zs.zalloc = Z_NULL;
-	zs.zfree = Z_NULL;
+    if (deflateInit(zs, Z_DEFAULT_COMPRESSION) != Z_OK)
+	return -3;		// zlib error
 
-	if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) == Z_OK) {
-	    U8 *zpal;		// compress palette
-	    if ((zpal = (U8*)rfx_alloc(ncolors * 4))) {
-		U8 *pp = zpal;
-		int i;
-
-		/* be careful with ST_DEFINEBITSLOSSLESS2, because
-		   the Flash player produces great bugs if you use too many
-		   alpha colors in your palette. The only sensible result that
-		   can be archeived is setting one color to r=0,b=0,g=0,a=0 to
-		   make transparent parts in sprites. That's the cause why alpha
-		   handling is implemented in lossless routines of rfxswf.
-
-		   Indeed: I haven't understood yet how flash player handles
-		   alpha values different from 0 and 0xff in lossless bitmaps...
-		 */
-
-		if (swf_GetTagID(t) == ST_DEFINEBITSLOSSLESS2)	// have alpha channel?
-		{
-		    for (i = 0; i < ncolors; i++) {
-			pp[0] = pal[i].r;
-			pp[1] = pal[i].g;
-			pp[2] = pal[i].b;
-			pp[3] = pal[i].a;
-			pp += 4;
-		    }
-		    zs.avail_in = 4 * ncolors;
-		} else {
-		    for (i = 0; i < ncolors; i++)	// pack RGBA structures to RGB 
-		    {
-			pp[0] = pal[i].r;
-			pp[1] = pal[i].g;
-			pp[2] = pal[i].b;
-			pp += 3;
-		    }
-		    zs.avail_in = 3 * ncolors;
-		}
+    U8 *zpal;		// compress palette
+    if ((zpal = (U8*)rfx_alloc(ncolors * 4))) {
+	U8 *pp = zpal;
+	int i;
 
-		zs.next_in = zpal;
+	/* be careful with ST_DEFINEBITSLOSSLESS2, because
+	   the Flash player produces great bugs if you use too many
+	   alpha colors in your palette. The only sensible result that
+	   can be archeived is setting one color to r=0,b=0,g=0,a=0 to
+	   make transparent parts in sprites. That's the cause why alpha
+	   handling is implemented in lossless routines of rfxswf.
+
+	   Indeed: I haven't understood yet how flash player handles
+	   alpha values different from 0 and 0xff in lossless bitmaps...
+	 */
+
+	if (swf_GetTagID(t) == ST_DEFINEBITSLOSSLESS2)	// have alpha channel?
+	{
+	    for (i = 0; i < ncolors; i++) {
+		pp[0] = pal[i].r;
+		pp[1] = pal[i].g;
+		pp[2] = pal[i].b;
+		pp[3] = pal[i].a;
+		pp += 4;
+	    }
+	    zs->avail_in = 4 * ncolors;
+	} else {
+	    for (i = 0; i < ncolors; i++)	// pack RGBA structures to RGB 
+	    {
+		pp[0] = pal[i].r;
+		pp[1] = pal[i].g;
+		pp[2] = pal[i].b;
+		pp += 3;
+	    }
+	    zs->avail_in = 3 * ncolors;
+	}
 
-		if (RFXSWF_deflate_wraper(t, &zs, FALSE) < 0)
-		    res = -3;
+	zs->next_in = zpal;
 
-		// compress bitmap
-		zs.next_in = bitmap;
-		zs.avail_in = (bps * height * sizeof(U8));
+	if (RFXSWF_deflate_wraper(t, zs, FALSE) < 0)
+	    res = -3;
 
-		if (RFXSWF_deflate_wraper(t, &zs, TRUE) < 0)
-		    res = -3;
+	rfx_free(zpal);
+    } else
+	res = -2;	// memory error
 
-		deflateEnd(&zs);
+    if (res < 0)
+	deflateEnd(zs);
+    return res;
+}
 
-		rfx_free(zpal);
-	    } else
-		res = -2;	// memory error
-	} else
-	    res = -3;		// zlib error
+int swf_SetLosslessBitsIndexed(TAG * t, U16 width, U16 height, U8 * bitmap, RGBA * palette, U16 ncolors)
+{
+    RGBA *pal = palette;
+    int bps = BYTES_PER_SCANLINE(width);
+    int res = 0;
+
+    if (!pal)			// create default palette for grayscale images
+    {
+	int i;
+	pal = (RGBA*)rfx_alloc(256 * sizeof(RGBA));
+	for (i = 0; i < 256; i++) {
+	    pal[i].r = pal[i].g = pal[i].b = i;
+	    pal[i].a = 0xff;
+	}
+	ncolors = 256;
+    }
+
+    z_stream zs;
+    res = lossless_indexed_start(t, width, height, pal, ncolors, &zs);
+    if (res >= 0) {
+	// compress bitmap
+	zs.next_in = bitmap;
+	zs.avail_in = (bps * height * sizeof(U8));
+
+	if (RFXSWF_deflate_wraper(t, &zs, TRUE) < 0)
+	    res = -3;
+
+	deflateEnd(&zs);
     }
 
     if (!palette)
@@ -865,6 +1212,36 @@ int swf_SetLosslessBitsIndexed(TAG * t, U16 width, U16 height, U8 * bitmap, RGBA
     return res;
 }
 
+/* like swf_SetLosslessBitsIndexed, but the image is passed one row at a
+   time: getrow(user, row) has to store the next width indices in row,
+   and return 0 on error. */
+int swf_SetLosslessBitsIndexedRows(TAG * t, U16 width, U16 height, int (*getrow)(void*user, U8*row), void*user, RGBA * palette, U16 ncolors)
+{
+    int bps = BYTES_PER_SCANLINE(width);
+    z_stream zs;
+    int y;
+    int res = lossless_indexed_start(t, width, height, palette, ncolors, &zs);
+    if (res < 0)
+	return res;
+
+    U8*row = (U8*)rfx_calloc(bps);	// padding stays zero
+    for (y = 0; y < height; y++) {
+	if (!getrow(user, row)) {
+	    res = -1;
+	    break;
+	}
+	zs.next_in = row;
+	zs.avail_in = bps;
+	if (RFXSWF_deflate_wraper(t, &zs, y == height-1) < 0) {
+	    res = -3;
+	    break;
+	}
+    }
+    deflateEnd(&zs);
+    rfx_free(row);
+    return res;
+}
+
 int swf_SetLosslessBitsGrayscale(TAG * t, U16 width, U16 height, U8 * bitmap)
 {
     return swf_SetLosslessBitsIndexed(t, width, height, bitmap, NULL, 256);
@@ -872,17 +1249,123 @@ int swf_SetLosslessBitsGrayscale(TAG * t, U16 width, U16 height, U8 * bitmap)
 
 void swf_PreMultiplyAlpha(RGBA*data, int width, int height)
 {
-    int num = width*height;
-    int t;
-    for(t=0;t<num;t++) {
-	data[t].r = ((int)data[t].r*data[t].a)/255;
-	data[t].g = ((int)data[t].g*data[t].a)/255;
-	data[t].b = ((int)data[t].b*data[t].a)/255;
-    }
+    pixelops_premultiply(data, width*height);
 }
 
 /* expects mem to be non-premultiplied */
 void swf_SetLosslessImage(TAG*tag, RGBA*data, int width, int height)
+{
+    swf_SetLosslessImageQuantized(tag, data, width, height, 0, 0);
+}
+
+static int lossless_deflate_row(TAG*tag, z_stream*zs, RGBA*row, int width, boolean last)
+{
+    zs->next_in = (Bytef*)row;
+    zs->avail_in = width*sizeof(RGBA);
+    return RFXSWF_deflate_wraper(tag, zs, last);
+}
+
+/* like swf_SetLosslessImage, but the image is passed one row at a time:
+   getrow(user, row) has to store the next row (width pixels, not
+   premultiplied) in row, and return 0 on error. Empty images (width
+   or height <= 0) are rejected with -1.
+   Instead of the image, only the palette indices (one byte per pixel)
+   are kept in memory, and only until the 257th color shows up. Rows
+   are premultiplied as they come in, so pixels with an alpha of
+   0xfc-0xfe are premultiplied even if the image turns out to be opaque. */
+int swf_SetLosslessImageRows(TAG*tag, int width, int height, int (*getrow)(void*user, RGBA*row), void*user)
+{
+    int bpl, x, y, t;
+    RGBA*row;
+    U8*indices;
+    palscan_t*scan;
+    z_stream zs;
+    char hasalpha = 0;
+    char truecolor = 0;
+    int res = 0;
+
+    if(width<=0 || height<=0)
+	return -1;
+
+    bpl = BYTES_PER_SCANLINE(width);
+    row = (RGBA*)rfx_alloc(width*sizeof(RGBA));
+    indices = (U8*)rfx_calloc(bpl*height);
+    scan = (palscan_t*)rfx_alloc(sizeof(palscan_t));
+    memset(&zs, 0, sizeof(z_stream));
+    for(y=0;y<height;y++) {
+	if(!getrow(user, row)) {
+	    res = -1;
+	    break;
+	}
+	if(pixelops_has_alpha(row, width))
+	    hasalpha = 1;
+	pixelops_premultiply(row, width);
+	if(!truecolor) {
+	    if(y==0)
+		palscan_init(scan, *(U32*)&row[0]);
+	    if(palscan_row(scan, (U32*)row, width, &indices[y*bpl]))
+		continue;
+	    /* too many colors. Compress the rows we have so far (they can
+	       be restored from the palette), and the rest as they come in */
+	    truecolor = 1;
+	    swf_SetU8(tag, BMF_32BIT);
+	    swf_SetU16(tag, width);
+	    swf_SetU16(tag, height);
+	    if(deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK) {
+		res = -3;
+		break;
+	    }
+	    RGBA*row2 = (RGBA*)rfx_alloc(width*sizeof(RGBA));
+	    for(t=0;t<y && res>=0;t++) {
+		U8*src = &indices[t*bpl];
+		for(x=0;x<width;x++)
+		    *(U32*)&row2[x] = scan->pal[src[x]];
+		if(lossless_deflate_row(tag, &zs, row2, width, FALSE) < 0)
+		    res = -3;
+	    }
+	    rfx_free(row2);
+	    rfx_free(indices);
+	    indices = 0;
+	}
+	if(res<0 || lossless_deflate_row(tag, &zs, row, width, y==height-1) < 0) {
+	    res = -3;
+	    break;
+	}
+    }
+    tag->id = hasalpha ? ST_DEFINEBITSLOSSLESS2 : ST_DEFINEBITSLOSSLESS;
+
+    if(!truecolor && res>=0) {
+	RGBA palette[256];
+	int num = palscan_finish(scan, palette, indices, width, height, bpl);
+	if(num>1) {
+	    res = swf_SetLosslessBitsIndexed(tag, width, height, indices, palette, num);
+	} else {
+	    /* all pixels have the same color */
+	    swf_SetU8(tag, BMF_32BIT);
+	    swf_SetU16(tag, width);
+	    swf_SetU16(tag, height);
+	    if(deflateInit(&zs, Z_DEFAULT_COMPRESSION) == Z_OK) {
+		truecolor = 1;
+		for(y=0;y<height && res>=0;y++)
+		    res = lossless_deflate_row(tag, &zs, row, width, y==height-1);
+	    } else {
+		res = -3;
+	    }
+	}
+    }
+    if(truecolor)
+	deflateEnd(&zs);
+    if(indices)
+	rfx_free(indices);
+    rfx_free(scan);
+    rfx_free(row);
+    return res;
+}
+
+/* like swf_SetLosslessImage, but images with more than 256 colors are
+   stored with a palette, too, if that can be done with a root mean square
+   error of at most maxerror. (maxerror = 0 disables quantization) */
+void swf_SetLosslessImageQuantized(TAG*tag, RGBA*data, int width, int height, double maxerror, char dither)
 {
     int hasalpha = swf_ImageHasAlpha(data, width, height);
     int num;
@@ -893,39 +1376,30 @@ void swf_SetLosslessImage(TAG*tag, RGBA*data, int width, int height)
 	/* FIXME: we're destroying the callers data here */
 	swf_PreMultiplyAlpha(data, width, height);
     }
-    num = swf_ImageGetNumberOfPaletteEntries(data, width, height, 0);
+    int width2 = BYTES_PER_SCANLINE(width);
+    U8*data2 = 0;
+    RGBA palette[256];
+    /* count the colors first (this stops at the 257th one), so that
+       true color images don't need the index buffer */
+    num = swf_ImageGetPalette(data, width, height, 0, 0, 0);
+    if(num<=256) {
+	data2 = (U8*)malloc(width2*height);
+	num = swf_ImageGetPalette(data, width, height, palette, data2, width2);
+    } else if(maxerror>0) {
+	data2 = (U8*)malloc(width2*height);
+	num = swf_ImageQuantize(data, width, height, 256, maxerror, dither, palette, data2, width2);
+    }
     if(num>1 && num<=256) {
-	RGBA*palette = (RGBA*)malloc(sizeof(RGBA)*num);
-	int width2 = BYTES_PER_SCANLINE(width);
-	U8*data2 = (U8*)malloc(width2*height);
-	int len = width*height;
-	int x,y;
-	int r;
-	swf_ImageGetNumberOfPaletteEntries(data, width, height, palette);
-	for(y=0;y<height;y++) {
-	    RGBA*src = &data[width*y];
-	    U8*dest = &data2[width2*y];
-	    for(x=0;x<width;x++) {
-		RGBA col = src[x];
-		for(r=0;r<num;r++) {
-		    if(*(U32*)&col == *(U32*)&palette[r]) {
-			dest[x] = r;
-			break;
-		    }
-		}
-		if(r==num) {
-		    fprintf(stderr, "Internal error: Couldn't find color %02x%02x%02x%02x in palette (%d entries)\n",
-			    col.r, col.g, col.b, col.a, num);
-		    dest[x] = 0;
-		}
-	    }
+	if(width2 > width) {
+	    int y;
+	    for(y=0;y<height;y++)
+		memset(&data2[width2*y+width], 0, width2-width);
 	}
 	swf_SetLosslessBitsIndexed(tag, width, height, data2, palette, num);
-	free(data2);
-	free(palette);
     } else {
 	swf_SetLosslessBits(tag, width, height, data, BMF_32BIT);
     }
+    free(data2);
 }
 
 RGBA *swf_DefineLosslessBitsTagToImage(TAG * tag, int *dwidth, int *dheight)
@@ -1021,18 +1495,10 @@ RGBA *swf_DefineLosslessBitsTagToImage(TAG * tag, int *dwidth, int *dheight)
 		    pos += 4;	//ignore padding byte
 		}
 	    } else {
-		for (x = 0; x < width; x++) {
-		    /* remove premultiplication */
-		    int alpha = data[pos+0];
-		    if(alpha)
-			alpha = 0xff0000/alpha;
-		    dest[pos2].r = (data[pos + 1]*alpha)>>16;
-		    dest[pos2].g = (data[pos + 2]*alpha)>>16;
-		    dest[pos2].b = (data[pos + 3]*alpha)>>16;
-		    dest[pos2].a = data[pos + 0];	//alpha
-		    pos2++;
-		    pos += 4;
-		}
+		/* remove premultiplication */
+		pixelops_unpremultiply(&dest[pos2], &data[pos], width);
+		pos2 += width;
+		pos += width*4;
 	    }
 	} else {
 	    for (x = 0; x < srcwidth; x++) {
@@ -1157,6 +1623,13 @@ int swf_SetJPEGBits3(TAG * tag, U16 width, U16 height, RGBA * bitmap, int qualit
 
 /* expects mem to be non-premultiplied */
 TAG* swf_AddImage(TAG*tag, int bitid, RGBA*mem, int width, int height, int quality)
+{
+    return swf_AddImageQuantized(tag, bitid, mem, width, height, quality, 0, 0);
+}
+
+/* like swf_AddImage, with the lossless version quantized as in
+   swf_SetLosslessImageQuantized */
+TAG* swf_AddImageQuantized(TAG*tag, int bitid, RGBA*mem, int width, int height, int quality, double maxerror, char dither)
 {
     TAG *tag1 = 0, *tag2 = 0;
     int has_alpha = swf_ImageHasAlpha(mem,width,height);
@@ -1169,7 +1642,7 @@ TAG* swf_AddImage(TAG*tag, int bitid, RGBA*mem, int width, int height, int quali
 #else
     tag1 = swf_InsertTag(0, /*ST_DEFINEBITSLOSSLESS1/2*/0);
     swf_SetU16(tag1, bitid);
-    swf_SetLosslessImage(tag1, mem, width, height);
+    swf_SetLosslessImageQuantized(tag1, mem, width, height, maxerror, dither);
 #endif
 
 #if defined(HAVE_JPEGLIB)
@@ -1202,6 +1675,263 @@ TAG* swf_AddImage(TAG*tag, int bitid, RGBA*mem, int width, int height, int quali
     return tag;
 }
 
+/* swf_AddImageAdaptive() encodes these in parallel, and keeps the smallest */
+#define CANDIDATE_LOSSLESS 0	/* with a palette if there are at most 256 colors */
+#define CANDIDATE_QUANTIZED 1	/* lossy: reduced to 256 colors */
+#define CANDIDATE_JPEG 2	/* lossy: DefineBitsJPEG2, or JPEG3 with zlib compressed alpha */
+#define NUM_CANDIDATES 3
+
+typedef struct _adaptive {
+    RGBA*img; // premultiplied
+    int width, height;
+    int has_alpha;
+    int bitid;
+    int quality;
+    double minpsnr;
+    int numcolors;
+    RGBA palette[256];
+    U8*indices;
+    int bpl;
+    char enabled[NUM_CANDIDATES];
+    TAG*tag[NUM_CANDIDATES];
+} adaptive_t;
+
+/* peak signal to noise ratio (in dB) of the error sum of squares sse
+   over num pixels, with the given number of channels */
+static double image_psnr(double sse, int num, int channels)
+{
+    if(sse <= 0)
+	return 1e9;
+    return 10*log10(255.0*255.0*num*channels/sse);
+}
+
+static double image_sse(RGBA*a, RGBA*b, int num, int channels)
+{
+    double sse = 0;
+    int t;
+    for(t=0;t<num;t++) {
+	int dr = a[t].r - b[t].r, dg = a[t].g - b[t].g, db = a[t].b - b[t].b;
+	sse += dr*dr + dg*dg + db*db;
+	if(channels == 4) {
+	    int da = a[t].a - b[t].a;
+	    sse += da*da;
+	}
+    }
+    return sse;
+}
+
+static double indexed_sse(RGBA*img, int width, int height, RGBA*palette, U8*indices, int bpl, int channels)
+{
+    double sse = 0;
+    int y;
+    RGBA*line = (RGBA*)rfx_alloc(width*sizeof(RGBA));
+    for(y=0;y<height;y++) {
+	int x;
+	for(x=0;x<width;x++)
+	    line[x] = palette[indices[y*bpl+x]];
+	sse += image_sse(&img[y*width], line, width, channels);
+    }
+    rfx_free(line);
+    return sse;
+}
+
+static void set_indexed(TAG*tag, int width, int height, U8*indices, int bpl, RGBA*palette, int num)
+{
+    if(bpl > width) {
+	int y;
+	for(y=0;y<height;y++)
+	    memset(&indices[bpl*y+width], 0, bpl-width);
+    }
+    swf_SetLosslessBitsIndexed(tag, width, height, indices, palette, num);
+}
+
+static TAG* adaptive_lossless(adaptive_t*a)
+{
+    TAG*tag = swf_InsertTag(0, a->has_alpha?ST_DEFINEBITSLOSSLESS2:ST_DEFINEBITSLOSSLESS);
+    swf_SetU16(tag, a->bitid);
+    if(a->numcolors>1 && a->numcolors<=256)
+	set_indexed(tag, a->width, a->height, a->indices, a->bpl, a->palette, a->numcolors);
+    else
+	swf_SetLosslessBits(tag, a->width, a->height, a->img, BMF_32BIT);
+    return tag;
+}
+
+static TAG* adaptive_quantized(adaptive_t*a)
+{
+    int size = a->width*a->height;
+    int channels = a->has_alpha?4:3;
+    RGBA palette[256];
+    U8*indices = (U8*)rfx_alloc(a->bpl*a->height);
+    /* swf_ImageQuantize bounds the mean square error per channel */
+    double maxerror = 255.0/pow(10, a->minpsnr/20);
+    int num = swf_ImageQuantize(a->img, a->width, a->height, 256, maxerror, 0, palette, indices, a->bpl);
+    TAG*tag = 0;
+    if(num>1 && image_psnr(indexed_sse(a->img, a->width, a->height, palette, indices, a->bpl, channels), size, channels) >= a->minpsnr) {
+	tag = swf_InsertTag(0, a->has_alpha?ST_DEFINEBITSLOSSLESS2:ST_DEFINEBITSLOSSLESS);
+	swf_SetU16(tag, a->bitid);
+	set_indexed(tag, a->width, a->height, indices, a->bpl, palette, num);
+    }
+    rfx_free(indices);
+    return tag;
+}
+
+#ifdef HAVE_JPEGLIB
+static TAG* adaptive_jpeg(adaptive_t*a)
+{
+    TAG*tag;
+    if(a->has_alpha) {
+	tag = swf_InsertTag(0, ST_DEFINEBITSJPEG3);
+	swf_SetU16(tag, a->bitid);
+	swf_SetJPEGBits3(tag, a->width, a->height, a->img, a->quality);
+    } else {
+	tag = swf_InsertTag(0, ST_DEFINEBITSJPEG2);
+	swf_SetU16(tag, a->bitid);
+	swf_SetJPEGBits2(tag, a->width, a->height, a->img, a->quality);
+    }
+    if(a->minpsnr > 0) {
+	int width, height;
+	swf_SetTagPos(tag, 2);
+	RGBA*decoded = swf_JPEG2TagToImage(tag, &width, &height);
+	int channels = a->has_alpha?4:3;
+	if(!decoded || width != a->width || height != a->height ||
+	   image_psnr(image_sse(a->img, decoded, width*height, channels), width*height, channels) < a->minpsnr) {
+	    swf_DeleteTag(0, tag);
+	    tag = 0;
+	}
+	if(decoded)
+	    rfx_free(decoded);
+    }
+    return tag;
+}
+#endif
+
+static void adaptive_encode(void*data, int nr)
+{
+    adaptive_t*a = (adaptive_t*)data;
+    if(!a->enabled[nr])
+	return;
+    switch(nr) {
+	case CANDIDATE_LOSSLESS:
+	    a->tag[nr] = adaptive_lossless(a);
+	break;
+	case CANDIDATE_QUANTIZED:
+	    a->tag[nr] = adaptive_quantized(a);
+	break;
+#ifdef HAVE_JPEGLIB
+	case CANDIDATE_JPEG:
+	    a->tag[nr] = adaptive_jpeg(a);
+	break;
+#endif
+    }
+}
+
+/* Guess the sizes of the lossless and the jpeg version from every eighth
+   band of 16 lines, and don't bother with candidates which are unlikely
+   to win: lossless encoding of photographs is slow, and so is decoding
+   the jpeg of a diagram to check its quality. */
+static void adaptive_predict(adaptive_t*a)
+{
+#ifdef HAVE_JPEGLIB
+    if(a->width*a->height < 0x40000 || !a->enabled[CANDIDATE_JPEG])
+	return;
+    int band = 16, step = 8;
+    int lines = 0, y;
+    for(y=0;y<a->height;y+=band*step)
+	lines += a->height-y < band ? a->height-y : band;
+    RGBA*img = (RGBA*)rfx_alloc(a->width*lines*sizeof(RGBA));
+    U8*indices = a->indices ? (U8*)rfx_alloc(a->bpl*lines) : 0;
+    int pos = 0;
+    for(y=0;y<a->height;y+=band*step) {
+	int l = a->height-y < band ? a->height-y : band;
+	memcpy(&img[pos*a->width], &a->img[y*a->width], l*a->width*sizeof(RGBA));
+	if(indices)
+	    memcpy(&indices[pos*a->bpl], &a->indices[y*a->bpl], l*a->bpl);
+	pos += l;
+    }
+    adaptive_t sample = *a;
+    sample.img = img;
+    sample.indices = indices;
+    sample.height = lines;
+    sample.minpsnr = 0;
+    TAG*lossless = adaptive_lossless(&sample);
+    TAG*jpeg = adaptive_jpeg(&sample);
+    if(lossless->len > jpeg->len*2) {
+	a->enabled[CANDIDATE_LOSSLESS] = 0;
+	if(lossless->len > jpeg->len*4)
+	    a->enabled[CANDIDATE_QUANTIZED] = 0;
+    } else if(jpeg->len > lossless->len*2) {
+	a->enabled[CANDIDATE_JPEG] = 0;
+    }
+    swf_DeleteTag(0, lossless);
+    swf_DeleteTag(0, jpeg);
+    rfx_free(img);
+    rfx_free(indices);
+#endif
+}
+
+/* like swf_AddImage, but images are also stored with a palette
+   (quantized if needed), and jpeg candidates are only used if they
+   have a PSNR of at least minpsnr dB. Large images are encoded on up
+   to num_threads threads (0 = one per processor). Doesn't modify mem. */
+TAG* swf_AddImageAdaptive(TAG*tag, int bitid, RGBA*mem, int width, int height, int quality, double minpsnr, int num_threads)
+{
+    adaptive_t a;
+    int size = width*height;
+    int t;
+    memset(&a, 0, sizeof(a));
+    a.width = width;
+    a.height = height;
+    a.bitid = bitid;
+    a.quality = quality;
+    a.minpsnr = minpsnr;
+    a.has_alpha = swf_ImageHasAlpha(mem, width, height);
+    a.img = mem;
+    if(a.has_alpha) {
+	a.img = (RGBA*)rfx_alloc(size*sizeof(RGBA));
+	memcpy(a.img, mem, size*sizeof(RGBA));
+	swf_PreMultiplyAlpha(a.img, width, height);
+    }
+    a.bpl = BYTES_PER_SCANLINE(width);
+    /* count first (this stops at the 257th color), so that truecolor
+       images don't need an index buffer */
+    a.numcolors = swf_ImageGetPalette(a.img, width, height, 0, 0, 0);
+    if(a.numcolors<=256) {
+	a.indices = (U8*)rfx_alloc(a.bpl*height);
+	a.numcolors = swf_ImageGetPalette(a.img, width, height, a.palette, a.indices, a.bpl);
+    }
+
+    a.enabled[CANDIDATE_LOSSLESS] = 1;
+    a.enabled[CANDIDATE_QUANTIZED] = a.numcolors>256 && minpsnr>0;
+#ifdef HAVE_JPEGLIB
+    a.enabled[CANDIDATE_JPEG] = quality<=100;
+#endif
+    adaptive_predict(&a);
+
+    parallel_for(NUM_CANDIDATES, adaptive_encode, &a, size>=0x10000 ? num_threads : 1);
+
+    /* if the predictor was wrong, and none of the lossy versions
+       is good enough, fall back to lossless */
+    if(!a.tag[CANDIDATE_QUANTIZED] && !a.tag[CANDIDATE_JPEG] && !a.tag[CANDIDATE_LOSSLESS])
+	a.tag[CANDIDATE_LOSSLESS] = adaptive_lossless(&a);
+
+    TAG*best = 0;
+    for(t=0;t<NUM_CANDIDATES;t++) {
+	if(a.tag[t] && (!best || a.tag[t]->len < best->len))
+	    best = a.tag[t];
+    }
+    for(t=0;t<NUM_CANDIDATES;t++) {
+	if(a.tag[t] && a.tag[t] != best)
+	    swf_DeleteTag(0, a.tag[t]);
+    }
+    best->prev = tag;
+    if(tag) tag->next = best;
+
+    rfx_free(a.indices);
+    if(a.img != mem)
+	rfx_free(a.img);
+    return best;
+}
+
 RGBA *swf_ExtractImage(TAG * tag, int *dwidth, int *dheight)
 {
     RGBA *img;
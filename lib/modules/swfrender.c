@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "../rfxswf.h"
+#include "../q.h"
 
 /* one bit flag: */
 #define clip_type 0
@@ -78,6 +79,29 @@ typedef struct _bitmap {
     struct _bitmap*next;
 } bitmap_t;
 
+/* a rasterized glyph, stored as horizontal spans relative to the
+   pixel the glyph's origin falls into. Glyphs are keyed by their exact
+   subpixel phase. A cached glyph still isn't always bit-identical to a
+   freshly rendered one: the rasterizer's floating point rounding depends
+   on the absolute position, so a few edge pixels may differ. */
+typedef struct _glyphkey {
+    int fontid;
+    int glyph;
+    int fontsize;
+    SFIXED sx,r0,r1,sy;
+    int phasex,phasey;
+} glyphkey_t;
+
+typedef struct _glyphbitmap {
+    int xoffset,yoffset;
+    int height;
+    int*rows; /* height+1 indices into spans */
+    int*spans; /* x1,x2 pairs */
+    int size;
+} glyphbitmap_t;
+
+#define GLYPHCACHE_MAXSIZE (4*1024*1024)
+
 typedef struct _renderbuf_internal
 {
     renderline_t*lines;
@@ -87,9 +111,14 @@ typedef struct _renderbuf_internal
     int width2,height2;
     int shapes;
     int ymin, ymax;
+    int xoffset, yoffset; /* position of this buffer on the canvas, in internal pixels */
     
     RGBA* img;
     int* zbuf; 
+
+    dict_t*glyphs;
+    int glyphs_size;
+    int glyphs_maxsize; /* 0 = don't cache glyphs */
 } renderbuf_internal;
 
 #define DEBUG 0
@@ -128,10 +157,10 @@ static void add_line(RENDERBUF*buf, double x1, double y1, double x2, double y2,
     x1=x1*i->multiply;
     x2=x2*i->multiply;
     
-    y1 = y1/20.0;
-    y2 = y2/20.0;
-    x1 = x1/20.0;
-    x2 = x2/20.0;
+    y1 = y1/20.0 - i->yoffset;
+    y2 = y2/20.0 - i->yoffset;
+    x1 = x1/20.0 - i->xoffset;
+    x2 = x2/20.0 - i->xoffset;
 
     if(y2 < y1) {
         double x;
@@ -279,23 +308,14 @@ static int compare_renderpoints(const void * _a, const void * _b)
     return 0;
 }
 
-void swf_Render_Init(RENDERBUF*buf, int posx, int posy, int width, int height, int antialize, int multiply)
+static renderbuf_internal* renderbuf_internal_new(int width2, int height2, int antialize, int multiply)
 {
-    renderbuf_internal*i;
+    renderbuf_internal*i = (renderbuf_internal*)rfx_calloc(sizeof(renderbuf_internal));
     int y;
-    memset(buf, 0, sizeof(RENDERBUF));
-    buf->width = width*multiply;
-    buf->height = height*multiply;
-    buf->posx = posx;
-    buf->posy = posy;
-    buf->internal = (renderbuf_internal*)rfx_calloc(sizeof(renderbuf_internal));
-    i = (renderbuf_internal*)buf->internal;
-    if(antialize < 1)
-	antialize = 1;
     i->antialize = antialize;
-    i->multiply = multiply*antialize;
-    i->height2 = antialize*buf->height;
-    i->width2 = antialize*buf->width;
+    i->multiply = multiply;
+    i->height2 = height2;
+    i->width2 = width2;
     i->lines = (renderline_t*)rfx_alloc(i->height2*sizeof(renderline_t));
     for(y=0;y<i->height2;y++) {
 	memset(&i->lines[y], 0, sizeof(renderline_t));
@@ -307,6 +327,20 @@ void swf_Render_Init(RENDERBUF*buf, int posx, int posy, int width, int height, i
     i->shapes = 0;
     i->ymin = 0x7fffffff;
     i->ymax = -0x80000000;
+    return i;
+}
+
+void swf_Render_Init(RENDERBUF*buf, int posx, int posy, int width, int height, int antialize, int multiply)
+{
+    memset(buf, 0, sizeof(RENDERBUF));
+    buf->width = width*multiply;
+    buf->height = height*multiply;
+    buf->posx = posx;
+    buf->posy = posy;
+    if(antialize < 1)
+	antialize = 1;
+    buf->internal = renderbuf_internal_new(antialize*buf->width, antialize*buf->height, antialize, multiply*antialize);
+    ((renderbuf_internal*)buf->internal)->glyphs_maxsize = GLYPHCACHE_MAXSIZE;
 }
 void swf_Render_SetBackground(RENDERBUF*buf, RGBA*img, int width, int height)
 {
@@ -353,6 +387,57 @@ void swf_Render_ClearCanvas(RENDERBUF*dest)
     memset(i->zbuf, 0, sizeof(int)*i->width2*i->height2);
     memset(i->img, 0, sizeof(RGBA)*i->width2*i->height2);
 }
+static char glyphkey_equals(const void*k1, const void*k2)
+{
+    return !memcmp(k1, k2, sizeof(glyphkey_t));
+}
+static unsigned int glyphkey_hash(const void*k)
+{
+    return string_hash3((const char*)k, sizeof(glyphkey_t));
+}
+static void* glyphkey_clone(const void*k)
+{
+    void*n = rfx_alloc(sizeof(glyphkey_t));
+    memcpy(n, k, sizeof(glyphkey_t));
+    return n;
+}
+static void glyphkey_destroy(void*k)
+{
+    rfx_free(k);
+}
+static type_t glyphkey_type = {
+    hash: glyphkey_hash,
+    equals: glyphkey_equals,
+    dup: glyphkey_clone,
+    free: glyphkey_destroy,
+};
+
+static void glyphbitmap_free(void*_g)
+{
+    glyphbitmap_t*g = (glyphbitmap_t*)_g;
+    rfx_free(g->rows);
+    rfx_free(g->spans);
+    rfx_free(g);
+}
+/* dict_free_all() leaves the dict unusable, so this deletes it. It's
+   created again on the next lookup. */
+static void glyphcache_clear(renderbuf_internal*i)
+{
+    if(i->glyphs) {
+	dict_free_all(i->glyphs, 1, glyphbitmap_free);
+	rfx_free(i->glyphs);
+	i->glyphs = 0;
+    }
+    i->glyphs_size = 0;
+}
+
+void swf_Render_SetGlyphCacheSize(RENDERBUF*buf, int size)
+{
+    renderbuf_internal*i = (renderbuf_internal*)buf->internal;
+    glyphcache_clear(i);
+    i->glyphs_maxsize = size;
+}
+
 void swf_Render_Delete(RENDERBUF*dest)
 {
     renderbuf_internal*i = (renderbuf_internal*)dest->internal;
@@ -377,6 +462,8 @@ void swf_Render_Delete(RENDERBUF*dest)
         b = next;
     }
 
+    glyphcache_clear(i);
+
     rfx_free(i->lines); i->lines = 0;
     rfx_free(dest->internal); dest->internal = 0;
 }
@@ -575,14 +662,14 @@ static int inline clamp(int v)
     else return v;
 }
 
-static void fill_bitmap(RGBA*line, int*z, int y, int x1, int x2, MATRIX*m, bitmap_t*b, int clipbitmap, U32 depth, double fmultiply)
+static void fill_bitmap(RGBA*line, int*z, int y, int x1, int x2, MATRIX*m, bitmap_t*b, int clipbitmap, U32 depth, double fmultiply, int xoffset, int yoffset)
 {
     int x = x1;
     
     double m11= m->sx*fmultiply/65536.0, m21= m->r1*fmultiply/65536.0;
     double m12= m->r0*fmultiply/65536.0, m22= m->sy*fmultiply/65536.0;
-    double rx = m->tx*fmultiply/20.0;
-    double ry = m->ty*fmultiply/20.0;
+    double rx = m->tx*fmultiply/20.0 - xoffset;
+    double ry = m->ty*fmultiply/20.0 - yoffset;
 
     double det = m11*m22 - m12*m21;
     if(fabs(det) < 0.0005) { 
@@ -628,14 +715,14 @@ static void fill_bitmap(RGBA*line, int*z, int y, int x1, int x2, MATRIX*m, bitma
     } while(++x<x2);
 }
 
-static void fill_gradient(RGBA*line, int*z, int y, int x1, int x2, MATRIX*m, GRADIENT*g, int type, U32 depth, double fmultiply)
+static void fill_gradient(RGBA*line, int*z, int y, int x1, int x2, MATRIX*m, GRADIENT*g, int type, U32 depth, double fmultiply, int xoffset, int yoffset)
 {
     int x = x1;
     
     double m11= m->sx*fmultiply/80, m21= m->r1*fmultiply/80;
     double m12= m->r0*fmultiply/80, m22= m->sy*fmultiply/80;
-    double rx = m->tx*fmultiply/20.0;
-    double ry = m->ty*fmultiply/20.0;
+    double rx = m->tx*fmultiply/20.0 - xoffset;
+    double ry = m->ty*fmultiply/20.0 - yoffset;
 
     double det = m11*m22 - m12*m21;
     if(fabs(det) < 0.0005) { 
@@ -760,10 +847,10 @@ static void fill(RENDERBUF*dest, RGBA*line, int*zline, int y, int x1, int x2, st
                     fprintf(stderr, "Shape references unknown bitmap %d\n", f->id_bitmap);
                     fill_solid(line, zline, y, x1, x2, color_red, l->p->depth);
                 } else {
-                    fill_bitmap(line, zline, y, x1, x2, &f->m, b, /*clipped?*/f->type&1, l->p->depth, i->multiply);
+                    fill_bitmap(line, zline, y, x1, x2, &f->m, b, /*clipped?*/f->type&1, l->p->depth, i->multiply, i->xoffset, i->yoffset);
                 }
             } else if(f->type == FILL_LINEAR || f->type == FILL_RADIAL) {
-		fill_gradient(line, zline, y, x1, x2, &f->m, &f->gradient, f->type, l->p->depth, i->multiply);
+		fill_gradient(line, zline, y, x1, x2, &f->m, &f->gradient, f->type, l->p->depth, i->multiply, i->xoffset, i->yoffset);
             } else {
                 fprintf(stderr, "Undefined fillmode: %02x\n", f->type);
 	    }
@@ -1108,6 +1195,178 @@ typedef struct textcallbackblock
     RENDERBUF*buf;
 } textcallbackblock_t;
 
+static glyphbitmap_t* glyph_rasterize(RENDERBUF*dest, SHAPE2*shape, MATRIX*m, int px, int py)
+{
+    renderbuf_internal*i = (renderbuf_internal*)dest->internal;
+    SHAPELINE*line = shape->lines;
+    MATRIX mat = *m;
+    int xmin=0x7fffffff,ymin=0x7fffffff,xmax=-0x80000000,ymax=-0x80000000;
+
+    mat.tx -= dest->posx*20;
+    mat.ty -= dest->posy*20;
+    while(line) {
+	int x,y;
+	transform_point(&mat, line->x, line->y, &x, &y);
+	if(x<xmin) xmin=x;
+	if(x>xmax) xmax=x;
+	if(y<ymin) ymin=y;
+	if(y>ymax) ymax=y;
+	if(line->type == splineTo) {
+	    transform_point(&mat, line->sx, line->sy, &x, &y);
+	    if(x<xmin) xmin=x;
+	    if(x>xmax) xmax=x;
+	    if(y<ymin) ymin=y;
+	    if(y>ymax) ymax=y;
+	}
+	line = line->next;
+    }
+    if(xmin>xmax)
+	return 0;
+
+    int x1 = (int)floor(xmin*i->multiply/20.0)-1;
+    int y1 = (int)floor(ymin*i->multiply/20.0)-1;
+    int x2 = (int)ceil(xmax*i->multiply/20.0)+2;
+    int y2 = (int)ceil(ymax*i->multiply/20.0)+2;
+    int width = x2-x1;
+    int height = y2-y1;
+    if(width*height > i->glyphs_maxsize/64) {
+	/* huge glyph- not worth caching */
+	return 0;
+    }
+
+    /* render the glyph into a scratch buffer of its own, and derive
+       the coverage from the z buffer */
+    RENDERBUF tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    tmp.posx = dest->posx;
+    tmp.posy = dest->posy;
+    tmp.width = width;
+    tmp.height = height;
+    renderbuf_internal*ti = renderbuf_internal_new(width, height, 1, i->multiply);
+    ti->xoffset = x1;
+    ti->yoffset = y1;
+    tmp.internal = ti;
+    swf_RenderShape(&tmp, shape, m, 0, 1, 0);
+
+    glyphbitmap_t*g = (glyphbitmap_t*)rfx_calloc(sizeof(glyphbitmap_t));
+    g->xoffset = x1 - px;
+    g->yoffset = y1 - py;
+    g->height = height;
+    g->rows = (int*)rfx_alloc(sizeof(int)*(height+1));
+    int size = 16;
+    int num = 0;
+    g->spans = (int*)rfx_alloc(sizeof(int)*size);
+    int x,y;
+    for(y=0;y<height;y++) {
+	int*z = &ti->zbuf[y*width];
+	g->rows[y] = num;
+	for(x=0;x<width;x++) {
+	    if(!z[x])
+		continue;
+	    int start = x;
+	    while(x<width && z[x])
+		x++;
+	    if(num+2 > size) {
+		size *= 2;
+		g->spans = (int*)rfx_realloc(g->spans, sizeof(int)*size);
+	    }
+	    g->spans[num++] = start;
+	    g->spans[num++] = x;
+	}
+    }
+    g->rows[height] = num;
+    g->size = sizeof(glyphbitmap_t) + sizeof(int)*(height+1+size);
+    swf_Render_Delete(&tmp);
+    return g;
+}
+
+static void glyph_blit(RENDERBUF*dest, glyphbitmap_t*g, int px, int py, RGBA color, U16 _depth)
+{
+    renderbuf_internal*i = (renderbuf_internal*)dest->internal;
+    U32 depth = _depth << 16;
+    int y;
+    for(y=0;y<g->height;y++) {
+	int yy = py + g->yoffset + y - i->yoffset;
+	int n;
+	if(yy<0 || yy>=i->height2 || g->rows[y] == g->rows[y+1])
+	    continue;
+        RGBA*line = &i->img[i->width2*yy];
+        int*zline = &i->zbuf[i->width2*yy];
+	if(i->lines[yy].pending_clipdepth) {
+	    fill_clip(line, zline, yy, 0, i->width2, i->lines[yy].pending_clipdepth);
+	    i->lines[yy].pending_clipdepth=0;
+	}
+	for(n=g->rows[y];n<g->rows[y+1];n+=2) {
+	    int x1 = px + g->xoffset + g->spans[n] - i->xoffset;
+	    int x2 = px + g->xoffset + g->spans[n+1] - i->xoffset;
+	    if(x1 < 0)
+		x1 = 0;
+	    if(x2 > i->width2)
+		x2 = i->width2;
+	    if(x1 < x2)
+		fill_solid(line, zline, yy, x1, x2, color, depth);
+	}
+    }
+}
+
+/* draws a glyph from the glyph cache, rasterizing it first if necessary.
+   returns 0 if the glyph can't be cached */
+static int glyph_render(RENDERBUF*dest, int fontid, int glyph, int fontsize, SHAPE2*shape, MATRIX*m, RGBA color, U16 depth)
+{
+    renderbuf_internal*i = (renderbuf_internal*)dest->internal;
+    if(shape->numlinestyles || !i->glyphs_maxsize)
+	return 0;
+
+    /* split the position into a whole pixel and a (quantized) subpixel phase */
+    int x = (m->tx - dest->posx*20) * i->multiply;
+    int y = (m->ty - dest->posy*20) * i->multiply;
+    int px = (x>=0?x:x-19)/20;
+    int py = (y>=0?y:y-19)/20;
+
+    glyphkey_t key;
+    memset(&key, 0, sizeof(key));
+    key.fontid = fontid;
+    key.glyph = glyph;
+    key.fontsize = fontsize;
+    key.sx = m->sx; key.r0 = m->r0;
+    key.r1 = m->r1; key.sy = m->sy;
+    key.phasex = x - px*20;
+    key.phasey = y - py*20;
+
+    if(!i->glyphs)
+	i->glyphs = dict_new2(&glyphkey_type);
+
+    glyphbitmap_t*g = (glyphbitmap_t*)dict_lookup(i->glyphs, &key);
+    if(!g) {
+	g = glyph_rasterize(dest, shape, m, px, py);
+	if(!g)
+	    return 0;
+	if(i->glyphs_size + g->size > i->glyphs_maxsize) {
+	    glyphcache_clear(i);
+	    i->glyphs = dict_new2(&glyphkey_type);
+	}
+	dict_put(i->glyphs, &key, g);
+	i->glyphs_size += g->size;
+    }
+    glyph_blit(dest, g, px, py, color, depth);
+    return 1;
+}
+
+static RGBA apply_cxform(RGBA c, CXFORM*cx)
+{
+    if(!cx)
+	return c;
+    int r = ((c.r*cx->r0)>>8) + cx->r1;
+    int g = ((c.g*cx->g0)>>8) + cx->g1;
+    int b = ((c.b*cx->b0)>>8) + cx->b1;
+    int a = ((c.a*cx->a0)>>8) + cx->a1;
+    c.r = r<0?0:(r>255?255:r);
+    c.g = g<0?0:(g>255?255:g);
+    c.b = b<0?0:(b>255?255:b);
+    c.a = a<0?0:(a>255?255:a);
+    return c;
+}
+
 static void textcallback(void*self, int*chars, int*xpos, int nr, int fontid, int fontsize, 
 		    int xstart, int ystart, RGBA* color)
 {
@@ -1143,7 +1402,12 @@ static void textcallback(void*self, int*chars, int*xpos, int nr, int fontid, int
 	    fprintf(stderr, "Character out of range: %d\n", chars[t]);
 	} else {
 	    SHAPE2*shape = font->glyphs[chars[t]];
-	    shape->fillstyles[0].color = *color; //q&d
+	    RGBA c = apply_cxform(*color, info->cxform);
+	    if(!info->clipdepth && 
+	       glyph_render(info->buf, fontid, chars[t], fontsize, shape, &m, c, info->depth)) {
+		continue;
+	    }
+	    shape->fillstyles[0].color = c; //q&d
 	    /*printf("Rendering char %d (size %d, x:%d, y:%d) color:%02x%02x%02x%02x\n", chars[t], fontsize, x, y,
 		    color->a, color->r, color->g, color->b);
 	    swf_DumpMatrix(stdout, &m);
@@ -1153,42 +1417,10 @@ static void textcallback(void*self, int*chars, int*xpos, int nr, int fontid, int
     }
 }
 
-static void renderFromTag(RENDERBUF*buf, character_t*idtable, TAG*firstTag, MATRIX*m)
-{
-    TAG*tag = 0;
-    int numplacements = 0;
-    SWFPLACEOBJECT* placements;
-
-    tag = firstTag;
-    numplacements = 0;
-    while(tag) {
-        if(tag->id == ST_PLACEOBJECT || 
-           tag->id == ST_PLACEOBJECT2) {
-	    numplacements++;
-	}
-	if(tag->id == ST_SHOWFRAME || tag->id == ST_END)
-	    break;
-	tag = tag->next;
-    }
-    placements = (SWFPLACEOBJECT*)rfx_calloc(sizeof(SWFPLACEOBJECT)*numplacements);
-    numplacements = 0;
-
-    tag = firstTag;
-    while(tag) {
-	if(swf_isPlaceTag(tag)) {
-	    SWFPLACEOBJECT p;
-	    swf_GetPlaceObject(tag, &p);
-	    /* TODO: add move and deletion */
-	    placements[numplacements++] = p;
-	    swf_PlaceObjectFree(&p); //dirty! but it only frees fields we don't use
-	}
-	if(tag->id == ST_SHOWFRAME || tag->id == ST_END)
-	    break;
-        tag = tag->next;
-    }
+static void renderFromTag(RENDERBUF*buf, character_t*idtable, TAG*firstTag, MATRIX*m);
 
-    qsort(placements, numplacements, sizeof(SWFPLACEOBJECT), compare_placements);
-     
+static void renderPlacements(RENDERBUF*buf, character_t*idtable, SWFPLACEOBJECT*placements, int numplacements, MATRIX*m)
+{
     int t;
     for(t=0;t<numplacements;t++) {
         SWFPLACEOBJECT*p = &placements[t];
@@ -1242,24 +1474,52 @@ static void renderFromTag(RENDERBUF*buf, character_t*idtable, TAG*firstTag, MATR
             fprintf(stderr, "Unknown/Unsupported Object Type for id %d: %s\n", id, swf_TagGetName(idtable[id].tag));
         }
     }
+}
+
+static void renderFromTag(RENDERBUF*buf, character_t*idtable, TAG*firstTag, MATRIX*m)
+{
+    TAG*tag = 0;
+    int numplacements = 0;
+    SWFPLACEOBJECT* placements;
+
+    tag = firstTag;
+    numplacements = 0;
+    while(tag) {
+        if(tag->id == ST_PLACEOBJECT || 
+           tag->id == ST_PLACEOBJECT2) {
+	    numplacements++;
+	}
+	if(tag->id == ST_SHOWFRAME || tag->id == ST_END)
+	    break;
+	tag = tag->next;
+    }
+    placements = (SWFPLACEOBJECT*)rfx_calloc(sizeof(SWFPLACEOBJECT)*numplacements);
+    numplacements = 0;
+
+    tag = firstTag;
+    while(tag) {
+	if(swf_isPlaceTag(tag)) {
+	    SWFPLACEOBJECT p;
+	    swf_GetPlaceObject(tag, &p);
+	    /* TODO: add move and deletion */
+	    placements[numplacements++] = p;
+	    swf_PlaceObjectFree(&p); //dirty! but it only frees fields we don't use
+	}
+	if(tag->id == ST_SHOWFRAME || tag->id == ST_END)
+	    break;
+        tag = tag->next;
+    }
+
+    qsort(placements, numplacements, sizeof(SWFPLACEOBJECT), compare_placements);
+    renderPlacements(buf, idtable, placements, numplacements, m);
 
     free(placements);
 }
 
-void swf_RenderSWF(RENDERBUF*buf, SWF*swf)
+static character_t* idtable_new(RENDERBUF*buf, SWF*swf)
 {
     TAG*tag;
-    int t;
-    RGBA color;
-
-    swf_OptimizeTagOrder(swf);
-    swf_FoldAll(swf);
-    
     character_t* idtable = (character_t*)rfx_calloc(sizeof(character_t)*65536);            // id to character mapping
-    
-    /* set background color */
-    color = swf_GetSWFBackgroundColor(swf);
-    swf_Render_SetBackgroundColor(buf, color);
 
     /* parse definitions */
     tag = swf->firstTag;
@@ -1314,10 +1574,12 @@ void swf_RenderSWF(RENDERBUF*buf, SWF*swf)
         }
 	tag = tag->next;
     }
-    MATRIX m;
-    swf_GetMatrix(0, &m);
-    renderFromTag(buf, idtable, swf->firstTag, &m);
-    
+    return idtable;
+}
+
+static void idtable_free(character_t*idtable)
+{
+    int t;
     /* free id and depth tables again */
     for(t=0;t<65536;t++) {
         if(idtable[t].bbox) {
@@ -1349,4 +1611,298 @@ void swf_RenderSWF(RENDERBUF*buf, SWF*swf)
     }
     free(idtable);
 }
+
+void swf_RenderSWF(RENDERBUF*buf, SWF*swf)
+{
+    RGBA color;
+
+    swf_OptimizeTagOrder(swf);
+    swf_FoldAll(swf);
     
+    /* cached glyphs are keyed by font id, so they're only valid for one file */
+    glyphcache_clear((renderbuf_internal*)buf->internal);
+    
+    /* set background color */
+    color = swf_GetSWFBackgroundColor(swf);
+    swf_Render_SetBackgroundColor(buf, color);
+
+    character_t* idtable = idtable_new(buf, swf);
+
+    MATRIX m;
+    swf_GetMatrix(0, &m);
+    renderFromTag(buf, idtable, swf->firstTag, &m);
+    
+    idtable_free(idtable);
+}
+
+/* ---------------------- rendering of whole movies ---------------------- */
+
+#define MAX_DIRTY_RECTS 16
+
+typedef struct _dirtyrect {
+    int x1,y1,x2,y2;
+} dirtyrect_t;
+
+typedef struct _rendermovie_internal
+{
+    character_t*idtable;
+    TAG*tag; /* first tag of the next frame */
+    RGBA background;
+    SWFPLACEOBJECT**depths; /* display list */
+    int numplaced; /* number of occupied depths */
+    int maxdepth; /* all depths from here on are empty */
+
+    /* scratch space for render_rect */
+    SWFPLACEOBJECT*placements;
+    int placements_size;
+
+    dirtyrect_t dirty[MAX_DIRTY_RECTS];
+    int numdirty;
+} rendermovie_internal;
+
+/* bounding box of a placement, in internal pixels. Returns 0 if
+   it isn't known (e.g. for sprites) */
+static int placement_bbox(RENDERMOVIE*movie, SWFPLACEOBJECT*p, dirtyrect_t*r)
+{
+    rendermovie_internal*mi = (rendermovie_internal*)movie->internal;
+    renderbuf_internal*i = (renderbuf_internal*)movie->buf->internal;
+    character_t*c = &mi->idtable[p->id];
+    if(!c->tag || !c->bbox || c->type == sprite_type)
+	return 0;
+    SRECT b = swf_TurnRect(*c->bbox, &p->matrix);
+    int posx = movie->buf->posx*20;
+    int posy = movie->buf->posy*20;
+    /* add a few pixels of slack for anti-aliasing and minimum line widths */
+    r->x1 = (int)floor((b.xmin - posx)*i->multiply/20.0) - 2;
+    r->y1 = (int)floor((b.ymin - posy)*i->multiply/20.0) - 2;
+    r->x2 = (int)ceil((b.xmax - posx)*i->multiply/20.0) + 2;
+    r->y2 = (int)ceil((b.ymax - posy)*i->multiply/20.0) + 2;
+    return 1;
+}
+
+static void dirty_add(RENDERMOVIE*movie, dirtyrect_t r)
+{
+    rendermovie_internal*mi = (rendermovie_internal*)movie->internal;
+    renderbuf_internal*i = (renderbuf_internal*)movie->buf->internal;
+    int t;
+
+    if(r.x1 < 0) r.x1 = 0;
+    if(r.y1 < 0) r.y1 = 0;
+    if(r.x2 > i->width2) r.x2 = i->width2;
+    if(r.y2 > i->height2) r.y2 = i->height2;
+    if(r.x1 >= r.x2 || r.y1 >= r.y2)
+	return;
+
+    /* merge with all overlapping rectangles */
+    for(t=0;t<mi->numdirty;) {
+	dirtyrect_t*d = &mi->dirty[t];
+	if(d->x1 < r.x2 && r.x1 < d->x2 && d->y1 < r.y2 && r.y1 < d->y2) {
+	    if(d->x1 < r.x1) r.x1 = d->x1;
+	    if(d->y1 < r.y1) r.y1 = d->y1;
+	    if(d->x2 > r.x2) r.x2 = d->x2;
+	    if(d->y2 > r.y2) r.y2 = d->y2;
+	    mi->dirty[t] = mi->dirty[--mi->numdirty];
+	    t = 0;
+	} else {
+	    t++;
+	}
+    }
+    if(mi->numdirty == MAX_DIRTY_RECTS) {
+	/* too many rectangles- collapse them into one */
+	for(t=0;t<mi->numdirty;t++) {
+	    dirtyrect_t*d = &mi->dirty[t];
+	    if(d->x1 < r.x1) r.x1 = d->x1;
+	    if(d->y1 < r.y1) r.y1 = d->y1;
+	    if(d->x2 > r.x2) r.x2 = d->x2;
+	    if(d->y2 > r.y2) r.y2 = d->y2;
+	}
+	mi->numdirty = 0;
+    }
+    mi->dirty[mi->numdirty++] = r;
+}
+
+static void dirty_add_all(RENDERMOVIE*movie)
+{
+    renderbuf_internal*i = (renderbuf_internal*)movie->buf->internal;
+    dirtyrect_t r = {0, 0, i->width2, i->height2};
+    dirty_add(movie, r);
+}
+
+static void dirty_add_placement(RENDERMOVIE*movie, SWFPLACEOBJECT*p)
+{
+    dirtyrect_t r;
+    if(placement_bbox(movie, p, &r))
+	dirty_add(movie, r);
+    else
+	dirty_add_all(movie);
+}
+
+static void placement_free(SWFPLACEOBJECT*p)
+{
+    swf_PlaceObjectFree(p);
+    rfx_free(p);
+}
+
+/* re-render one rectangle of the canvas, from scratch */
+static void render_rect(RENDERMOVIE*movie, dirtyrect_t*r)
+{
+    rendermovie_internal*mi = (rendermovie_internal*)movie->internal;
+    RENDERBUF*buf = movie->buf;
+    renderbuf_internal*i = (renderbuf_internal*)buf->internal;
+    int width = r->x2 - r->x1;
+    int height = r->y2 - r->y1;
+    int t,y;
+
+    RENDERBUF tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    tmp.posx = buf->posx;
+    tmp.posy = buf->posy;
+    tmp.width = width;
+    tmp.height = height;
+    renderbuf_internal*ti = renderbuf_internal_new(width, height, i->antialize, i->multiply);
+    ti->xoffset = r->x1;
+    ti->yoffset = r->y1;
+    ti->bitmaps = i->bitmaps;
+    ti->glyphs = i->glyphs;
+    ti->glyphs_size = i->glyphs_size;
+    ti->glyphs_maxsize = i->glyphs_maxsize;
+    tmp.internal = ti;
+
+    swf_Render_SetBackgroundColor(&tmp, mi->background);
+
+    /* only objects intersecting the rectangle need to be drawn- except for
+       clip shapes, which also hide things outside of their own area */
+    int num = 0;
+    if(mi->placements_size < mi->numplaced) {
+	mi->placements_size = mi->numplaced;
+	mi->placements = (SWFPLACEOBJECT*)rfx_realloc(mi->placements, sizeof(SWFPLACEOBJECT)*mi->placements_size);
+    }
+    SWFPLACEOBJECT*placements = mi->placements;
+    for(t=0;t<mi->maxdepth;t++) {
+	SWFPLACEOBJECT*p = mi->depths[t];
+	dirtyrect_t b;
+	if(!p)
+	    continue;
+	if(!p->clipdepth && placement_bbox(movie, p, &b) &&
+	   (b.x2 <= r->x1 || b.x1 >= r->x2 || b.y2 <= r->y1 || b.y1 >= r->y2))
+	    continue;
+	placements[num++] = *p;
+    }
+    MATRIX m;
+    swf_GetMatrix(0, &m);
+    renderPlacements(&tmp, mi->idtable, placements, num, &m);
+
+    for(y=0;y<height;y++) {
+	memcpy(&i->img[(r->y1+y)*i->width2 + r->x1], &ti->img[y*width], sizeof(RGBA)*width);
+    }
+
+    i->glyphs = ti->glyphs;
+    i->glyphs_size = ti->glyphs_size;
+    ti->glyphs = 0;
+    ti->bitmaps = 0;
+    swf_Render_Delete(&tmp);
+}
+
+void swf_RenderMovie_Init(RENDERMOVIE*movie, RENDERBUF*buf, SWF*swf)
+{
+    memset(movie, 0, sizeof(RENDERMOVIE));
+    rendermovie_internal*mi = (rendermovie_internal*)rfx_calloc(sizeof(rendermovie_internal));
+    movie->internal = mi;
+    movie->buf = buf;
+
+    swf_OptimizeTagOrder(swf);
+    swf_FoldAll(swf);
+    movie->numframes = swf->frameCount;
+
+    glyphcache_clear((renderbuf_internal*)buf->internal);
+
+    mi->background = swf_GetSWFBackgroundColor(swf);
+    mi->idtable = idtable_new(buf, swf);
+    mi->depths = (SWFPLACEOBJECT**)rfx_calloc(sizeof(SWFPLACEOBJECT*)*65536);
+    mi->tag = swf->firstTag;
+}
+
+int swf_RenderMovie_NextFrame(RENDERMOVIE*movie)
+{
+    rendermovie_internal*mi = (rendermovie_internal*)movie->internal;
+    TAG*tag = mi->tag;
+    int t;
+
+    if(!tag)
+	return 0;
+
+    if(!movie->frame)
+	dirty_add_all(movie);
+
+    /* update the display list */
+    while(tag && tag->id != ST_SHOWFRAME && tag->id != ST_END) {
+	if(swf_isPlaceTag(tag)) {
+	    SWFPLACEOBJECT*p = (SWFPLACEOBJECT*)rfx_calloc(sizeof(SWFPLACEOBJECT));
+	    swf_GetPlaceObject(tag, p);
+	    SWFPLACEOBJECT*old = mi->depths[p->depth];
+	    if(old) {
+		if(p->move) {
+		    if(!(p->flags&PF_CHAR)) p->id = old->id;
+		    if(!(p->flags&PF_MATRIX)) p->matrix = old->matrix;
+		    if(!(p->flags&PF_CXFORM)) p->cxform = old->cxform;
+		    if(!(p->flags&PF_RATIO)) p->ratio = old->ratio;
+		    if(!(p->flags&PF_CLIPDEPTH)) p->clipdepth = old->clipdepth;
+		}
+		if(old->clipdepth != p->clipdepth) {
+		    /* the set of clipped objects changed */
+		    dirty_add_all(movie);
+		}
+		dirty_add_placement(movie, old);
+		placement_free(old);
+	    } else {
+		mi->numplaced++;
+	    }
+	    dirty_add_placement(movie, p);
+	    mi->depths[p->depth] = p;
+	    if(p->depth >= mi->maxdepth)
+		mi->maxdepth = p->depth+1;
+	} else if(tag->id == ST_REMOVEOBJECT || tag->id == ST_REMOVEOBJECT2) {
+	    U16 depth = swf_GetDepth(tag);
+	    SWFPLACEOBJECT*old = mi->depths[depth];
+	    if(old) {
+		dirty_add_placement(movie, old);
+		placement_free(old);
+		mi->depths[depth] = 0;
+		mi->numplaced--;
+	    }
+	}
+	tag = tag->next;
+    }
+
+    if(!tag || tag->id == ST_END) {
+	mi->tag = 0;
+	/* a movie without any ShowFrame still has one frame */
+	if(movie->frame)
+	    return 0;
+    } else {
+	mi->tag = tag->next;
+    }
+
+    for(t=0;t<mi->numdirty;t++) {
+	render_rect(movie, &mi->dirty[t]);
+    }
+    mi->numdirty = 0;
+    movie->frame++;
+    return 1;
+}
+
+void swf_RenderMovie_Delete(RENDERMOVIE*movie)
+{
+    rendermovie_internal*mi = (rendermovie_internal*)movie->internal;
+    int t;
+    for(t=0;t<65536;t++) {
+	if(mi->depths[t]) {
+	    placement_free(mi->depths[t]);
+	}
+    }
+    rfx_free(mi->depths);
+    rfx_free(mi->placements);
+    idtable_free(mi->idtable);
+    rfx_free(mi);
+    movie->internal = 0;
+}
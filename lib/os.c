@@ -45,6 +45,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
 #else
 #undef HAVE_STAT
 #endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 #if defined(CYGWIN)
 char path_seperator = '/';
@@ -323,3 +326,170 @@ char file_exists(const char*filename)
     return 0;
 #endif
 }
+
+int get_num_cpus()
+{
+#if defined(WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors>0?info.dwNumberOfProcessors:1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long num = sysconf(_SC_NPROCESSORS_ONLN);
+    return num>0?num:1;
+#else
+    return 1;
+#endif
+}
+
+#ifdef HAVE_PTHREAD_H
+typedef struct _parallel_job {
+    pthread_mutex_t mutex;
+    int next;
+    int num;
+    void (*f)(void*data, int nr);
+    void*data;
+} parallel_job_t;
+
+static void* parallel_worker(void*_job)
+{
+    parallel_job_t*job = (parallel_job_t*)_job;
+    while(1) {
+	pthread_mutex_lock(&job->mutex);
+	int nr = job->next++;
+	pthread_mutex_unlock(&job->mutex);
+	if(nr >= job->num)
+	    break;
+	job->f(job->data, nr);
+    }
+    return 0;
+}
+#endif
+
+void parallel_for(int num, void (*f)(void*data, int nr), void*data, int num_threads)
+{
+    int t;
+    if(num_threads <= 0)
+	num_threads = get_num_cpus();
+    if(num_threads > num)
+	num_threads = num;
+#ifdef HAVE_PTHREAD_H
+    if(num_threads > 1) {
+	parallel_job_t job;
+	pthread_t*threads = (pthread_t*)malloc(sizeof(pthread_t)*num_threads);
+	pthread_mutex_init(&job.mutex, 0);
+	job.next = 0;
+	job.num = num;
+	job.f = f;
+	job.data = data;
+	/* the calling thread works, too */
+	for(t=1;t<num_threads;t++) {
+	    if(pthread_create(&threads[t], 0, parallel_worker, &job)) {
+		num_threads = t;
+		break;
+	    }
+	}
+	parallel_worker(&job);
+	for(t=1;t<num_threads;t++) {
+	    pthread_join(threads[t], 0);
+	}
+	pthread_mutex_destroy(&job.mutex);
+	free(threads);
+	return;
+    }
+#endif
+    for(t=0;t<num;t++) {
+	f(data, t);
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+typedef struct _pipeline_job {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int next;
+    int consumed;
+    int num;
+    int max_pending;
+    char*done;
+    void (*produce)(void*data, int nr);
+    void*data;
+} pipeline_job_t;
+
+static void* pipeline_worker(void*_job)
+{
+    pipeline_job_t*job = (pipeline_job_t*)_job;
+    pthread_mutex_lock(&job->mutex);
+    while(1) {
+	while(job->next < job->num && job->next >= job->consumed + job->max_pending)
+	    pthread_cond_wait(&job->cond, &job->mutex);
+	if(job->next >= job->num)
+	    break;
+	int nr = job->next++;
+	pthread_mutex_unlock(&job->mutex);
+	job->produce(job->data, nr);
+	pthread_mutex_lock(&job->mutex);
+	job->done[nr] = 1;
+	pthread_cond_broadcast(&job->cond);
+    }
+    pthread_mutex_unlock(&job->mutex);
+    return 0;
+}
+#endif
+
+void parallel_pipeline(int num, void (*produce)(void*data, int nr), void (*consume)(void*data, int nr), void*data, int num_threads, int max_pending)
+{
+    int t;
+    if(num_threads <= 0)
+	num_threads = get_num_cpus();
+    if(num_threads > num)
+	num_threads = num;
+    if(max_pending < num_threads)
+	max_pending = max_pending>0 ? num_threads : num_threads*2;
+#ifdef HAVE_PTHREAD_H
+    if(num_threads > 1) {
+	pipeline_job_t job;
+	pthread_t*threads = (pthread_t*)malloc(sizeof(pthread_t)*num_threads);
+	pthread_mutex_init(&job.mutex, 0);
+	pthread_cond_init(&job.cond, 0);
+	job.next = 0;
+	job.consumed = 0;
+	job.num = num;
+	job.max_pending = max_pending;
+	job.done = (char*)calloc(num, 1);
+	job.produce = produce;
+	job.data = data;
+	/* the calling thread only consumes, which is typically cheap */
+	int started;
+	for(started=0;started<num_threads;started++) {
+	    if(pthread_create(&threads[started], 0, pipeline_worker, &job))
+		break;
+	}
+	if(started) {
+	    for(t=0;t<num;t++) {
+		pthread_mutex_lock(&job.mutex);
+		while(!job.done[t])
+		    pthread_cond_wait(&job.cond, &job.mutex);
+		pthread_mutex_unlock(&job.mutex);
+		consume(data, t);
+		pthread_mutex_lock(&job.mutex);
+		job.consumed = t+1;
+		pthread_cond_broadcast(&job.cond);
+		pthread_mutex_unlock(&job.mutex);
+	    }
+	    for(t=0;t<started;t++) {
+		pthread_join(threads[t], 0);
+	    }
+	}
+	pthread_cond_destroy(&job.cond);
+	pthread_mutex_destroy(&job.mutex);
+	free(job.done);
+	free(threads);
+	if(started)
+	    return;
+    }
+#endif
+    for(t=0;t<num;t++) {
+	produce(data, t);
+	consume(data, t);
+    }
+}
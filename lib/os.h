@@ -52,6 +52,19 @@ char* mktempname(char*buffer, const char*ext);
 void move_file(const char*from, const char*to);
 char file_exists(const char*filename);
 
+int get_num_cpus();
+
+/* call f(data, 0) ... f(data, num-1) from up to num_threads threads
+   (0 = one per processor), and wait for all of them to finish */
+void parallel_for(int num, void (*f)(void*data, int nr), void*data, int num_threads);
+
+/* call produce(data, 0) ... produce(data, num-1) from up to num_threads
+   worker threads (0 = one per processor), and consume(data, 0) ...
+   consume(data, num-1) in order from the calling thread, as soon as the
+   respective produce() has finished. At most max_pending items (0 = two
+   per thread) are produced but not yet consumed at any time. */
+void parallel_pipeline(int num, void (*produce)(void*data, int nr), void (*consume)(void*data, int nr), void*data, int num_threads, int max_pending);
+
 #ifdef __cplusplus
 }
 #endif
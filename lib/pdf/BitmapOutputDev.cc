@@ -40,6 +40,7 @@
 #include "../png.h"
 #include "../devices/record.h"
 #include "../gfxtools.h"
+#include "../pixelops/pixelops.h"
 #include "../types.h"
 #include "bbox.h"
 
@@ -267,30 +268,21 @@ void BitmapOutputDev::flushBitmap()
 	    Guchar*ain = &alpha[(y+ymin)*bitmap_width+xmin];
 	    Guchar*ain2 = &alpha2[(y+ymin)*bitmap_width8];
 	    if(this->emptypage) {
-		for(x=0;x<rangex;x++) {
-		    /* the first bitmap on the page doesn't need to have an alpha channel-
-		       blend against a white background*/
-		    out[x].r = (in[x*3+0]*ain[x])/255 + 255-ain[x];
-		    out[x].g = (in[x*3+1]*ain[x])/255 + 255-ain[x];
-		    out[x].b = (in[x*3+2]*ain[x])/255 + 255-ain[x];
-		    out[x].a = 255;
-		}
+		/* the first bitmap on the page doesn't need to have an alpha channel-
+		   blend against a white background*/
+		pixelops_rgb_alpha_to_argb(out, in, ain, rangex, 1);
 	    } else {
+		/* according to endPage()/compositeBackground() in xpdf/SplashOutputDev.cc, this
+		   data has non-premultiplied alpha, which is exactly what the output device 
+		   expects, so don't premultiply it here, either.
+		*/
+		pixelops_rgb_alpha_to_argb(out, in, ain, rangex, 0);
 		for(x=0;x<rangex;x++) {
 		    if(!(ain2[(x+xmin)/8]&(0x80>>((x+xmin)&7)))) {
 			/* cut away pixels that we don't remember drawing (i.e., that are
 			   not in the monochrome bitmap). Prevents some "hairlines" showing
 			   up to the left and right of bitmaps. */
 			out[x].r = 0;out[x].g = 0;out[x].b = 0;out[x].a = 0;
-		    } else {
-			/* according to endPage()/compositeBackground() in xpdf/SplashOutputDev.cc, this
-			   data has non-premultiplied alpha, which is exactly what the output device 
-			   expects, so don't premultiply it here, either.
-			*/
-			out[x].r = in[x*3+0];
-			out[x].g = in[x*3+1];
-			out[x].b = in[x*3+2];
-			out[x].a = ain[x];
 		    }
 		}
 	    }
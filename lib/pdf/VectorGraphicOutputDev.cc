@@ -41,6 +41,7 @@
 #include "../gfxdevice.h"
 #include "../gfxtools.h"
 #include "../gfxfont.h"
+#include "../gfximage.h"
 #include "../gfxpoly.h"
 #include "../devices/record.h"
 #include "../devices/ops.h"
@@ -1029,7 +1030,8 @@ static void drawimage(gfxdevice_t*dev, gfxcolor_t* data, int sizex,int sizey,
         double x1,double y1,
         double x2,double y2,
         double x3,double y3,
-        double x4,double y4, int type, int multiply)
+        double x4,double y4, int type, int multiply,
+	const unsigned char*jpeg, int jpeglen)
 {
     gfxcolor_t*newpic=0;
     
@@ -1071,20 +1073,135 @@ static void drawimage(gfxdevice_t*dev, gfxcolor_t* data, int sizex,int sizey,
 	/* TODO: pass image_dpi to device instead */
 	dev->setparameter(dev, "next_bitmap_is_jpeg", "1");
 
+    if(jpeg)
+	gfximage_attach_jpeg(&img, jpeg, jpeglen);
+
     dump_outline(&p1);
     dev->fillbitmap(dev, &p1, &img, &m, 0);
+
+    if(jpeg)
+	gfximage_detach_jpeg(&img);
 }
 
 void drawimagejpeg(gfxdevice_t*dev, gfxcolor_t*mem, int sizex,int sizey, 
-        double x1,double y1, double x2,double y2, double x3,double y3, double x4,double y4, int multiply)
+        double x1,double y1, double x2,double y2, double x3,double y3, double x4,double y4, int multiply,
+	const unsigned char*jpeg, int jpeglen)
 {
-    drawimage(dev,mem,sizex,sizey,x1,y1,x2,y2,x3,y3,x4,y4, IMAGE_TYPE_JPEG, multiply);
+    drawimage(dev,mem,sizex,sizey,x1,y1,x2,y2,x3,y3,x4,y4, IMAGE_TYPE_JPEG, multiply, jpeg, jpeglen);
 }
 
 void drawimagelossless(gfxdevice_t*dev, gfxcolor_t*mem, int sizex,int sizey, 
         double x1,double y1, double x2,double y2, double x3,double y3, double x4,double y4, int multiply)
 {
-    drawimage(dev,mem,sizex,sizey,x1,y1,x2,y2,x3,y3,x4,y4, IMAGE_TYPE_LOSSLESS, multiply);
+    drawimage(dev,mem,sizex,sizey,x1,y1,x2,y2,x3,y3,x4,y4, IMAGE_TYPE_LOSSLESS, multiply, 0, 0);
+}
+
+/* checks that data is a baseline JPEG with the given size whose three
+   components are stored as YCbCr (so that it decodes to the same pixels
+   in the Flash player as in xpdf), and returns its length without
+   anything following the EOI marker. Returns 0 otherwise. */
+static int jpeg_check_passthrough(const unsigned char*data, int len, int width, int height)
+{
+    if(len<4 || data[0]!=0xff || data[1]!=0xd8)
+	return 0;
+    int pos = 2;
+    char have_sof = 0;
+    while(pos+4 <= len) {
+	if(data[pos]!=0xff)
+	    return 0;
+	int marker = data[pos+1];
+	if(marker==0xff) {
+	    pos++;
+	    continue;
+	}
+	int l = data[pos+2]<<8|data[pos+3];
+	if(l<2 || pos+2+l > len)
+	    return 0;
+	const unsigned char*seg = &data[pos+4];
+	if(marker==0xc0) {
+	    if(l<8 || seg[0]!=8 || (seg[1]<<8|seg[2])!=height || (seg[3]<<8|seg[4])!=width || seg[5]!=3)
+		return 0;
+	    have_sof = 1;
+	} else if(marker>=0xc1 && marker<=0xcf && marker!=0xc4 && marker!=0xc8 && marker!=0xcc) {
+	    /* progressive, lossless or arithmetic coded */
+	    return 0;
+	} else if(marker==0xee) {
+	    /* Adobe: the transform flag needs to say YCbCr */
+	    if(l>=14 && !memcmp(seg, "Adobe", 5) && seg[11]!=1)
+		return 0;
+	} else if(marker==0xda) {
+	    break;
+	}
+	pos += 2+l;
+    }
+    if(!have_sof)
+	return 0;
+    while(len>=2 && !(data[len-2]==0xff && data[len-1]==0xd9))
+	len--;
+    return len>pos ? len : 0;
+}
+
+/* returns the compressed data of a DCTDecode image, if the pixels
+   xpdf produces for it are exactly what the JPEG decodes to */
+static unsigned char* get_passthrough_jpeg(Stream*str, GfxImageColorMap*colorMap, int width, int height, int*len)
+{
+    if(str->getKind()!=strDCT || !colorMap)
+	return 0;
+    GfxColorSpace*cs = colorMap->getColorSpace();
+    if(colorMap->getNumPixelComps()!=3 || colorMap->getBits()!=8 ||
+       !(cs->getMode()==csDeviceRGB || (cs->getMode()==csICCBased && cs->getNComps()==3)))
+	return 0;
+    int t;
+    for(t=0;t<3;t++) {
+	if(colorMap->getDecodeLow(t)!=0 || colorMap->getDecodeHigh(t)!=1)
+	    return 0;
+    }
+    /* only plain DCTDecode, so that DecodeParms is a single dictionary */
+    Stream*raw = str->getNextStream();
+    if(!raw || raw->getBaseStream()!=raw)
+	return 0;
+    Object obj;
+    Dict*dict = str->getDict();
+    if(dict) {
+	dict->lookup((char*)"DecodeParms", &obj);
+	if(obj.isNull()) {
+	    obj.free();
+	    dict->lookup((char*)"DP", &obj);
+	}
+	if(obj.isDict()) {
+	    Object xform;
+	    if(obj.dictLookup((char*)"ColorTransform", &xform)->isInt() && xform.getInt()!=1) {
+		xform.free();obj.free();
+		return 0;
+	    }
+	    xform.free();
+	} else if(!obj.isNull()) {
+	    obj.free();
+	    return 0;
+	}
+	obj.free();
+    }
+
+    int size = 0, pos = 0;
+    unsigned char*data = 0;
+    raw->reset();
+    while(1) {
+	if(pos == size) {
+	    size = size ? size*2 : 65536;
+	    data = (unsigned char*)rfx_realloc(data, size);
+	}
+	int c = raw->getChar();
+	if(c == EOF)
+	    break;
+	data[pos++] = c;
+    }
+    raw->close();
+    *len = jpeg_check_passthrough(data, pos, width, height);
+    if(!*len) {
+	free(data);
+	return 0;
+    }
+    return data;
 }
 
 
@@ -1146,6 +1263,13 @@ void VectorGraphicOutputDev::drawGeneralImage(GfxState *state, Object *ref, Stre
       maskStr->close();
   }
   
+  /* if nothing needs to be done to a JPEG, give the device the original data,
+     too. This needs to happen before imgStr starts reading the stream. */
+  unsigned char*jpeg = 0;
+  int jpeglen = 0;
+  if(!mask && !maskColors && !maskStr && !inlineImg && config_multiply==1)
+      jpeg = get_passthrough_jpeg(str, colorMap, width, height, &jpeglen);
+
   imgStr = new ImageStream(str, width, ncomps,bits);
   imgStr->reset();
 
@@ -1161,6 +1285,8 @@ void VectorGraphicOutputDev::drawGeneralImage(GfxState *state, Object *ref, Stre
       delete imgStr;
       if(maskbitmap)
 	  free(maskbitmap);
+      if(jpeg)
+	  free(jpeg);
       return;
   }
 
@@ -1295,12 +1421,13 @@ void VectorGraphicOutputDev::drawGeneralImage(GfxState *state, Object *ref, Stre
 	}
       }
       if(str->getKind()==strDCT)
-	  drawimagejpeg(device, pic, width, height, x1,y1,x2,y2,x3,y3,x4,y4, config_multiply);
+	  drawimagejpeg(device, pic, width, height, x1,y1,x2,y2,x3,y3,x4,y4, config_multiply, jpeg, jpeglen);
       else
 	  drawimagelossless(device, pic, width, height, x1,y1,x2,y2,x3,y3,x4,y4, config_multiply);
       delete[] pic;
       delete imgStr;
       if(maskbitmap) free(maskbitmap);
+      if(jpeg) free(jpeg);
       return;
   } else {
       gfxcolor_t*pic=new gfxcolor_t[width*height];
@@ -0,0 +1,41 @@
+#ifndef __pixelops_kernels_h__
+#define __pixelops_kernels_h__
+
+/* The SIMD kernels are compiled with per-function target attributes, so
+   the rest of the library doesn't need any special compiler flags. */
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define PIXELOPS_X86
+#endif
+
+/* reference implementations (pixelops.c). The SIMD kernels use these for
+   the pixels at the end of a line which don't fill a whole register. */
+void premultiply_c(unsigned char*p, int num);
+void unpremultiply_c(unsigned char*dest, const unsigned char*src, int num);
+int has_alpha_c(const unsigned char*p, int num);
+void cxform_c(unsigned char*p, int num, const int*m);
+void rgb_alpha_to_argb_c(unsigned char*dest, const unsigned char*rgb, const unsigned char*alpha, int num, char on_white);
+void argb_to_yuv_c(unsigned char*yuv, const unsigned char*argb, int num);
+void yuv_to_argb_c(unsigned char*argb, const unsigned char*yuv, int num);
+void resample_h_c(unsigned char*dest, const unsigned char*src, int num, const int*bounds, const short*weights, int ksize);
+void resample_v_c(unsigned char*dest, const unsigned char*const*rows, const short*weights, int count, int num, int offset);
+
+#ifdef PIXELOPS_X86
+/* x86.c */
+void x86_init();
+void premultiply_sse2(unsigned char*p, int num);
+void premultiply_avx2(unsigned char*p, int num);
+void unpremultiply_sse2(unsigned char*dest, const unsigned char*src, int num);
+int has_alpha_sse2(const unsigned char*p, int num);
+int has_alpha_avx2(const unsigned char*p, int num);
+void cxform_sse2(unsigned char*p, int num, const int*m);
+void cxform_avx2(unsigned char*p, int num, const int*m);
+void rgb_alpha_to_argb_ssse3(unsigned char*dest, const unsigned char*rgb, const unsigned char*alpha, int num, char on_white);
+void argb_to_yuv_ssse3(unsigned char*yuv, const unsigned char*argb, int num);
+void yuv_to_argb_ssse3(unsigned char*argb, const unsigned char*yuv, int num);
+void resample_h_sse2(unsigned char*dest, const unsigned char*src, int num, const int*bounds, const short*weights, int ksize);
+void resample_v_sse2(unsigned char*dest, const unsigned char*const*rows, const short*weights, int count, int num);
+void resample_v_avx2(unsigned char*dest, const unsigned char*const*rows, const short*weights, int count, int num);
+#endif
+
+#endif
@@ -0,0 +1,349 @@
+/* pixelops.c
+
+   Per-pixel kernels for image preparation: reference implementations,
+   and selection of the SIMD versions at runtime.
+
+   Part of the swftools package.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#include <stdlib.h>
+#include "../../config.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#include "pixelops.h"
+#include "kernels.h"
+
+void premultiply_c(unsigned char*p, int num)
+{
+    int t;
+    for(t=0;t<num;t++) {
+	p[1] = ((int)p[1]*p[0])/255;
+	p[2] = ((int)p[2]*p[0])/255;
+	p[3] = ((int)p[3]*p[0])/255;
+	p += 4;
+    }
+}
+
+void unpremultiply_c(unsigned char*dest, const unsigned char*src, int num)
+{
+    int t;
+    for(t=0;t<num;t++) {
+	unsigned int alpha = src[0];
+	if(alpha)
+	    alpha = 0xff0000/alpha;
+	dest[0] = src[0];
+	dest[1] = (src[1]*alpha)>>16;
+	dest[2] = (src[2]*alpha)>>16;
+	dest[3] = (src[3]*alpha)>>16;
+	dest += 4;
+	src += 4;
+    }
+}
+
+int has_alpha_c(const unsigned char*p, int num)
+{
+    int t;
+    int hasalpha=0;
+    for(t=0;t<num;t++) {
+	if(p[t*4] >= 4 && p[t*4] < 0xfc)
+	    return 2;
+	if(p[t*4] < 4)
+	    hasalpha=1;
+    }
+    return hasalpha;
+}
+
+void cxform_c(unsigned char*p, int num, const int*m)
+{
+    int t;
+    for(t=0;t<num;t++) {
+	unsigned char a = (p[0]*m[0] + p[1]*m[1] + p[2]*m[2] + p[3]*m[3] + m[4]) / 256;
+	unsigned char r = (p[0]*m[5] + p[1]*m[6] + p[2]*m[7] + p[3]*m[8] + m[9]) / 256;
+	unsigned char g = (p[0]*m[10] + p[1]*m[11] + p[2]*m[12] + p[3]*m[13] + m[14]) / 256;
+	unsigned char b = (p[0]*m[15] + p[1]*m[16] + p[2]*m[17] + p[3]*m[18] + m[19]) / 256;
+	p[0] = a;
+	p[1] = r;
+	p[2] = g;
+	p[3] = b;
+	p += 4;
+    }
+}
+
+void rgb_alpha_to_argb_c(unsigned char*dest, const unsigned char*rgb, const unsigned char*alpha, int num, char on_white)
+{
+    int t;
+    if(on_white) {
+	for(t=0;t<num;t++) {
+	    dest[t*4+0] = 255;
+	    dest[t*4+1] = (rgb[t*3+0]*alpha[t])/255 + 255-alpha[t];
+	    dest[t*4+2] = (rgb[t*3+1]*alpha[t])/255 + 255-alpha[t];
+	    dest[t*4+3] = (rgb[t*3+2]*alpha[t])/255 + 255-alpha[t];
+	}
+    } else {
+	for(t=0;t<num;t++) {
+	    dest[t*4+0] = alpha[t];
+	    dest[t*4+1] = rgb[t*3+0];
+	    dest[t*4+2] = rgb[t*3+1];
+	    dest[t*4+3] = rgb[t*3+2];
+	}
+    }
+}
+
+void argb_to_yuv_c(unsigned char*yuv, const unsigned char*argb, int num)
+{
+    int t;
+    for(t=0;t<num;t++) {
+	int r = argb[t*4+1];
+	int g = argb[t*4+2];
+	int b = argb[t*4+3];
+	yuv[t*3+0] = (r*((int)( 0.299*256)) + g*((int)( 0.587*256)) + b*((int)( 0.114 *256)))>>8;
+	yuv[t*3+1] = (r*((int)(-0.169*256)) + g*((int)(-0.332*256)) + b*((int)( 0.500 *256))+ 128*256)>>8;
+	yuv[t*3+2] = (r*((int)( 0.500*256)) + g*((int)(-0.419*256)) + b*((int)(-0.0813*256))+ 128*256)>>8;
+    }
+}
+
+static inline int truncate256(int a)
+{
+    if(a>255) return 255;
+    if(a<0) return 0;
+    return a;
+}
+
+void yuv_to_argb_c(unsigned char*argb, const unsigned char*yuv, int num)
+{
+    int t;
+    for(t=0;t<num;t++) {
+	int yy = yuv[t*3+0];
+	int u = yuv[t*3+1];
+	int v = yuv[t*3+2];
+	argb[t*4+1] = truncate256(yy + ((360*(v-128))>>8));
+	argb[t*4+2] = truncate256(yy - ((88*(u-128)+183*(v-128))>>8));
+	argb[t*4+3] = truncate256(yy + ((455 * (u-128))>>8));
+    }
+}
+
+static inline unsigned char round_weighted(int v)
+{
+    v = (v + (1<<(PIXELOPS_WEIGHT_BITS-1))) >> PIXELOPS_WEIGHT_BITS;
+    if(v>255) return 255;
+    if(v<0) return 0;
+    return v;
+}
+
+void resample_h_c(unsigned char*dest, const unsigned char*src, int num, const int*bounds, const short*weights, int ksize)
+{
+    int x;
+    for(x=0;x<num;x++) {
+	const unsigned char*s = &src[bounds[x*2]*4];
+	const short*w = &weights[x*ksize];
+	int count = bounds[x*2+1];
+	int a=0,r=0,g=0,b=0;
+	int k;
+	for(k=0;k<count;k++) {
+	    a += s[k*4+0]*w[k];
+	    r += s[k*4+1]*w[k];
+	    g += s[k*4+2]*w[k];
+	    b += s[k*4+3]*w[k];
+	}
+	dest[x*4+0] = round_weighted(a);
+	dest[x*4+1] = round_weighted(r);
+	dest[x*4+2] = round_weighted(g);
+	dest[x*4+3] = round_weighted(b);
+    }
+}
+
+/* works on bytes offset..num*4-1 of the rows, so the SIMD versions can hand
+   over the end of a row */
+void resample_v_c(unsigned char*dest, const unsigned char*const*rows, const short*weights, int count, int num, int offset)
+{
+    int t;
+    for(t=offset;t<num*4;t++) {
+	int v = 0;
+	int k;
+	for(k=0;k<count;k++) {
+	    v += rows[k][t]*weights[k];
+	}
+	dest[t] = round_weighted(v);
+    }
+}
+
+static int cpu_level = PIXELOPS_SCALAR;
+static int max_level = PIXELOPS_AVX2;
+
+static void pixelops_init()
+{
+#ifdef PIXELOPS_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+	cpu_level = PIXELOPS_AVX2;
+    else if(__builtin_cpu_supports("ssse3"))
+	cpu_level = PIXELOPS_SSSE3;
+    else if(__builtin_cpu_supports("sse2"))
+	cpu_level = PIXELOPS_SSE2;
+    x86_init();
+#endif
+}
+
+#ifdef HAVE_PTHREAD_H
+static pthread_once_t pixelops_once = PTHREAD_ONCE_INIT;
+#else
+static char initialized = 0;
+#endif
+
+int pixelops_get_level()
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_once(&pixelops_once, pixelops_init);
+#else
+    if(!initialized) {
+	pixelops_init();
+	initialized = 1;
+    }
+#endif
+    return cpu_level < max_level ? cpu_level : max_level;
+}
+
+void pixelops_set_level(int level)
+{
+    max_level = level;
+}
+
+void pixelops_premultiply(void*argb, int num)
+{
+#ifdef PIXELOPS_X86
+    int level = pixelops_get_level();
+    if(level >= PIXELOPS_AVX2) {
+	premultiply_avx2((unsigned char*)argb, num);
+	return;
+    }
+    if(level >= PIXELOPS_SSE2) {
+	premultiply_sse2((unsigned char*)argb, num);
+	return;
+    }
+#endif
+    premultiply_c((unsigned char*)argb, num);
+}
+
+void pixelops_unpremultiply(void*dest, const void*src, int num)
+{
+#ifdef PIXELOPS_X86
+    if(pixelops_get_level() >= PIXELOPS_SSE2) {
+	unpremultiply_sse2((unsigned char*)dest, (const unsigned char*)src, num);
+	return;
+    }
+#endif
+    unpremultiply_c((unsigned char*)dest, (const unsigned char*)src, num);
+}
+
+int pixelops_has_alpha(const void*argb, int num)
+{
+#ifdef PIXELOPS_X86
+    int level = pixelops_get_level();
+    if(level >= PIXELOPS_AVX2)
+	return has_alpha_avx2((const unsigned char*)argb, num);
+    if(level >= PIXELOPS_SSE2)
+	return has_alpha_sse2((const unsigned char*)argb, num);
+#endif
+    return has_alpha_c((const unsigned char*)argb, num);
+}
+
+void pixelops_cxform(void*argb, int num, const int*m)
+{
+#ifdef PIXELOPS_X86
+    /* the SIMD versions multiply in 16 bit */
+    char small = 1;
+    int t;
+    for(t=0;t<20;t++) {
+	if(t%5 == 4) {
+	    if(m[t] < -0x1000000 || m[t] > 0x1000000)
+		small = 0;
+	} else if(m[t] < -0x8000 || m[t] > 0x7fff) {
+	    small = 0;
+	}
+    }
+    int level = small ? pixelops_get_level() : PIXELOPS_SCALAR;
+    if(level >= PIXELOPS_AVX2) {
+	cxform_avx2((unsigned char*)argb, num, m);
+	return;
+    }
+    if(level >= PIXELOPS_SSE2) {
+	cxform_sse2((unsigned char*)argb, num, m);
+	return;
+    }
+#endif
+    cxform_c((unsigned char*)argb, num, m);
+}
+
+void pixelops_rgb_alpha_to_argb(void*dest, const unsigned char*rgb, const unsigned char*alpha, int num, char on_white)
+{
+#ifdef PIXELOPS_X86
+    if(pixelops_get_level() >= PIXELOPS_SSSE3) {
+	rgb_alpha_to_argb_ssse3((unsigned char*)dest, rgb, alpha, num, on_white);
+	return;
+    }
+#endif
+    rgb_alpha_to_argb_c((unsigned char*)dest, rgb, alpha, num, on_white);
+}
+
+void pixelops_argb_to_yuv(void*yuv, const void*argb, int num)
+{
+#ifdef PIXELOPS_X86
+    if(pixelops_get_level() >= PIXELOPS_SSSE3) {
+	argb_to_yuv_ssse3((unsigned char*)yuv, (const unsigned char*)argb, num);
+	return;
+    }
+#endif
+    argb_to_yuv_c((unsigned char*)yuv, (const unsigned char*)argb, num);
+}
+
+void pixelops_yuv_to_argb(void*argb, const void*yuv, int num)
+{
+#ifdef PIXELOPS_X86
+    if(pixelops_get_level() >= PIXELOPS_SSSE3) {
+	yuv_to_argb_ssse3((unsigned char*)argb, (const unsigned char*)yuv, num);
+	return;
+    }
+#endif
+    yuv_to_argb_c((unsigned char*)argb, (const unsigned char*)yuv, num);
+}
+
+void pixelops_resample_h(void*dest, const void*src, int num, const int*bounds, const short*weights, int ksize)
+{
+#ifdef PIXELOPS_X86
+    if(pixelops_get_level() >= PIXELOPS_SSE2) {
+	resample_h_sse2((unsigned char*)dest, (const unsigned char*)src, num, bounds, weights, ksize);
+	return;
+    }
+#endif
+    resample_h_c((unsigned char*)dest, (const unsigned char*)src, num, bounds, weights, ksize);
+}
+
+void pixelops_resample_v(void*dest, const void*const*rows, const short*weights, int count, int num)
+{
+#ifdef PIXELOPS_X86
+    int level = pixelops_get_level();
+    if(level >= PIXELOPS_AVX2) {
+	resample_v_avx2((unsigned char*)dest, (const unsigned char*const*)rows, weights, count, num);
+	return;
+    }
+    if(level >= PIXELOPS_SSE2) {
+	resample_v_sse2((unsigned char*)dest, (const unsigned char*const*)rows, weights, count, num);
+	return;
+    }
+#endif
+    resample_v_c((unsigned char*)dest, (const unsigned char*const*)rows, weights, count, num, 0);
+}
@@ -0,0 +1,85 @@
+/* pixelops.h
+
+   Per-pixel kernels for image preparation (header file).
+
+   Part of the swftools package.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#ifndef __pixelops_h__
+#define __pixelops_h__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* All 32 bit pixels are stored as bytes a,r,g,b (the layout of RGBA and
+   gfxcolor_t). YUV pixels are stored as bytes y,u,v (the layout of YUV).
+   Every function produces exactly the same results as the scalar code it
+   replaced, on every instruction set. */
+
+#define PIXELOPS_SCALAR 0
+#define PIXELOPS_SSE2 1
+#define PIXELOPS_SSSE3 2
+#define PIXELOPS_AVX2 3
+
+/* the best instruction set the processor supports (and that was
+   compiled in), limited by pixelops_set_level() */
+int pixelops_get_level();
+/* don't use anything better than level. Mostly for testing. */
+void pixelops_set_level(int level);
+
+/* c = c*a/255 */
+void pixelops_premultiply(void*argb, int num);
+
+/* src has premultiplied alpha. Uses the fixed point inverse the SWF
+   reader always used: c = (c*(0xff0000/a))>>16 */
+void pixelops_unpremultiply(void*dest, const void*src, int num);
+
+/* 0: all pixels are opaque (alpha>=0xfc)
+   1: some pixels are transparent (alpha<4)
+   2: some pixels are semi-transparent */
+int pixelops_has_alpha(const void*argb, int num);
+
+/* m[0..4], m[5..9], m[10..14], m[15..19] compute the new a, r, g and b:
+   new = (a*m[0] + r*m[1] + g*m[2] + b*m[3] + m[4]) / 256 */
+void pixelops_cxform(void*argb, int num, const int*m);
+
+/* interleave a rgb image (3 bytes per pixel) and an alpha channel. If
+   on_white is set, the image is composited onto a white background
+   instead, and the result is opaque. */
+void pixelops_rgb_alpha_to_argb(void*dest, const unsigned char*rgb, const unsigned char*alpha, int num, char on_white);
+
+void pixelops_argb_to_yuv(void*yuv, const void*argb, int num);
+/* leaves the alpha channel of argb alone */
+void pixelops_yuv_to_argb(void*argb, const void*yuv, int num);
+
+/* resampling weights are fixed point numbers with this many fractional bits */
+#define PIXELOPS_WEIGHT_BITS 14
+
+/* one row of a horizontal resampling pass. Pixel x of dest is the sum of
+   weights[x*ksize+k]*src[bounds[x*2]+k] for 0 <= k < bounds[x*2+1].
+   Each channel is rounded, and clamped to 0..255. */
+void pixelops_resample_h(void*dest, const void*src, int num, const int*bounds, const short*weights, int ksize);
+
+/* one row of a vertical resampling pass: dest is the sum of
+   weights[k]*rows[k] for 0 <= k < count. */
+void pixelops_resample_v(void*dest, const void*const*rows, const short*weights, int count, int num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //__pixelops_h__
@@ -0,0 +1,317 @@
+/* Checks that every SIMD kernel the processor supports produces exactly the
+   same bytes as the scalar reference version, over exhaustive sweeps where
+   that's feasible and random data (of all lengths, at all alignments)
+   otherwise. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "pixelops.h"
+#include "kernels.h"
+
+static const char*level_name[] = {"scalar", "sse2", "ssse3", "avx2"};
+static int errors = 0;
+
+static unsigned int seed = 1;
+static unsigned char rnd()
+{
+    seed = seed*1103515245 + 12345;
+    return seed >> 16;
+}
+static void fill_random(unsigned char*p, int len)
+{
+    int t;
+    for(t=0;t<len;t++)
+	p[t] = rnd();
+}
+/* mostly opaque or fully transparent pixels, like real images */
+static void fill_random_alpha(unsigned char*p, int num)
+{
+    int t;
+    fill_random(p, num*4);
+    for(t=0;t<num;t++) {
+	int r = rnd()&3;
+	if(r==0) p[t*4] = 0;
+	else if(r==1) p[t*4] = 255;
+    }
+}
+
+static void check(const char*name, int level, const unsigned char*a, const unsigned char*b, int len)
+{
+    if(!memcmp(a, b, len))
+	return;
+    int t;
+    for(t=0;t<len && a[t]==b[t];t++);
+    printf("%s (%s): byte %d differs: %02x != %02x\n", name, level_name[level], t, a[t], b[t]);
+    errors++;
+}
+
+#define MAXPIXELS 4096
+
+static void test_premultiply(int level)
+{
+    unsigned char*a = malloc(65536*4), *b = malloc(65536*4);
+    int t;
+    for(t=0;t<65536;t++) {
+	a[t*4+0] = t>>8;
+	a[t*4+1] = a[t*4+2] = a[t*4+3] = t;
+    }
+    memcpy(b, a, 65536*4);
+    premultiply_c(a, 65536);
+    pixelops_premultiply(b, 65536);
+    check("premultiply", level, a, b, 65536*4);
+
+    for(t=0;t<200;t++) {
+	int num = rnd()%67, ofs = rnd()%4;
+	fill_random(a+ofs, num*4);
+	memcpy(b+ofs, a+ofs, num*4);
+	premultiply_c(a+ofs, num);
+	pixelops_premultiply(b+ofs, num);
+	check("premultiply", level, a+ofs, b+ofs, num*4);
+    }
+    free(a);free(b);
+}
+
+static void test_unpremultiply(int level)
+{
+    unsigned char*src = malloc(65536*4+4), *a = malloc(65536*4+4), *b = malloc(65536*4+4);
+    int t;
+    for(t=0;t<65536;t++) {
+	src[t*4+0] = t>>8;
+	src[t*4+1] = src[t*4+2] = src[t*4+3] = t;
+    }
+    unpremultiply_c(a, src, 65536);
+    pixelops_unpremultiply(b, src, 65536);
+    check("unpremultiply", level, a, b, 65536*4);
+
+    for(t=0;t<200;t++) {
+	int num = rnd()%67, ofs = rnd()%4;
+	fill_random(src+ofs, num*4);
+	unpremultiply_c(a+ofs, src+ofs, num);
+	pixelops_unpremultiply(b+ofs, src+ofs, num);
+	check("unpremultiply", level, a+ofs, b+ofs, num*4);
+    }
+    free(src);free(a);free(b);
+}
+
+static void test_has_alpha(int level)
+{
+    unsigned char*p = malloc(MAXPIXELS*4);
+    int num, pos, alpha;
+    for(num=0;num<70;num++) {
+	for(pos=0;pos<num;pos++) {
+	    for(alpha=0;alpha<256;alpha++) {
+		int t;
+		for(t=0;t<num;t++) {
+		    p[t*4] = 0xff - (t&3);
+		    p[t*4+1] = p[t*4+2] = p[t*4+3] = alpha;
+		}
+		p[pos*4] = alpha;
+		int r1 = has_alpha_c(p, num);
+		int r2 = pixelops_has_alpha(p, num);
+		if(r1 != r2) {
+		    printf("has_alpha (%s): %d pixels, alpha %d at %d: %d != %d\n", level_name[level], num, alpha, pos, r1, r2);
+		    errors++;
+		}
+	    }
+	}
+    }
+    for(num=0;num<200;num++) {
+	int n = rnd()%MAXPIXELS;
+	fill_random(p, n*4);
+	int t;
+	for(t=0;t<n;t++)
+	    p[t*4] = (rnd()&1) ? (rnd()&3) : 0xfc + (rnd()&3);
+	if(rnd()&1 && n)
+	    p[(rnd()%n)*4] = rnd();
+	if(has_alpha_c(p, n) != pixelops_has_alpha(p, n)) {
+	    printf("has_alpha (%s): random image differs\n", level_name[level]);
+	    errors++;
+	}
+    }
+    free(p);
+}
+
+static void random_cxform(int*m)
+{
+    int t;
+    for(t=0;t<20;t++) {
+	int r = rnd()%4;
+	if(t%5 == 4) {
+	    m[t] = (int)((rnd()<<8|rnd())) - 32768;
+	    m[t] *= r;
+	} else if(r == 0) {
+	    m[t] = 0;
+	} else if(r == 1) {
+	    m[t] = 256;
+	} else {
+	    m[t] = (int)((rnd()<<8|rnd()) & 0x7ff) - 0x400;
+	}
+    }
+}
+
+static void test_cxform(int level)
+{
+    unsigned char*a = malloc(MAXPIXELS*4+4), *b = malloc(MAXPIXELS*4+4);
+    int t;
+    for(t=0;t<500;t++) {
+	int m[20];
+	random_cxform(m);
+	int num = t<100 ? t : rnd()%MAXPIXELS, ofs = rnd()%4;
+	fill_random(a+ofs, num*4);
+	memcpy(b+ofs, a+ofs, num*4);
+	cxform_c(a+ofs, num, m);
+	pixelops_cxform(b+ofs, num, m);
+	check("cxform", level, a+ofs, b+ofs, num*4);
+    }
+    free(a);free(b);
+}
+
+static void test_rgb_alpha(int level)
+{
+    unsigned char*rgb = malloc(65536*3), *alpha = malloc(65536);
+    unsigned char*a = malloc(65536*4), *b = malloc(65536*4);
+    int t, on_white;
+    for(on_white=0;on_white<2;on_white++) {
+	for(t=0;t<65536;t++) {
+	    alpha[t] = t>>8;
+	    rgb[t*3+0] = t;
+	    rgb[t*3+1] = 255-t;
+	    rgb[t*3+2] = t*7;
+	}
+	rgb_alpha_to_argb_c(a, rgb, alpha, 65536, on_white);
+	pixelops_rgb_alpha_to_argb(b, rgb, alpha, 65536, on_white);
+	check("rgb_alpha_to_argb", level, a, b, 65536*4);
+	for(t=0;t<200;t++) {
+	    int num = rnd()%67;
+	    /* put the data at the end of the buffers, to catch reads past them */
+	    unsigned char*r = rgb+65536*3-num*3, *al = alpha+65536-num;
+	    fill_random(r, num*3);
+	    fill_random(al, num);
+	    rgb_alpha_to_argb_c(a, r, al, num, on_white);
+	    pixelops_rgb_alpha_to_argb(b, r, al, num, on_white);
+	    check("rgb_alpha_to_argb", level, a, b, num*4);
+	}
+    }
+    free(rgb);free(alpha);free(a);free(b);
+}
+
+static void test_yuv(int level)
+{
+    int num = 1<<24;
+    unsigned char*argb = malloc(num*4), *yuv = malloc(num*3);
+    unsigned char*a = malloc(num*4), *b = malloc(num*4);
+    int t;
+    for(t=0;t<num;t++) {
+	argb[t*4+0] = t;
+	argb[t*4+1] = t>>16;
+	argb[t*4+2] = t>>8;
+	argb[t*4+3] = t;
+	yuv[t*3+0] = t>>16;
+	yuv[t*3+1] = t>>8;
+	yuv[t*3+2] = t;
+    }
+    argb_to_yuv_c(a, argb, num);
+    pixelops_argb_to_yuv(b, argb, num);
+    check("argb_to_yuv", level, a, b, num*3);
+
+    fill_random_alpha(a, num);
+    memcpy(b, a, num*4);
+    yuv_to_argb_c(a, yuv, num);
+    pixelops_yuv_to_argb(b, yuv, num);
+    check("yuv_to_argb", level, a, b, num*4);
+
+    for(t=0;t<200;t++) {
+	int n = rnd()%67;
+	unsigned char*y = yuv+num*3-n*3;
+	fill_random(y, n*3);
+	fill_random(a, n*4);
+	memcpy(b, a, n*4);
+	yuv_to_argb_c(a, y, n);
+	pixelops_yuv_to_argb(b, y, n);
+	check("yuv_to_argb", level, a, b, n*4);
+
+	fill_random(argb, n*4);
+	argb_to_yuv_c(a, argb, n);
+	pixelops_argb_to_yuv(b, argb, n);
+	check("argb_to_yuv", level, a, b, n*3);
+    }
+    free(argb);free(yuv);free(a);free(b);
+}
+
+/* weights like those of a Lanczos filter: they add up to one, but can
+   be negative, so the results need clamping */
+static void random_weights(short*w, int count)
+{
+    int t, sum = 0;
+    for(t=0;t<count;t++) {
+	w[t] = (short)((rnd()<<8|rnd()) % 4000) - 1000;
+	sum += w[t];
+    }
+    if(count)
+	w[rnd()%count] += (1<<PIXELOPS_WEIGHT_BITS) - sum;
+}
+
+static void test_resample(int level)
+{
+    unsigned char*src = malloc(MAXPIXELS*4), *a = malloc(MAXPIXELS*4), *b = malloc(MAXPIXELS*4);
+    int*bounds = malloc(MAXPIXELS*2*sizeof(int));
+    short*weights = malloc(MAXPIXELS*16*sizeof(short));
+    const unsigned char*rows[16];
+    int t;
+    for(t=0;t<300;t++) {
+	int width = 1 + rnd()%200;
+	int num = rnd()%300;
+	int ksize = 1 + rnd()%16;
+	int x;
+	fill_random(src, width*4);
+	for(x=0;x<num;x++) {
+	    int count = 1 + rnd()%ksize;
+	    if(count > width)
+		count = width;
+	    bounds[x*2] = rnd()%(width-count+1);
+	    bounds[x*2+1] = count;
+	    memset(&weights[x*ksize], 0, ksize*sizeof(short));
+	    random_weights(&weights[x*ksize], count);
+	}
+	resample_h_c(a, src, num, bounds, weights, ksize);
+	pixelops_resample_h(b, src, num, bounds, weights, ksize);
+	check("resample_h", level, a, b, num*4);
+    }
+    for(t=0;t<300;t++) {
+	int num = rnd()%300;
+	int count = 1 + rnd()%16;
+	int k;
+	for(k=0;k<count;k++) {
+	    /* put the rows at the end of the buffer, to catch reads past them */
+	    unsigned char*row = malloc(MAXPIXELS*4);
+	    rows[k] = row + MAXPIXELS*4 - num*4;
+	    fill_random(row + MAXPIXELS*4 - num*4, num*4);
+	}
+	random_weights(weights, count);
+	resample_v_c(a, rows, weights, count, num, 0);
+	pixelops_resample_v(b, (const void*const*)rows, weights, count, num);
+	check("resample_v", level, a, b, num*4);
+	for(k=0;k<count;k++)
+	    free((void*)(rows[k] - MAXPIXELS*4 + num*4));
+    }
+    free(src);free(a);free(b);free(bounds);free(weights);
+}
+
+int main(int argn, char*argv[])
+{
+    int best = pixelops_get_level();
+    int level;
+    for(level=PIXELOPS_SCALAR;level<=best;level++) {
+	pixelops_set_level(level);
+	test_premultiply(level);
+	test_unpremultiply(level);
+	test_has_alpha(level);
+	test_cxform(level);
+	test_rgb_alpha(level);
+	test_yuv(level);
+	test_resample(level);
+	printf("%s: %s\n", level_name[level], errors ? "FAILED" : "ok");
+    }
+    return errors ? 1 : 0;
+}
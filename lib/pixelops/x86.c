@@ -0,0 +1,460 @@
+/* x86.c
+
+   SSE2, SSSE3 and AVX2 versions of the pixelops kernels.
+
+   Part of the swftools package.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#include <memory.h>
+#include "pixelops.h"
+#include "kernels.h"
+
+#ifdef PIXELOPS_X86
+
+#include <immintrin.h>
+
+#define SSE2 __attribute__((target("sse2")))
+#define SSSE3 __attribute__((target("ssse3")))
+#define AVX2 __attribute__((target("avx2")))
+
+/* multipliers for removing premultiplied alpha, split into high and low
+   16 bits, for the four 16 bit lanes (a,r,g,b) of a pixel. The alpha lane
+   is multiplied by one. */
+static unsigned long long unpremultiply_hi[256];
+static unsigned long long unpremultiply_lo[256];
+
+void x86_init()
+{
+    int a;
+    for(a=0;a<256;a++) {
+	unsigned long long inv = a ? 0xff0000/a : 0;
+	unsigned long long hi = inv >> 16, lo = inv & 0xffff;
+	unpremultiply_hi[a] = 1 | hi<<16 | hi<<32 | hi<<48;
+	unpremultiply_lo[a] = lo<<16 | lo<<32 | lo<<48;
+    }
+}
+
+/* ------------------------------ premultiply ------------------------------ */
+
+/* x/255 for 0 <= x <= 255*255 */
+static inline SSE2 __m128i div255_sse2(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_add_epi16(_mm_srli_epi16(x, 8), _mm_set1_epi16(1)));
+    return _mm_srli_epi16(x, 8);
+}
+
+/* two pixels, in 16 bit lanes */
+static inline SSE2 __m128i premultiply2_sse2(__m128i v)
+{
+    const __m128i alphalanes = _mm_set_epi16(0,0,0,-1,0,0,0,-1);
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0), 0);
+    __m128i x = div255_sse2(_mm_mullo_epi16(v, a));
+    return _mm_or_si128(_mm_and_si128(alphalanes, v), _mm_andnot_si128(alphalanes, x));
+}
+
+SSE2 void premultiply_sse2(unsigned char*p, int num)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int t;
+    for(t=0;t+4<=num;t+=4) {
+	__m128i v = _mm_loadu_si128((__m128i*)&p[t*4]);
+	__m128i lo = premultiply2_sse2(_mm_unpacklo_epi8(v, zero));
+	__m128i hi = premultiply2_sse2(_mm_unpackhi_epi8(v, zero));
+	_mm_storeu_si128((__m128i*)&p[t*4], _mm_packus_epi16(lo, hi));
+    }
+    premultiply_c(&p[t*4], num-t);
+}
+
+static inline AVX2 __m256i div255_avx2(__m256i x)
+{
+    x = _mm256_add_epi16(x, _mm256_add_epi16(_mm256_srli_epi16(x, 8), _mm256_set1_epi16(1)));
+    return _mm256_srli_epi16(x, 8);
+}
+
+static inline AVX2 __m256i premultiply4_avx2(__m256i v)
+{
+    const __m256i alphalanes = _mm256_set_epi16(0,0,0,-1,0,0,0,-1,0,0,0,-1,0,0,0,-1);
+    __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, 0), 0);
+    __m256i x = div255_avx2(_mm256_mullo_epi16(v, a));
+    return _mm256_or_si256(_mm256_and_si256(alphalanes, v), _mm256_andnot_si256(alphalanes, x));
+}
+
+AVX2 void premultiply_avx2(unsigned char*p, int num)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    int t;
+    for(t=0;t+8<=num;t+=8) {
+	__m256i v = _mm256_loadu_si256((__m256i*)&p[t*4]);
+	__m256i lo = premultiply4_avx2(_mm256_unpacklo_epi8(v, zero));
+	__m256i hi = premultiply4_avx2(_mm256_unpackhi_epi8(v, zero));
+	_mm256_storeu_si256((__m256i*)&p[t*4], _mm256_packus_epi16(lo, hi));
+    }
+    premultiply_sse2(&p[t*4], num-t);
+}
+
+/* ----------------------------- unpremultiply ----------------------------- */
+
+/* (c*inv)>>16 == c*(inv>>16) + ((c*(inv&0xffff))>>16), of which we only
+   need the low 8 bits */
+static inline SSE2 __m128i unpremultiply2_sse2(__m128i v, int a0, int a1)
+{
+    __m128i hi = _mm_set_epi64x(unpremultiply_hi[a1], unpremultiply_hi[a0]);
+    __m128i lo = _mm_set_epi64x(unpremultiply_lo[a1], unpremultiply_lo[a0]);
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(v, hi), _mm_mulhi_epu16(v, lo));
+    return _mm_and_si128(x, _mm_set1_epi16(0xff));
+}
+
+SSE2 void unpremultiply_sse2(unsigned char*dest, const unsigned char*src, int num)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int t;
+    for(t=0;t+4<=num;t+=4) {
+	const unsigned char*s = &src[t*4];
+	__m128i v = _mm_loadu_si128((__m128i*)s);
+	__m128i lo = unpremultiply2_sse2(_mm_unpacklo_epi8(v, zero), s[0], s[4]);
+	__m128i hi = unpremultiply2_sse2(_mm_unpackhi_epi8(v, zero), s[8], s[12]);
+	_mm_storeu_si128((__m128i*)&dest[t*4], _mm_packus_epi16(lo, hi));
+    }
+    unpremultiply_c(&dest[t*4], &src[t*4], num-t);
+}
+
+/* ------------------------------- has_alpha ------------------------------- */
+
+SSE2 int has_alpha_sse2(const unsigned char*p, int num)
+{
+    /* the color bytes are set to 0xff, which is neither transparent
+       nor semi-transparent */
+    const __m128i colors = _mm_set1_epi32((int)0xffffff00);
+    const __m128i four = _mm_set1_epi8(4);
+    const __m128i semi = _mm_set1_epi8((char)(0xfb-4));
+    const __m128i three = _mm_set1_epi8(3);
+    __m128i transparent = _mm_setzero_si128();
+    int t;
+    for(t=0;t+4<=num;t+=4) {
+	__m128i v = _mm_or_si128(_mm_loadu_si128((__m128i*)&p[t*4]), colors);
+	__m128i d = _mm_sub_epi8(v, four);
+	if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, semi), d)))
+	    return 2;
+	transparent = _mm_or_si128(transparent, _mm_cmpeq_epi8(_mm_min_epu8(v, three), v));
+    }
+    int rest = has_alpha_c(&p[t*4], num-t);
+    if(rest == 2)
+	return 2;
+    return rest || _mm_movemask_epi8(transparent);
+}
+
+AVX2 int has_alpha_avx2(const unsigned char*p, int num)
+{
+    const __m256i colors = _mm256_set1_epi32((int)0xffffff00);
+    const __m256i four = _mm256_set1_epi8(4);
+    const __m256i semi = _mm256_set1_epi8((char)(0xfb-4));
+    const __m256i three = _mm256_set1_epi8(3);
+    __m256i transparent = _mm256_setzero_si256();
+    int t;
+    for(t=0;t+8<=num;t+=8) {
+	__m256i v = _mm256_or_si256(_mm256_loadu_si256((__m256i*)&p[t*4]), colors);
+	__m256i d = _mm256_sub_epi8(v, four);
+	if(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(d, semi), d)))
+	    return 2;
+	transparent = _mm256_or_si256(transparent, _mm256_cmpeq_epi8(_mm256_min_epu8(v, three), v));
+    }
+    int rest = has_alpha_sse2(&p[t*4], num-t);
+    if(rest == 2)
+	return 2;
+    return rest || _mm256_movemask_epi8(transparent);
+}
+
+/* -------------------------------- cxform -------------------------------- */
+
+/* The pixels are split into (a,r) and (g,b) pairs of 16 bit values, so
+   that pmaddwd computes a*m0+r*m1 and g*m2+b*m3 in 32 bit. */
+
+static inline int pair(int lo, int hi)
+{
+    return (int)(((unsigned)hi << 16) | ((unsigned)lo & 0xffff));
+}
+
+/* x/256, rounded towards zero, like C integer division */
+static inline SSE2 __m128i div256_sse2(__m128i x)
+{
+    x = _mm_add_epi32(x, _mm_and_si128(_mm_srai_epi32(x, 31), _mm_set1_epi32(255)));
+    return _mm_and_si128(_mm_srai_epi32(x, 8), _mm_set1_epi32(255));
+}
+
+SSE2 void cxform_sse2(unsigned char*p, int num, const int*m)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i c_ar[4], c_gb[4], c_t[4];
+    int t;
+    for(t=0;t<4;t++) {
+	c_ar[t] = _mm_set1_epi32(pair(m[t*5+0], m[t*5+1]));
+	c_gb[t] = _mm_set1_epi32(pair(m[t*5+2], m[t*5+3]));
+	c_t[t] = _mm_set1_epi32(m[t*5+4]);
+    }
+#define CHANNEL(n) div256_sse2(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(ar, c_ar[n]), _mm_madd_epi16(gb, c_gb[n])), c_t[n]))
+    for(t=0;t+4<=num;t+=4) {
+	__m128i v = _mm_loadu_si128((__m128i*)&p[t*4]);
+	__m128i lo = _mm_shuffle_epi32(_mm_unpacklo_epi8(v, zero), _MM_SHUFFLE(3,1,2,0));
+	__m128i hi = _mm_shuffle_epi32(_mm_unpackhi_epi8(v, zero), _MM_SHUFFLE(3,1,2,0));
+	__m128i ar = _mm_unpacklo_epi64(lo, hi);
+	__m128i gb = _mm_unpackhi_epi64(lo, hi);
+	__m128i out = _mm_or_si128(_mm_or_si128(CHANNEL(0), _mm_slli_epi32(CHANNEL(1), 8)),
+				   _mm_or_si128(_mm_slli_epi32(CHANNEL(2), 16), _mm_slli_epi32(CHANNEL(3), 24)));
+	_mm_storeu_si128((__m128i*)&p[t*4], out);
+    }
+#undef CHANNEL
+    cxform_c(&p[t*4], num-t, m);
+}
+
+static inline AVX2 __m256i div256_avx2(__m256i x)
+{
+    x = _mm256_add_epi32(x, _mm256_and_si256(_mm256_srai_epi32(x, 31), _mm256_set1_epi32(255)));
+    return _mm256_and_si256(_mm256_srai_epi32(x, 8), _mm256_set1_epi32(255));
+}
+
+AVX2 void cxform_avx2(unsigned char*p, int num, const int*m)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i c_ar[4], c_gb[4], c_t[4];
+    int t;
+    for(t=0;t<4;t++) {
+	c_ar[t] = _mm256_set1_epi32(pair(m[t*5+0], m[t*5+1]));
+	c_gb[t] = _mm256_set1_epi32(pair(m[t*5+2], m[t*5+3]));
+	c_t[t] = _mm256_set1_epi32(m[t*5+4]);
+    }
+#define CHANNEL(n) div256_avx2(_mm256_add_epi32(_mm256_add_epi32(_mm256_madd_epi16(ar, c_ar[n]), _mm256_madd_epi16(gb, c_gb[n])), c_t[n]))
+    /* all shuffles work within 128 bit lanes, so the pixels stay in order */
+    for(t=0;t+8<=num;t+=8) {
+	__m256i v = _mm256_loadu_si256((__m256i*)&p[t*4]);
+	__m256i lo = _mm256_shuffle_epi32(_mm256_unpacklo_epi8(v, zero), _MM_SHUFFLE(3,1,2,0));
+	__m256i hi = _mm256_shuffle_epi32(_mm256_unpackhi_epi8(v, zero), _MM_SHUFFLE(3,1,2,0));
+	__m256i ar = _mm256_unpacklo_epi64(lo, hi);
+	__m256i gb = _mm256_unpackhi_epi64(lo, hi);
+	__m256i out = _mm256_or_si256(_mm256_or_si256(CHANNEL(0), _mm256_slli_epi32(CHANNEL(1), 8)),
+				      _mm256_or_si256(_mm256_slli_epi32(CHANNEL(2), 16), _mm256_slli_epi32(CHANNEL(3), 24)));
+	_mm256_storeu_si256((__m256i*)&p[t*4], out);
+    }
+#undef CHANNEL
+    cxform_sse2(&p[t*4], num-t, m);
+}
+
+/* ---------------------------- rgb+alpha->argb ---------------------------- */
+
+SSSE3 void rgb_alpha_to_argb_ssse3(unsigned char*dest, const unsigned char*rgb, const unsigned char*alpha, int num, char on_white)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i spread = _mm_setr_epi8(-1,0,1,2, -1,3,4,5, -1,6,7,8, -1,9,10,11);
+    int t;
+    /* every iteration reads 16 bytes of rgb data, for 4 pixels */
+    for(t=0;t+6<=num;t+=4) {
+	int a4;
+	memcpy(&a4, &alpha[t], 4);
+	__m128i a = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(a4), zero), zero);
+	__m128i v = _mm_or_si128(_mm_shuffle_epi8(_mm_loadu_si128((__m128i*)&rgb[t*3]), spread), a);
+	if(on_white) {
+	    /* c*a/255 + (255-a). In the alpha lane, that's a + (255-a) = 255 */
+	    __m128i lo = _mm_unpacklo_epi8(v, zero);
+	    __m128i hi = _mm_unpackhi_epi8(v, zero);
+	    __m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0), 0);
+	    __m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0), 0);
+	    lo = _mm_add_epi16(premultiply2_sse2(lo), _mm_sub_epi16(_mm_set1_epi16(255), alo));
+	    hi = _mm_add_epi16(premultiply2_sse2(hi), _mm_sub_epi16(_mm_set1_epi16(255), ahi));
+	    v = _mm_packus_epi16(lo, hi);
+	}
+	_mm_storeu_si128((__m128i*)&dest[t*4], v);
+    }
+    rgb_alpha_to_argb_c(&dest[t*4], &rgb[t*3], &alpha[t], num-t, on_white);
+}
+
+/* ---------------------------------- yuv ---------------------------------- */
+
+SSSE3 void argb_to_yuv_ssse3(unsigned char*yuv, const unsigned char*argb, int num)
+{
+    const __m128i zero = _mm_setzero_si128();
+    /* same (truncated) coefficients as argb_to_yuv_c */
+    const __m128i y_ar = _mm_set1_epi32(pair(0, (int)( 0.299*256)));
+    const __m128i y_gb = _mm_set1_epi32(pair((int)( 0.587*256), (int)( 0.114 *256)));
+    const __m128i u_ar = _mm_set1_epi32(pair(0, (int)(-0.169*256)));
+    const __m128i u_gb = _mm_set1_epi32(pair((int)(-0.332*256), (int)( 0.500 *256)));
+    const __m128i v_ar = _mm_set1_epi32(pair(0, (int)( 0.500*256)));
+    const __m128i v_gb = _mm_set1_epi32(pair((int)(-0.419*256), (int)(-0.0813*256)));
+    const __m128i offset = _mm_set1_epi32(128*256);
+    const __m128i pack = _mm_setr_epi8(0,1,2, 4,5,6, 8,9,10, 12,13,14, -1,-1,-1,-1);
+    int t;
+    for(t=0;t+4<=num;t+=4) {
+	__m128i v = _mm_loadu_si128((__m128i*)&argb[t*4]);
+	__m128i lo = _mm_shuffle_epi32(_mm_unpacklo_epi8(v, zero), _MM_SHUFFLE(3,1,2,0));
+	__m128i hi = _mm_shuffle_epi32(_mm_unpackhi_epi8(v, zero), _MM_SHUFFLE(3,1,2,0));
+	__m128i ar = _mm_unpacklo_epi64(lo, hi);
+	__m128i gb = _mm_unpackhi_epi64(lo, hi);
+	__m128i y = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ar, y_ar), _mm_madd_epi16(gb, y_gb)), 8);
+	__m128i u = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(ar, u_ar), _mm_madd_epi16(gb, u_gb)), offset), 8);
+	__m128i w = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(ar, v_ar), _mm_madd_epi16(gb, v_gb)), offset), 8);
+	const __m128i mask = _mm_set1_epi32(255);
+	__m128i out = _mm_or_si128(_mm_and_si128(y, mask),
+		      _mm_or_si128(_mm_slli_epi32(_mm_and_si128(u, mask), 8), _mm_slli_epi32(_mm_and_si128(w, mask), 16)));
+	out = _mm_shuffle_epi8(out, pack);
+	_mm_storel_epi64((__m128i*)&yuv[t*3], out);
+	int last = _mm_cvtsi128_si32(_mm_srli_si128(out, 8));
+	memcpy(&yuv[t*3+8], &last, 4);
+    }
+    argb_to_yuv_c(&yuv[t*3], &argb[t*4], num-t);
+}
+
+SSSE3 void yuv_to_argb_ssse3(unsigned char*argb, const unsigned char*yuv, int num)
+{
+    const __m128i get_y = _mm_setr_epi8(0,-1,-1,-1, 3,-1,-1,-1, 6,-1,-1,-1, 9,-1,-1,-1);
+    const __m128i get_uv = _mm_setr_epi8(1,-1,2,-1, 4,-1,5,-1, 7,-1,8,-1, 10,-1,11,-1);
+    const __m128i r_uv = _mm_set1_epi32(pair(0, 360));
+    const __m128i g_uv = _mm_set1_epi32(pair(88, 183));
+    const __m128i b_uv = _mm_set1_epi32(pair(455, 0));
+    const __m128i spread = _mm_setr_epi8(-1,0,4,8, -1,1,5,9, -1,2,6,10, -1,3,7,11);
+    const __m128i alpha = _mm_set1_epi32(255);
+    int t;
+    /* every iteration reads 16 bytes of yuv data, for 4 pixels */
+    for(t=0;t+6<=num;t+=4) {
+	__m128i v = _mm_loadu_si128((__m128i*)&yuv[t*3]);
+	__m128i y = _mm_shuffle_epi8(v, get_y);
+	__m128i uv = _mm_sub_epi16(_mm_shuffle_epi8(v, get_uv), _mm_set1_epi16(128));
+	__m128i r = _mm_add_epi32(y, _mm_srai_epi32(_mm_madd_epi16(uv, r_uv), 8));
+	__m128i g = _mm_sub_epi32(y, _mm_srai_epi32(_mm_madd_epi16(uv, g_uv), 8));
+	__m128i b = _mm_add_epi32(y, _mm_srai_epi32(_mm_madd_epi16(uv, b_uv), 8));
+	/* saturating packs clamp to 0..255 */
+	__m128i rgb = _mm_packus_epi16(_mm_packs_epi32(r, g), _mm_packs_epi32(b, b));
+	__m128i a = _mm_and_si128(_mm_loadu_si128((__m128i*)&argb[t*4]), alpha);
+	_mm_storeu_si128((__m128i*)&argb[t*4], _mm_or_si128(_mm_shuffle_epi8(rgb, spread), a));
+    }
+    yuv_to_argb_c(&argb[t*4], &yuv[t*3], num-t);
+}
+
+/* ------------------------------- resample -------------------------------- */
+
+/* sums of 32 bit products back to bytes. The saturating packs do the
+   clamping. */
+static inline SSE2 __m128i round_weighted_sse2(__m128i v)
+{
+    const __m128i half = _mm_set1_epi32(1<<(PIXELOPS_WEIGHT_BITS-1));
+    return _mm_srai_epi32(_mm_add_epi32(v, half), PIXELOPS_WEIGHT_BITS);
+}
+
+SSE2 void resample_h_sse2(unsigned char*dest, const unsigned char*src, int num, const int*bounds, const short*weights, int ksize)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x;
+    for(x=0;x<num;x++) {
+	const unsigned char*s = &src[bounds[x*2]*4];
+	const short*w = &weights[x*ksize];
+	int count = bounds[x*2+1];
+	__m128i sum = zero;
+	int k;
+	/* pixels are paired up as (a0,a1,r0,r1,g0,g1,b0,b1), so that one
+	   multiply-add applies two weights to all four channels */
+	for(k=0;k+4<=count;k+=4) {
+	    __m128i v = _mm_loadu_si128((__m128i*)&s[k*4]);
+	    __m128i lo = _mm_unpacklo_epi8(v, zero);
+	    __m128i hi = _mm_unpackhi_epi8(v, zero);
+	    lo = _mm_unpacklo_epi16(lo, _mm_srli_si128(lo, 8));
+	    hi = _mm_unpacklo_epi16(hi, _mm_srli_si128(hi, 8));
+	    sum = _mm_add_epi32(sum, _mm_madd_epi16(lo, _mm_set1_epi32(pair(w[k], w[k+1]))));
+	    sum = _mm_add_epi32(sum, _mm_madd_epi16(hi, _mm_set1_epi32(pair(w[k+2], w[k+3]))));
+	}
+	for(;k+2<=count;k+=2) {
+	    __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*)&s[k*4]), zero);
+	    v = _mm_unpacklo_epi16(v, _mm_srli_si128(v, 8));
+	    sum = _mm_add_epi32(sum, _mm_madd_epi16(v, _mm_set1_epi32(pair(w[k], w[k+1]))));
+	}
+	if(k<count) {
+	    int p;
+	    memcpy(&p, &s[k*4], 4);
+	    __m128i v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p), zero), zero);
+	    sum = _mm_add_epi32(sum, _mm_madd_epi16(v, _mm_set1_epi32(pair(w[k], 0))));
+	}
+	sum = round_weighted_sse2(sum);
+	sum = _mm_packus_epi16(_mm_packs_epi32(sum, sum), zero);
+	int out = _mm_cvtsi128_si32(sum);
+	memcpy(&dest[x*4], &out, 4);
+    }
+}
+
+SSE2 void resample_v_sse2(unsigned char*dest, const unsigned char*const*rows, const short*weights, int count, int num)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int t;
+    for(t=0;t+16<=num*4;t+=16) {
+	__m128i s0 = zero, s1 = zero, s2 = zero, s3 = zero;
+	int k;
+	/* two rows at a time, interleaved bytewise */
+	for(k=0;k<count;k+=2) {
+	    __m128i a = _mm_loadu_si128((__m128i*)&rows[k][t]);
+	    __m128i b = zero;
+	    int w2 = 0;
+	    if(k+1<count) {
+		b = _mm_loadu_si128((__m128i*)&rows[k+1][t]);
+		w2 = weights[k+1];
+	    }
+	    __m128i w = _mm_set1_epi32(pair(weights[k], w2));
+	    __m128i lo = _mm_unpacklo_epi8(a, b);
+	    __m128i hi = _mm_unpackhi_epi8(a, b);
+	    s0 = _mm_add_epi32(s0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), w));
+	    s1 = _mm_add_epi32(s1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), w));
+	    s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), w));
+	    s3 = _mm_add_epi32(s3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), w));
+	}
+	__m128i lo = _mm_packs_epi32(round_weighted_sse2(s0), round_weighted_sse2(s1));
+	__m128i hi = _mm_packs_epi32(round_weighted_sse2(s2), round_weighted_sse2(s3));
+	_mm_storeu_si128((__m128i*)&dest[t], _mm_packus_epi16(lo, hi));
+    }
+    resample_v_c(dest, rows, weights, count, num, t);
+}
+
+static inline AVX2 __m256i round_weighted_avx2(__m256i v)
+{
+    const __m256i half = _mm256_set1_epi32(1<<(PIXELOPS_WEIGHT_BITS-1));
+    return _mm256_srai_epi32(_mm256_add_epi32(v, half), PIXELOPS_WEIGHT_BITS);
+}
+
+/* the same as resample_v_sse2, in both 128 bit halves */
+AVX2 void resample_v_avx2(unsigned char*dest, const unsigned char*const*rows, const short*weights, int count, int num)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    int t;
+    for(t=0;t+32<=num*4;t+=32) {
+	__m256i s0 = zero, s1 = zero, s2 = zero, s3 = zero;
+	int k;
+	for(k=0;k<count;k+=2) {
+	    __m256i a = _mm256_loadu_si256((__m256i*)&rows[k][t]);
+	    __m256i b = zero;
+	    int w2 = 0;
+	    if(k+1<count) {
+		b = _mm256_loadu_si256((__m256i*)&rows[k+1][t]);
+		w2 = weights[k+1];
+	    }
+	    __m256i w = _mm256_set1_epi32(pair(weights[k], w2));
+	    __m256i lo = _mm256_unpacklo_epi8(a, b);
+	    __m256i hi = _mm256_unpackhi_epi8(a, b);
+	    s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), w));
+	    s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), w));
+	    s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), w));
+	    s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), w));
+	}
+	__m256i lo = _mm256_packs_epi32(round_weighted_avx2(s0), round_weighted_avx2(s1));
+	__m256i hi = _mm256_packs_epi32(round_weighted_avx2(s2), round_weighted_avx2(s3));
+	_mm256_storeu_si256((__m256i*)&dest[t], _mm256_packus_epi16(lo, hi));
+    }
+    resample_v_c(dest, rows, weights, count, num, t);
+}
+
+#endif
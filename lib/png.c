@@ -24,6 +24,7 @@
 #include <fcntl.h>
 #include <zlib.h>
 #include <limits.h>
+#include "os.h"
 
 #ifdef EXPORT
 #undef EXPORT
@@ -31,6 +32,7 @@
 
 #ifdef PNG_INLINE_EXPORTS
 #define EXPORT static
+typedef struct _png_reader png_reader_t;
 #else
 #define EXPORT
 #include "png.h"
@@ -61,7 +63,8 @@ static int png_read_chunk(char (*head)[4], int*destlen, unsigned char**destdata,
 	    *destdata = 0;
 	} else {
 	    *destdata = (unsigned char*)malloc(len);
-	    if(!fread(*destdata, len, 1, fi)) {
+	    if(!*destdata || !fread(*destdata, len, 1, fi)) {
+		free(*destdata);
 		*destdata = 0;
 		if(destlen) *destlen=0;
 		return 0;
@@ -108,7 +111,10 @@ static int png_read_header(FILE*fi, struct png_header*header)
 	//printf("Chunk: %c%c%c%c (len:%d)\n", id[0],id[1],id[2],id[3], len);
 	if(!strncmp(id, "IHDR", 4)) {
 	    char a,b,c,f,i;
-	    if(len < 8) exit(1);
+	    if(len < 13) {
+		free(data);
+		return 0;
+	    }
 	    header->width = data[0]<<24|data[1]<<16|data[2]<<8|data[3];
 	    header->height = data[4]<<24|data[5]<<16|data[6]<<8|data[7];
 	    a = data[8];      // should be 8
@@ -120,22 +126,27 @@ static int png_read_header(FILE*fi, struct png_header*header)
 
 	    if(b!=0 && b!=4 && b!=2 && b!=3 && b!=6) {
 		fprintf(stderr, "Image mode %d not supported!\n", b);
+		free(data);
 		return 0;
 	    }
 	    if(a!=8 && (b==2 || b==6)) {
 		printf("Bpp %d in mode %d not supported!\n", b, a);
+		free(data);
 		return 0;
 	    }
 	    if(c!=0) {
 		printf("Compression mode %d not supported!\n", c);
+		free(data);
 		return 0;
 	    }
 	    if(f!=0) {
 		printf("Filter mode %d not supported!\n", f);
+		free(data);
 		return 0;
 	    }
 	    if(i!=0) {
 		printf("Interlace mode %d not supported!\n", i);
+		free(data);
 		return 0;
 	    }
 	    //printf("%dx%d bpp:%d mode:%d comp:%d filter:%d interlace:%d\n",header->width, header->height, a,b,c,f,i);
@@ -145,6 +156,8 @@ static int png_read_header(FILE*fi, struct png_header*header)
 	} 
 	
 	free(data);
+	if(ok)
+	    break; // the file is now positioned after the IHDR chunk
     }
     return ok;
 }
@@ -167,197 +180,6 @@ static inline byte PaethPredictor (byte a,byte b,byte c)
         else return c;
 }
 
-static void applyfilter1(int mode, unsigned char*src, unsigned char*old, unsigned char*dest, unsigned width)
-{
-    int x;
-    unsigned char last=0;
-    unsigned char upperlast=0;
-
-    if(mode==0) {
-	for(x=0;x<width;x++) {
-	    *dest = *src;
-	    dest++;
-	    src++;
-	}
-    }
-    else if(mode==1) {
-	for(x=0;x<width;x++) {
-	    *dest = *src+last;
-	    last = *dest;
-	    dest++;
-	    src++;
-	}
-    }
-    else if(mode==2) {
-	for(x=0;x<width;x++) {
-	    *dest = *src+*old;
-	    dest++;
-	    old++;
-	    src++;
-	}
-    }
-    else if(mode==3) {
-	for(x=0;x<width;x++) {
-	    *dest = *src+(*old+last)/2;
-	    last = *dest;
-	    dest++;
-	    old++;
-	    src++;
-	}
-    }
-    else if(mode==4) {
-	for(x=0;x<width;x++) {
-	    *dest = *src+PaethPredictor(last,*old,upperlast);
-	    last = *dest;
-	    upperlast = *old;
-	    dest++;
-	    old++;
-	    src++;
-	}
-    }    
-
-}
-
-static void applyfilter2(int mode, unsigned char*src, unsigned char*old, unsigned char*dest, unsigned width)
-{
-    int x;
-    unsigned char lasta=0;
-    unsigned char lastb=0;
-    unsigned char upperlasta=0;
-    unsigned char upperlastb=0;
-
-    if(mode==0) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[0];
-	    dest[1] = src[1];
-	    dest+=2;
-	    src+=2;
-	}
-    }
-    else if(mode==1) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[0]+lasta;
-	    dest[1] = src[1]+lastb;
-	    lasta = dest[0];
-	    lastb = dest[1];
-	    dest+=2;
-	    src+=2;
-	}
-    }
-    else if(mode==2) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[0]+old[0];
-	    dest[1] = src[1]+old[1];
-	    dest+=2;
-	    old+=2;
-	    src+=2;
-	}
-    }
-    else if(mode==3) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[0]+(old[0]+lasta)/2;
-	    dest[1] = src[1]+(old[1]+lastb)/2;
-	    lasta = dest[0];
-	    lastb = dest[1];
-	    dest+=2;
-	    old+=2;
-	    src+=2;
-	}
-    }
-    else if(mode==4) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[0]+PaethPredictor(lasta,old[0],upperlasta);
-	    dest[1] = src[1]+PaethPredictor(lastb,old[1],upperlastb);
-	    lasta = dest[0];
-	    lastb = dest[1];
-	    upperlasta = old[0];
-	    upperlastb = old[1];
-	    dest+=2;
-	    old+=2;
-	    src+=2;
-	}
-    }    
-}
-
-
-/* also performs 24 bit conversion! */
-static void applyfilter3(int mode, unsigned char*src, unsigned char*old, unsigned char*dest, unsigned width)
-{
-    int x;
-    unsigned char lastr=0;
-    unsigned char lastg=0;
-    unsigned char lastb=0;
-    unsigned char upperlastr=0;
-    unsigned char upperlastg=0;
-    unsigned char upperlastb=0;
-
-    if(mode==0) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0];
-	    dest[2] = src[1];
-	    dest[3] = src[2];
-	    dest+=4;
-	    src+=3;
-	}
-    }
-    else if(mode==1) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0]+lastr;
-	    dest[2] = src[1]+lastg;
-	    dest[3] = src[2]+lastb;
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    dest+=4;
-	    src+=3;
-	}
-    }
-    else if(mode==2) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0]+old[1];
-	    dest[2] = src[1]+old[2];
-	    dest[3] = src[2]+old[3];
-	    dest+=4;
-	    old+=4;
-	    src+=3;
-	}
-    }
-    else if(mode==3) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0]+(old[1]+lastr)/2;
-	    dest[2] = src[1]+(old[2]+lastg)/2;
-	    dest[3] = src[2]+(old[3]+lastb)/2;
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    dest+=4;
-	    old+=4;
-	    src+=3;
-	}
-    }
-    else if(mode==4) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0]+PaethPredictor(lastr,old[1],upperlastr);
-	    dest[2] = src[1]+PaethPredictor(lastg,old[2],upperlastg);
-	    dest[3] = src[2]+PaethPredictor(lastb,old[3],upperlastb);
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    upperlastr = old[1];
-	    upperlastg = old[2];
-	    upperlastb = old[3];
-	    dest+=4;
-	    old+=4;
-	    src+=3;
-	}
-    }    
-}
-
 void png_inverse_filter_32(int mode, unsigned char*src, unsigned char*old, unsigned char*dest, unsigned width)
 {
     int x;
@@ -450,6 +272,7 @@ EXPORT int png_getdimensions(const char*sname, unsigned*destwidth, unsigned*dest
 	return 0;
     }
     if(!png_read_header(fi, &header)) {
+	fclose(fi);
 	return 0;
     }
 
@@ -459,311 +282,401 @@ EXPORT int png_getdimensions(const char*sname, unsigned*destwidth, unsigned*dest
     return 1;
 }
 
-EXPORT int png_load(const char*sname, unsigned*destwidth, unsigned*destheight, unsigned char**destdata)
+#define ZBUF_SIZE 32768
+
+struct _png_reader
+{
+    FILE*fi;
+    struct png_header header;
+    int bypp; // bytes per pixel, at least one
+    unsigned linelen; // without the filter byte
+    unsigned y;
+
+    z_stream zs;
+    unsigned char*zbuf;
+    unsigned idat_left; // bytes left in the current IDAT chunk
+    char idat_done;
+
+    unsigned char*line; // filter byte + unfiltered data
+    unsigned char*prev;
+    unsigned char*indices; // for images with less than 8 bits per pixel
+
+    COL palette[256];
+    int palettelen;
+    unsigned char alphacolor[3];
+    int hasalphacolor;
+};
+
+/* reverses the filter of one row, in place */
+static int png_unfilter_row(int mode, unsigned char*line, const unsigned char*prev, unsigned len, int bypp)
+{
+    unsigned x;
+    if(mode==0) {
+	return 1;
+    } else if(mode==1) {
+	for(x=bypp;x<len;x++)
+	    line[x] += line[x-bypp];
+    } else if(mode==2) {
+	for(x=0;x<len;x++)
+	    line[x] += prev[x];
+    } else if(mode==3) {
+	for(x=0;x<bypp && x<len;x++)
+	    line[x] += prev[x]/2;
+	for(;x<len;x++)
+	    line[x] += (line[x-bypp]+prev[x])/2;
+    } else if(mode==4) {
+	for(x=0;x<bypp && x<len;x++)
+	    line[x] += prev[x];
+	for(;x<len;x++)
+	    line[x] += PaethPredictor(line[x-bypp], prev[x], prev[x-bypp]);
+    } else {
+	return 0;
+    }
+    return 1;
+}
+
+/* reads more image data from the IDAT chunk(s) into the zlib input buffer */
+static int png_reader_fill(png_reader_t*r)
+{
+    while(!r->idat_left) {
+	char id[4];
+	unsigned char blen[4];
+	if(r->idat_done)
+	    return 0;
+	fseek(r->fi, 4, SEEK_CUR); // crc
+	if(!fread(blen, 4, 1, r->fi) || !fread(id, 4, 1, r->fi) || strncmp(id, "IDAT", 4)) {
+	    /* the image data has to be stored in consecutive IDAT chunks */
+	    r->idat_done = 1;
+	    return 0;
+	}
+	r->idat_left = blen[0]<<24|blen[1]<<16|blen[2]<<8|blen[3];
+    }
+    int len = r->idat_left < ZBUF_SIZE ? r->idat_left : ZBUF_SIZE;
+    if(!fread(r->zbuf, len, 1, r->fi)) {
+	r->idat_done = 1;
+	return 0;
+    }
+    r->idat_left -= len;
+    r->zs.next_in = r->zbuf;
+    r->zs.avail_in = len;
+    return 1;
+}
+
+static void png_reader_make_palette(png_reader_t*r, unsigned char*palette, int palettelen, unsigned char*alphapalette, int alphapalettelen)
+{
+    int i;
+    if(r->header.mode == 0) { // grayscale palette
+	int mult = 255 / ((1<<r->header.bpp)-1);
+	r->palettelen = 1<<r->header.bpp;
+	for(i=0;i<r->palettelen;i++) {
+	    r->palette[i].a = 255;
+	    r->palette[i].r = i*mult;
+	    r->palette[i].g = i*mult;
+	    r->palette[i].b = i*mult;
+	    if(r->hasalphacolor && i == r->alphacolor[0])
+		r->palette[i].a = 0;
+	}
+    } else {
+	r->palettelen = palettelen;
+	/* 24->32 bit conversion */
+	for(i=0;i<palettelen;i++) {
+	    r->palette[i].r = palette[i*3+0];
+	    r->palette[i].g = palette[i*3+1];
+	    r->palette[i].b = palette[i*3+2];
+	    if(alphapalette && i<alphapalettelen) {
+		r->palette[i].a = alphapalette[i];
+	    } else {
+		r->palette[i].a = 255;
+	    }
+	}
+    }
+    /* pixels with indices beyond the end of the palette are black */
+    for(i=r->palettelen;i<256;i++) {
+	*(u32*)&r->palette[i] = 0;
+	r->palette[i].a = 255;
+    }
+}
+
+EXPORT void png_reader_close(png_reader_t*r)
+{
+    if(r->zbuf)
+	inflateEnd(&r->zs);
+    if(r->fi)
+	fclose(r->fi);
+    free(r->zbuf);
+    free(r->line);
+    free(r->prev);
+    free(r->indices);
+    free(r);
+}
+
+EXPORT png_reader_t* png_reader_open(const char*sname, unsigned*destwidth, unsigned*destheight)
 {
     char tagid[4];
     int len;
-    unsigned char*data;
-    unsigned char*imagedata;
-    unsigned char*zimagedata=0;
-    unsigned long int zimagedatalen=0;
+    unsigned char*data = 0;
     unsigned char*palette = 0;
     int palettelen = 0;
     unsigned char*alphapalette = 0;
     int alphapalettelen = 0;
-    struct png_header header;
-    int bypp;
-    unsigned char*data2 = 0;
-    unsigned char alphacolor[3];
-    int hasalphacolor=0;
+    int channels;
 
-    FILE *fi;
-    unsigned char *scanline;
-
-    if ((fi = fopen(sname, "rb")) == NULL) {
+    png_reader_t*r = (png_reader_t*)calloc(1, sizeof(png_reader_t));
+    if ((r->fi = fopen(sname, "rb")) == NULL) {
 	printf("Couldn't open %s\n", sname);
+	free(r);
 	return 0;
     }
-
-    if(!png_read_header(fi, &header)) {
-	fclose(fi);
+    if(!png_read_header(r->fi, &r->header)) {
+	png_reader_close(r);
 	return 0;
     }
 
-    if(header.mode == 3 || header.mode == 0) bypp = 1;
-    else if(header.mode == 4) bypp = 2;
-    else if(header.mode == 2) bypp = 3;
-    else if(header.mode == 6) bypp = 4;
-    else {
-	printf("ERROR: mode:%d\n", header.mode);
+    if(r->header.mode == 3 || r->header.mode == 0) channels = 1;
+    else if(r->header.mode == 4) channels = 2;
+    else if(r->header.mode == 2) channels = 3;
+    else channels = 4;
+
+    int bpp = r->header.bpp;
+    if((channels > 1 && bpp != 8) || (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8)) {
+	fprintf(stderr, "ERROR: mode:%d bpp:%d not supported\n", r->header.mode, bpp);
+	png_reader_close(r);
 	return 0;
     }
-
-    unsigned long long imagedatalen_64 = ((unsigned long long)header.width + 1) * header.height * bypp;
-    if(imagedatalen_64 > 0xffffffff)
+    if(!r->header.width || !r->header.height ||
+       (unsigned long long)r->header.width*r->header.height*4 > 0xffffffff) {
+	fprintf(stderr, "ERROR: bad image size %ux%u\n", r->header.width, r->header.height);
+	png_reader_close(r);
 	return 0;
-    unsigned long imagedatalen = (unsigned long)imagedatalen_64;
-    imagedata = (unsigned char*)malloc(imagedatalen);
+    }
+    r->bypp = channels*bpp/8;
+    if(!r->bypp)
+	r->bypp = 1;
+    r->linelen = (r->header.width*channels*bpp+7)/8;
 
-    fseek(fi,8,SEEK_SET);
-    while(!feof(fi))
-    {
-	if(!png_read_chunk(&tagid, &len, &data, fi))
-	    break;
-	if(!strncmp(tagid, "IEND", 4)) {
+    /* read everything up to the first IDAT chunk */
+    while(1) {
+	unsigned char blen[4];
+	if(!fread(blen, 4, 1, r->fi) || !fread(tagid, 4, 1, r->fi) || !strncmp(tagid, "IEND", 4)) {
+	    printf("Couldn't uncompress %s!\n", sname);
+	    free(palette);
+	    free(alphapalette);
+	    png_reader_close(r);
+	    return 0;
+	}
+	len = blen[0]<<24|blen[1]<<16|blen[2]<<8|blen[3];
+	if(!strncmp(tagid, "IDAT", 4)) {
+	    r->idat_left = len;
 	    break;
 	}
+	if((!strncmp(tagid, "PLTE", 4) || !strncmp(tagid, "tRNS", 4)) && len <= 768) {
+	    data = (unsigned char*)malloc(len?len:1);
+	    if(!fread(data, len, 1, r->fi) && len) {
+		free(data);
+		continue;
+	    }
+	    fseek(r->fi, 4, SEEK_CUR);
+	} else {
+	    fseek(r->fi, len+4, SEEK_CUR);
+	    continue;
+	}
 	if(!strncmp(tagid, "PLTE", 4)) {
+	    free(palette);
 	    palette = data;
 	    palettelen = len/3;
-	    data = 0; //don't free data
-	    //printf("%d colors in palette\n", palettelen);
-	}
-	if(!strncmp(tagid, "tRNS", 4)) {
-	    if(header.mode == 3) {
-		alphapalette = data;
-		alphapalettelen = len;
-		data = 0; //don't free data
-		//printf("found %d alpha colors\n", alphapalettelen);
-	    } else if(header.mode == 0 || header.mode == 2) {
-		int t;
-		if(header.mode == 2) {
-		    alphacolor[0] = data[1];
-		    alphacolor[1] = data[3];
-		    alphacolor[2] = data[5];
-		} else {
-		    alphacolor[0] = alphacolor[1] = alphacolor[2] = data[1];
-		}
-		hasalphacolor = 1;
-	    }
-	}
-	if(!strncmp(tagid, "IDAT", 4)) {
-	    if(!zimagedata) {
-		zimagedatalen = len;
-		zimagedata = (unsigned char*)malloc(len);
-		memcpy(zimagedata,data,len);
-	    } else {
-		zimagedata = (unsigned char*)realloc(zimagedata, zimagedatalen+len);
-		memcpy(&zimagedata[zimagedatalen], data, len);
-		zimagedatalen += len;
-	    }
-	}
-	if(!strncmp(tagid, "tEXt", 4)) {
-	    /*int t;
-	    printf("Image Text: ");
-	    for(t=0;t<len;t++) {
-		if(data[t]>=32 && data[t]<128)
-		    printf("%c", data[t]);
-		else
-		    printf("?");
+	    if(palettelen > 256)
+		palettelen = 256;
+	} else if(r->header.mode == 3) {
+	    free(alphapalette);
+	    alphapalette = data;
+	    alphapalettelen = len;
+	} else {
+	    if(r->header.mode == 2 && len >= 6) {
+		r->alphacolor[0] = data[1];
+		r->alphacolor[1] = data[3];
+		r->alphacolor[2] = data[5];
+		r->hasalphacolor = 1;
+	    } else if(r->header.mode == 0 && len >= 2) {
+		r->alphacolor[0] = r->alphacolor[1] = r->alphacolor[2] = data[1];
+		r->hasalphacolor = 1;
 	    }
-	    printf("\n");*/
+	    free(data);
 	}
-	if(data) {
-	    free(data); data=0;
-        }
     }
-    
-    fclose(fi);
-    if(!zimagedata || uncompress(imagedata, &imagedatalen, zimagedata, zimagedatalen) != Z_OK) {
-	printf("Couldn't uncompress %s!\n", sname);
-	if(zimagedata)
-	    free(zimagedata);
+
+    if(r->header.mode == 3 && !palette) {
+	fprintf(stderr, "Error: No palette found!\n");
+	free(alphapalette);
+	png_reader_close(r);
+	return 0;
+    }
+    if(r->header.mode == 0 || r->header.mode == 3)
+	png_reader_make_palette(r, palette, palettelen, alphapalette, alphapalettelen);
+    free(palette);
+    free(alphapalette);
+
+    r->line = (unsigned char*)calloc(1, r->linelen+1);
+    r->prev = (unsigned char*)calloc(1, r->linelen+1);
+    if(bpp < 8)
+	r->indices = (unsigned char*)malloc(r->header.width+7);
+
+    r->zbuf = (unsigned char*)malloc(ZBUF_SIZE);
+    memset(&r->zs, 0, sizeof(z_stream));
+    if(inflateInit(&r->zs) != Z_OK) {
+	free(r->zbuf); r->zbuf = 0;
+	png_reader_close(r);
 	return 0;
     }
-    free(zimagedata);
-
-    *destwidth = header.width;
-    *destheight = header.height;
-	
-    data2 = (unsigned char*)malloc(header.width*header.height*4);
 
-    if(header.mode == 4)
-    {
-	int i,s=0;
-	int x,y;
-	int pos=0;
-	unsigned char* old= (unsigned char*)malloc(header.width*2);
-	memset(old, 0, header.width*2);
-	*destdata = data2;
-	for(y=0;y<header.height;y++) {
-	    int mode = imagedata[pos++]; //filter mode
-	    unsigned char*src;
-	    unsigned char*dest;
-	    int x;
-	    dest = &data2[(y*header.width)*4];
-
-	    if(header.bpp == 8) {
-		/* one byte per pixel */
-		src = &imagedata[pos];
-		pos+=header.width*2;
-	    } else {
-		/* not implemented yet */
-		fprintf(stderr, "ERROR: mode=4 bpp:%d\n", header.bpp);
-		free(data2);
-		return 0;
-	    }
+    *destwidth = r->header.width;
+    *destheight = r->header.height;
+    return r;
+}
 
-	    applyfilter2(mode, src, old, dest, header.width);
-	    memcpy(old, dest, header.width*2);
+/* inflates and unfilters the next row into r->line+1 */
+static int png_reader_next_line(png_reader_t*r)
+{
+    unsigned char*tmp;
+    if(r->y >= r->header.height)
+	return 0;
+    tmp = r->prev; r->prev = r->line; r->line = tmp;
 
-	    for(x=header.width-1;x>=0;x--) {
-		unsigned char gray = dest[x*2+0];
-		unsigned char alpha = dest[x*2+1];
-		dest[x*4+0] = alpha;
-		dest[x*4+1] = gray;
-		dest[x*4+2] = gray;
-		dest[x*4+3] = gray;
-	    }
-	}
-	free(old);
-        free(imagedata);
-    } else if(header.mode == 6 || header.mode == 2) {
-	int i,s=0;
-	int x,y;
-	int pos=0;
-	*destdata = data2;
-	
-	unsigned char* firstline = malloc(header.width*4);
-	memset(firstline,0,header.width*4);
-	for(y=0;y<header.height;y++) {
-	    int mode = imagedata[pos++]; //filter mode
-	    unsigned char*src;
-	    unsigned char*dest;
-	    unsigned char*old;
-	    dest = &data2[(y*header.width)*4];
-
-	    if(header.bpp == 8)
-	    {
-		/* one byte per pixel */
-		src = &imagedata[pos];
-		pos+=header.width*(header.mode==6?4:3);
-	    } else {
-		/* not implemented yet */
-		fprintf(stderr, "ERROR: bpp:%d\n", header.bpp);
-		free(data2);
+    r->zs.next_out = r->line;
+    r->zs.avail_out = r->linelen+1;
+    while(r->zs.avail_out) {
+	if(!r->zs.avail_in && !png_reader_fill(r))
+	    return 0;
+	int ret = inflate(&r->zs, Z_NO_FLUSH);
+	if(ret == Z_STREAM_END) {
+	    if(r->zs.avail_out)
 		return 0;
-	    }
+	    break;
+	}
+	if(ret != Z_OK)
+	    return 0;
+    }
+    if(!png_unfilter_row(r->line[0], r->line+1, r->prev+1, r->linelen, r->bypp))
+	return 0;
+    r->y++;
+    return 1;
+}
 
-	    if(!y) {
-		old = firstline;
-	    } else {
-		old = &data2[(y-1)*header.width*4];
-	    }
-	    if(header.mode == 6) { 
-		png_inverse_filter_32(mode, src, old, dest, header.width);
-	    } else { // header.mode = 2
-		applyfilter3(mode, src, old, dest, header.width);
-		/* replace alpha color */
-		if(hasalphacolor) {
-		    int x;
-		    for(x=0;x<header.width;x++) {
-			if(dest[x*4+1] == alphacolor[0] &&
-			   dest[x*4+2] == alphacolor[1] &&
-			   dest[x*4+3] == alphacolor[2]) {
-			    *(u32*)&dest[x*4] = 0;
-			}
-		    }
-		}
+static void png_unpack_indices(png_reader_t*r, const unsigned char*src, unsigned char*dest)
+{
+    int bpp = r->header.bpp;
+    int shift = 8-bpp, mask = (1<<bpp)-1, s = 0;
+    unsigned x;
+    for(x=0;x<r->header.width;x++) {
+	dest[x] = (src[s>>3] >> (shift-(s&7))) & mask;
+	s += bpp;
+    }
+}
+
+EXPORT int png_reader_read_row(png_reader_t*r, unsigned char*dest)
+{
+    unsigned width = r->header.width;
+    unsigned char*src;
+    unsigned x;
+    if(!png_reader_next_line(r))
+	return 0;
+    src = r->line+1;
+
+    switch(r->header.mode) {
+	case 6:
+	    for(x=0;x<width;x++) {
+		dest[0] = src[3];
+		dest[1] = src[0];
+		dest[2] = src[1];
+		dest[3] = src[2];
+		dest+=4;
+		src+=4;
 	    }
-	}
-	free(firstline);
-        free(imagedata);
-    } else if(header.mode == 0 || header.mode == 3) {
-	COL*rgba = 0;
-	unsigned char*tmpline = (unsigned char*)malloc(header.width+1);
-	unsigned char*destline = (unsigned char*)malloc(header.width+1);
-	int i,x,y;
-	int pos=0;
-	
-	*destdata = data2;
-	
-	if(header.mode == 0) { // grayscale palette
-            int mult = (0x1ff>>header.bpp);
-	    palettelen = 1<<header.bpp;
-	    rgba = (COL*)malloc(palettelen*sizeof(COL));
-	    for(i=0;i<palettelen;i++) {
-		rgba[i].a = 255;
-		rgba[i].r = i*mult;
-		rgba[i].g = i*mult;
-		rgba[i].b = i*mult;
-		if(hasalphacolor) {
-		    if(rgba[i].r == alphacolor[0])
-			rgba[i].a = 0;
+	    break;
+	case 2:
+	    for(x=0;x<width;x++) {
+		if(r->hasalphacolor &&
+		   src[0] == r->alphacolor[0] &&
+		   src[1] == r->alphacolor[1] &&
+		   src[2] == r->alphacolor[2]) {
+		    *(u32*)dest = 0;
+		} else {
+		    dest[0] = 255;
+		    dest[1] = src[0];
+		    dest[2] = src[1];
+		    dest[3] = src[2];
 		}
+		dest+=4;
+		src+=3;
 	    }
-	} else {
-	    if(!palette) {
-		fprintf(stderr, "Error: No palette found!\n");
-		exit(1);
+	    break;
+	case 4:
+	    for(x=0;x<width;x++) {
+		dest[0] = src[1];
+		dest[1] = dest[2] = dest[3] = src[0];
+		dest+=4;
+		src+=2;
 	    }
-	    rgba = (COL*)malloc(palettelen*4);
-	    /* 24->32 bit conversion */
-	    for(i=0;i<palettelen;i++) {
-		rgba[i].r = palette[i*3+0];
-		rgba[i].g = palette[i*3+1];
-		rgba[i].b = palette[i*3+2];
-		if(alphapalette && i<alphapalettelen) {
-		    rgba[i].a = alphapalette[i];
-		    /*rgba[i].r = ((int)rgba[i].r*rgba[i].a)/255;
-		    rgba[i].g = ((int)rgba[i].g*rgba[i].a)/255;
-		    rgba[i].b = ((int)rgba[i].b*rgba[i].a)/255;*/
-		} else {
-		    rgba[i].a = 255;
-		}
-		if(hasalphacolor) {
-		    if(rgba[i].r == alphacolor[0] &&
-		       rgba[i].g == alphacolor[1] &&
-		       rgba[i].b == alphacolor[2])
-			rgba[i].a = 0;
-		}
+	    break;
+	default: { // 0, 3
+	    if(r->header.bpp < 8) {
+		png_unpack_indices(r, src, r->indices);
+		src = r->indices;
 	    }
+	    COL*d = (COL*)dest;
+	    for(x=0;x<width;x++)
+		d[x] = r->palette[src[x]];
+	    break;
 	}
+    }
+    return 1;
+}
 
-	for(y=0;y<header.height;y++) {
-	    int mode = imagedata[pos++]; //filter mode
-	    int x;
-	    unsigned char*old;
-	    unsigned char*src;
-	    src = &imagedata[pos];
-	    if(header.bpp == 8) {
-		pos+=header.width;
-	    } else {
-		int x,s=0;
-		int bitpos = 0;
-		u32 v = (1<<header.bpp)-1;
-		for(x=0;x<header.width;x++) {
-		    u32 r = src[s/8]<<8 | 
-			    src[s/8+1];
-		    int t;
-		    tmpline[x] = (r>>(16-header.bpp-(s&7)))&v;
-		    s+=header.bpp;
-		}
-		src = tmpline;
-		pos+=(header.width*header.bpp+7)/8;
-	    }
+EXPORT int png_reader_get_palette(png_reader_t*r, unsigned char*palette)
+{
+    if(r->header.mode != 0 && r->header.mode != 3)
+	return 0;
+    memcpy(palette, r->palette, 256*sizeof(COL));
+    return r->palettelen;
+}
 
-	    if(!y) {
-		memset(destline,0,header.width);
-		old = &destline[y*header.width];
-	    } else {
-		old = tmpline;
-	    }
-	    applyfilter1(mode, src, old, destline, header.width);
-	    memcpy(tmpline,destline,header.width);
-	    for(x=0;x<header.width;x++) {
-		*(COL*)&data2[y*header.width*4+x*4+0] = rgba[destline[x]];
-	    }
-	}
-	free(tmpline);
-	free(destline);
-	free(rgba);
-        free(imagedata);
-    } else {
-	printf("expected PNG mode to be 2, 3 or 6 (is:%d)\n", header.mode);
+EXPORT int png_reader_read_indices(png_reader_t*r, unsigned char*dest)
+{
+    if(r->header.mode != 0 && r->header.mode != 3)
+	return 0;
+    if(!png_reader_next_line(r))
+	return 0;
+    if(r->header.bpp < 8)
+	png_unpack_indices(r, r->line+1, dest);
+    else
+	memcpy(dest, r->line+1, r->header.width);
+    return 1;
+}
+
+EXPORT int png_load(const char*sname, unsigned*destwidth, unsigned*destheight, unsigned char**destdata)
+{
+    unsigned width, height, y;
+    png_reader_t*r = png_reader_open(sname, &width, &height);
+    if(!r)
+	return 0;
+
+    unsigned char*data = (unsigned char*)malloc(width*height*4);
+    if(!data) {
+	png_reader_close(r);
 	return 0;
     }
+    for(y=0;y<height;y++) {
+	if(!png_reader_read_row(r, &data[y*width*4])) {
+	    printf("Couldn't uncompress %s!\n", sname);
+	    free(data);
+	    png_reader_close(r);
+	    return 0;
+	}
+    }
+    png_reader_close(r);
 
+    *destwidth = width;
+    *destheight = height;
+    *destdata = data;
     return 1;
 }
 
@@ -1007,23 +920,10 @@ static long png_start_chunk(FILE*fi, char*type, int len)
     png_write_byte(fi,mytype[3]);
     return filepos;
 }
-static void png_patch_len(FILE*fi, int pos, int len)
-{
-    unsigned char mylen[4];
-    long filepos;
-    mylen[0] = len>>24;
-    mylen[1] = len>>16;
-    mylen[2] = len>>8;
-    mylen[3] = len;
-    fseek(fi, pos, SEEK_SET);
-    fwrite(&mylen, 4, 1, fi);
-    fseek(fi, 0, SEEK_END);
-}
 static void png_write_bytes(FILE*fi, unsigned char*bytes, int len)
 {
-    int t;
-    for(t=0;t<len;t++)
-	png_write_byte(fi,bytes[t]);
+    fwrite(bytes, len, 1, fi);
+    mycrc32 = crc32(mycrc32^0xffffffff, bytes, len)^0xffffffff;
 }
 static void png_write_dword(FILE*fi, u32 dword)
 {
@@ -1043,108 +943,6 @@ static void png_end_chunk(FILE*fi)
     fwrite(&tmp2,4,1,fi);
 }
 
-#define ZLIB_BUFFER_SIZE 16384
-
-static long compress_line(z_stream*zs, Bytef*line, int len, FILE*fi)
-{
-    long size = 0;
-    zs->next_in = line;
-    zs->avail_in = len;
-
-    while(1) {
-	int ret = deflate(zs, Z_NO_FLUSH);
-	if (ret != Z_OK) {
-	    fprintf(stderr, "error in deflate(): %s", zs->msg?zs->msg:"unknown");
-	    return 0;
-	}
-	if(zs->avail_out != ZLIB_BUFFER_SIZE) {
-	    int consumed = ZLIB_BUFFER_SIZE - zs->avail_out;
-	    size += consumed;
-	    png_write_bytes(fi, zs->next_out - consumed , consumed);
-	    zs->next_out = zs->next_out - consumed;
-	    zs->avail_out = ZLIB_BUFFER_SIZE;
-	}
-	if(!zs->avail_in) {
-	    break;
-	}
-    }
-    return size;
-}
-
-static int test_line(z_stream*zs_orig, Bytef*line, int linelen)
-{
-    z_stream zs;
-    int ret = deflateCopy(&zs, zs_orig);
-    if(ret != Z_OK) {
-	fprintf(stderr, "Couldn't copy stream\n");
-	return 0;
-    }
-
-    zs.next_in = line;
-    zs.avail_in = linelen;
-
-    long size = 0;
-
-    int mode = Z_SYNC_FLUSH;
-    while(1) {
-	int ret = deflate(&zs, mode);
-	if (ret != Z_OK && ret != Z_STREAM_END) {
-	    fprintf(stderr, "error in deflate(): %s (mode %s, %d bytes remaining)\n", zs.msg?zs.msg:"unknown", 
-		    mode==Z_SYNC_FLUSH?"Z_SYNC_FLUSH":"Z_FINISH", zs.avail_in);
-	    return 0;
-	}
-	if(zs.avail_out != ZLIB_BUFFER_SIZE) {
-	    int consumed = ZLIB_BUFFER_SIZE - zs.avail_out;
-	    size += consumed;
-	    zs.next_out = zs.next_out - consumed;
-	    zs.avail_out = ZLIB_BUFFER_SIZE;
-	}
-        if (ret == Z_STREAM_END) {
-            break;
-        }
-	if(!zs.avail_in) {
-	    mode = Z_FINISH;
-	}
-    }
-    ret = deflateEnd(&zs);
-    if (ret != Z_OK) {
-	fprintf(stderr, "error in deflateEnd(): %s\n", zs.msg?zs.msg:"unknown");
-	return 0;
-    }
-    return size;
-}
-
-static int finishzlib(z_stream*zs, FILE*fi)
-{
-    int size = 0;
-    int ret;
-    while(1) {
-        ret = deflate(zs, Z_FINISH);
-        if (ret != Z_OK &&
-            ret != Z_STREAM_END) {
-	    fprintf(stderr, "error in deflate(finish): %s\n", zs->msg?zs->msg:"unknown");
-	    return 0;
-	}
-
-	if(zs->avail_out != ZLIB_BUFFER_SIZE) {
-	    int consumed = ZLIB_BUFFER_SIZE - zs->avail_out;
-	    size += consumed;
-	    png_write_bytes(fi, zs->next_out - consumed , consumed);
-	    zs->next_out = zs->next_out - consumed;
-	    zs->avail_out = ZLIB_BUFFER_SIZE;
-	}
-        if (ret == Z_STREAM_END) {
-            break;
-        }
-    }
-    ret = deflateEnd(zs);
-    if (ret != Z_OK) {
-	fprintf(stderr, "error in deflateEnd(): %s\n", zs->msg?zs->msg:"unknown");
-	return 0;
-    }
-    return size;
-}
-
 static inline u32 color_hash(COL*col)
 {
     u32 col32 = *(u32*)col;
@@ -1205,6 +1003,7 @@ static int png_get_number_of_palette_entries(COL*img, unsigned width, unsigned h
     }
     if(palette_overflow) {
 	free(pal);
+	free(count);
 	*has_alpha=1;
 	return width*height;
     }
@@ -1380,147 +1179,253 @@ static int png_apply_specific_filter_32(int filtermode, unsigned char*dest, unsi
     return filtermode;
 }
 
-static int*num_bits_table = 0;
+/* scratch space for png_filter_line(), reused from line to line */
+typedef struct _png_filterlines {
+    unsigned char*line[5];
+    unsigned char*pairs;
+} filterlines_t;
 
-static void make_num_bits_table()
+static void filterlines_init(filterlines_t*f, unsigned width, int bpp)
 {
-    if(num_bits_table) return;
-    num_bits_table = malloc(sizeof(num_bits_table[0])*256);
     int t;
-    for(t=0;t<256;t++) {
-	int bits=0;
-	int v = t;
-	while(v) {
-	    bits++;
-	    v&=v-1;
-	}
-	num_bits_table[t]=bits;
-    }
+    for(t=0;t<5;t++)
+	f->line[t] = (unsigned char*)malloc(width*(bpp/8));
+    f->pairs = (unsigned char*)calloc(1, 8192);
 }
-
-static int png_find_best_filter(unsigned char*src, unsigned width, int bpp, int y)
+static void filterlines_free(filterlines_t*f)
 {
-    make_num_bits_table();
-    
-    int num_filters = y>0?5:2; //don't apply y-direction filter in first line
-    
-    int bytes_per_pixel = bpp>>3;
-    int w = width*bytes_per_pixel;
-    int back_x = bytes_per_pixel;
-    int back_y = y?width*bytes_per_pixel:0;
-
-    unsigned char*pairs[5];
-    pairs[0] = calloc(1, 8192);
-    pairs[1] = calloc(1, 8192);
-    pairs[2] = calloc(1, 8192);
-    pairs[3] = calloc(1, 8192);
-    pairs[4] = calloc(1, 8192);
-    
-    unsigned char old[5];
-    int l = bytes_per_pixel - 1;
-    old[0] = src[l];
-    old[1] = src[l];
-    old[2] = src[l] - src[l-back_y];
-    old[3] = src[l] - src[l-back_y];
-    old[4] = src[l] - PaethPredictor(0, src[l-back_y], 0);
-
-    int different_pairs[5] = {0,0,0,0,0};
+    int t;
+    for(t=0;t<5;t++)
+	free(f->line[t]);
+    free(f->pairs);
+}
 
+/* approximation for zlib compressability: count how many different
+   (byte1,byte2) pairs occur in the line */
+static int png_count_pairs(unsigned char*pairs, unsigned char*line, int len)
+{
     int x;
-    for(x=bytes_per_pixel;x<w;x++) {
-	unsigned char dest[5];
-	dest[0] = src[x];
-	dest[1] = src[x] - src[x-back_x];
-	dest[2] = src[x] - src[x-back_y];
-	dest[3] = src[x] - (src[x-back_x] + src[x-back_y])/2;
-	dest[4] = src[x] - PaethPredictor(src[x-back_x], src[x-back_y], src[x-back_x-back_y]);
-
-	int i;
-	for(i=0;i<5;i++) {
-	    int v = dest[i]<<8|old[i];
-	    int p = v>>3;
-	    int b = 1<<(v&7);
-	    if(!pairs[i][p]&b) {
-		pairs[i][p]|=b;
-		different_pairs[i]++;
-	    }
+    int different_pairs = 0;
+    for(x=1;x<len;x++) {
+	int v = line[x]<<8|line[x-1];
+	int p = v>>3;
+	int b = 1<<(v&7);
+	if(!(pairs[p]&b)) {
+	    pairs[p]|=b;
+	    different_pairs++;
 	}
-	memcpy(old, dest, sizeof(old));
     }
-    int f;
+    /* for lines shorter than 8k, this is cheaper than clearing everything */
+    for(x=1;x<len;x++) {
+	pairs[(line[x]<<8|line[x-1])>>3] = 0;
+    }
+    return different_pairs;
+}
+
+/* filters line y with all filter types, and returns the one which is
+   likely to compress best. The filtered line is in f->line[<filter>]. */
+static int png_filter_line(filterlines_t*f, unsigned char*src, unsigned width, int y, int bpp)
+{
+    int num_filters = y>0?5:2; //don't apply y-direction filter in first line
+    int len = width*(bpp/8);
     int best_nr = 0;
     int best_energy = INT_MAX;
-    for(f=0;f<num_filters;f++) {
-	int energy = different_pairs[f];
+    int t;
+    if(bpp==8) {
+	/* palette indices aren't numbers, predicting them doesn't help */
+	png_apply_specific_filter_8(0, f->line[0], src, width);
+	return 0;
+    }
+    for(t=0;t<num_filters;t++) {
+	png_apply_specific_filter_32(t, f->line[t], src, width);
+	int energy = png_count_pairs(f->pairs, f->line[t], len);
 	if(energy<best_energy) {
-	    best_nr = f;
+	    best_nr = t;
 	    best_energy = energy;
 	}
     }
-    free(pairs[0]);
-    free(pairs[1]);
-    free(pairs[2]);
-    free(pairs[3]);
-    free(pairs[4]);
     return best_nr;
 }
-    
-    
-static int png_apply_filter(unsigned char*dest, unsigned char*src, unsigned width, int y, int bpp)
+
+png_filterlines_t* png_filterlines_new(unsigned width)
 {
-    int best_nr = 0;
-#if 0
-    make_num_bits_table();
-    int num_filters = y>0?5:2; //don't apply y-direction filter in first line
-    int f;
-    int best_energy = INT_MAX;
-    int w = width*(bpp/8);
-    unsigned char* pairs = malloc(8192);
-    assert(bpp==8 || bpp==32);
-    for(f=0;f<num_filters;f++) {
-	if(bpp==8)
-	    png_apply_specific_filter_8(f, dest, src, width);
-	else
-	    png_apply_specific_filter_32(f, dest, src, width);
-	int x;
-
-	/* approximation for zlib compressability: test how many different
-	   (byte1,byte2) occur */
-	memset(pairs, 0, 8192);
-	int different_pairs = 0;
-	for(x=0;x<w-1;x++) {
-	    int v = dest[x+1]<<8|dest[x];
-	    int p = v>>3;
-	    int b = 1<<(v&7);
-	    if(!pairs[p]&b) {
-		pairs[p]|=b;
-		different_pairs ++;
-	    }
-	}
-	int energy = different_pairs;
-	if(energy<best_energy) {
-	    best_nr = f;
-	    best_energy = energy;
+    filterlines_t*f = (filterlines_t*)malloc(sizeof(filterlines_t));
+    filterlines_init(f, width, 32);
+    return f;
+}
+void png_filterlines_destroy(png_filterlines_t*f)
+{
+    filterlines_free(f);
+    free(f);
+}
+
+static int png_apply_filter(filterlines_t*f, unsigned char*dest, unsigned char*src, unsigned width, int y, int bpp)
+{
+    int best_nr = png_filter_line(f, src, width, y, bpp);
+    memcpy(dest, f->line[best_nr], width*(bpp/8));
+    return best_nr;
+}
+
+int png_apply_filter_8(png_filterlines_t*f, unsigned char*dest, unsigned char*src, unsigned width, int y)
+{
+    return png_apply_filter(f, dest, src, width, y, 8);
+}
+int png_apply_filter_32(png_filterlines_t*f, unsigned char*dest, unsigned char*src, unsigned width, int y)
+{
+    return png_apply_filter(f, dest, src, width, y, 32);
+}
+
+static int png_num_threads = 1;
+
+EXPORT void png_set_num_threads(int num)
+{
+    png_num_threads = num;
+}
+
+/* The image data is filtered, and then compressed in chunks of this size,
+   in parallel, each one primed with the 32k of data preceding it (like
+   pigz does). The chunks are deflate blocks ending on a byte boundary
+   (Z_SYNC_FLUSH), so they can simply be concatenated. The chunk boundaries
+   don't depend on the number of threads, so neither does the output. */
+#define IDAT_CHUNK_SIZE (256*1024)
+#define IDAT_DICT_SIZE 32768
+
+typedef struct _idatjob {
+    unsigned char*data;
+    unsigned width;
+    int bpp;
+    int linelen;
+    unsigned char*filtered;
+    int rows_per_block;
+    int height;
+    int level;
+    int len;
+    int num_chunks;
+    unsigned char**out;
+    int*outlen;
+    uLong*adler;
+} idatjob_t;
+
+static void png_filter_block(void*_job, int nr)
+{
+    idatjob_t*job = (idatjob_t*)_job;
+    int srcwidth = job->width*(job->bpp/8);
+    int y, y1 = nr*job->rows_per_block, y2 = y1 + job->rows_per_block;
+    if(y2 > job->height)
+	y2 = job->height;
+    filterlines_t f;
+    filterlines_init(&f, job->width, job->bpp);
+    for(y=y1;y<y2;y++) {
+	unsigned char*line = &job->filtered[y*job->linelen];
+	int filter = 0;
+	if(job->level) {
+	    filter = png_filter_line(&f, &job->data[y*srcwidth], job->width, y, job->bpp);
+	} else if(job->bpp==8) {
+	    /* uncompressed: filtering wouldn't make the file smaller */
+	    png_apply_specific_filter_8(0, f.line[0], &job->data[y*srcwidth], job->width);
+	} else {
+	    png_apply_specific_filter_32(0, f.line[0], &job->data[y*srcwidth], job->width);
 	}
+	line[0] = filter;
+	memcpy(line+1, f.line[filter], srcwidth);
     }
-    free(pairs);
-#else
-    best_nr = png_find_best_filter(src, width, bpp, y);
-#endif
-    if(bpp==8)
-	png_apply_specific_filter_8(best_nr, dest, src, width);
-    else
-	png_apply_specific_filter_32(best_nr, dest, src, width);
-    return best_nr;
+    filterlines_free(&f);
 }
 
-int png_apply_filter_8(unsigned char*dest, unsigned char*src, unsigned width, int y)
+static void png_deflate_chunk(void*_job, int nr)
 {
-    return png_apply_filter(dest, src, width, y, 8);
+    idatjob_t*job = (idatjob_t*)_job;
+    int start = nr*IDAT_CHUNK_SIZE;
+    int len = job->len - start < IDAT_CHUNK_SIZE ? job->len - start : IDAT_CHUNK_SIZE;
+    char last = nr == job->num_chunks-1;
+    z_stream zs;
+    memset(&zs, 0, sizeof(z_stream));
+    if(deflateInit2(&zs, job->level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+	fprintf(stderr, "error in deflateInit2(): %s\n", zs.msg?zs.msg:"unknown");
+	return;
+    }
+    if(start) {
+	int dictlen = start < IDAT_DICT_SIZE ? start : IDAT_DICT_SIZE;
+	deflateSetDictionary(&zs, &job->filtered[start-dictlen], dictlen);
+    }
+    /* room for the sync flush marker, too */
+    int size = deflateBound(&zs, len) + 16;
+    unsigned char*out = (unsigned char*)malloc(size);
+    zs.next_in = &job->filtered[start];
+    zs.avail_in = len;
+    zs.next_out = out;
+    zs.avail_out = size;
+    int ret = deflate(&zs, last?Z_FINISH:Z_SYNC_FLUSH);
+    if(ret != (last?Z_STREAM_END:Z_OK) || zs.avail_in) {
+	fprintf(stderr, "error in deflate(): %s\n", zs.msg?zs.msg:"unknown");
+    }
+    job->out[nr] = out;
+    job->outlen[nr] = zs.next_out - out;
+    job->adler[nr] = adler32(adler32(0, 0, 0), &job->filtered[start], len);
+    deflateEnd(&zs);
 }
-int png_apply_filter_32(unsigned char*dest, unsigned char*src, unsigned width, int y)
+
+/* filters and compresses the image, and returns the contents of the
+   IDAT chunk */
+static unsigned char* png_compress_image(unsigned char*data, unsigned width, unsigned height, int bpp, int level, int*destlen)
 {
-    return png_apply_filter(dest, src, width, y, 32);
+    idatjob_t job;
+    int t;
+    memset(&job, 0, sizeof(job));
+    job.data = data;
+    job.width = width;
+    job.height = height;
+    job.bpp = bpp;
+    job.level = level;
+    job.linelen = 1 + width*(bpp/8);
+    job.len = job.linelen*height;
+    job.filtered = (unsigned char*)malloc(job.len);
+
+    int num_threads = job.len >= IDAT_CHUNK_SIZE ? png_num_threads : 1;
+
+    job.rows_per_block = (IDAT_CHUNK_SIZE + job.linelen - 1) / job.linelen;
+    parallel_for((height + job.rows_per_block - 1) / job.rows_per_block, png_filter_block, &job, num_threads);
+
+    /* an empty image still needs one (empty) final deflate block */
+    job.num_chunks = job.len ? (job.len + IDAT_CHUNK_SIZE - 1) / IDAT_CHUNK_SIZE : 1;
+    job.out = (unsigned char**)calloc(job.num_chunks, sizeof(unsigned char*));
+    job.outlen = (int*)calloc(job.num_chunks, sizeof(int));
+    job.adler = (uLong*)calloc(job.num_chunks, sizeof(uLong));
+    parallel_for(job.num_chunks, png_deflate_chunk, &job, num_threads);
+
+    /* zlib header (like deflate() would write it), data, adler32 */
+    int size = 2 + 4;
+    for(t=0;t<job.num_chunks;t++)
+	size += job.outlen[t];
+    unsigned char*dest = (unsigned char*)malloc(size);
+    int flevel = level<0||level==6 ? 2 : (level<2 ? 0 : (level<6 ? 1 : 3));
+    int header = 0x7800 | flevel<<6;
+    header += 31 - (header % 31);
+    dest[0] = header>>8;
+    dest[1] = header;
+    int pos = 2;
+    uLong adler = job.adler[0];
+    for(t=0;t<job.num_chunks;t++) {
+	if(job.out[t])
+	    memcpy(&dest[pos], job.out[t], job.outlen[t]);
+	pos += job.outlen[t];
+	if(t) {
+	    int len = t<job.num_chunks-1 ? IDAT_CHUNK_SIZE : job.len - t*IDAT_CHUNK_SIZE;
+	    adler = adler32_combine(adler, job.adler[t], len);
+	}
+	free(job.out[t]);
+    }
+    dest[pos++] = adler>>24;
+    dest[pos++] = adler>>16;
+    dest[pos++] = adler>>8;
+    dest[pos++] = adler;
+
+    free(job.out);
+    free(job.outlen);
+    free(job.adler);
+    free(job.filtered);
+    *destlen = pos;
+    return dest;
 }
 
 static void png_write_palette_based2(const char*filename, unsigned char*data, unsigned width, unsigned height, int numcolors, int compression)
@@ -1538,9 +1443,7 @@ static void png_write_palette_based2(const char*filename, unsigned char*data, un
     int error;
     u32 tmp32;
     int bpp;
-    int ret;
     char has_alpha=0;
-    z_stream zs;
     COL palette[256];
 
     make_crc32_table();
@@ -1569,6 +1472,7 @@ static void png_write_palette_based2(const char*filename, unsigned char*data, un
         cols = numcolors;
         format = 3;
         png_quantize_image(data, width*height, numcolors, &data, palette);
+        data2 = data;
     }
 
     fi = fopen(filename, "wb");
@@ -1613,81 +1517,16 @@ static void png_write_palette_based2(const char*filename, unsigned char*data, un
 	}
     }
 
-    long idatpos = png_start_chunk(fi, "IDAT", 0);
-    
-    memset(&zs,0,sizeof(z_stream));
-    Bytef*writebuf = (Bytef*)malloc(ZLIB_BUFFER_SIZE);
-    zs.zalloc = Z_NULL;
-    zs.zfree  = Z_NULL;
-    zs.opaque = Z_NULL;
-    zs.next_out = writebuf;
-    zs.avail_out = ZLIB_BUFFER_SIZE;
-    ret = deflateInit(&zs, compression);
-    if (ret != Z_OK) {
-	fprintf(stderr, "error in deflateInit(): %s", zs.msg?zs.msg:"unknown");
-	return;
-    }
-
-    long idatsize = 0;
-    {
-	int x,y;
-        int bypp = bpp/8;
-	unsigned srcwidth = width * bypp;
-	unsigned linelen = 1 + srcwidth;
-        if(bypp==2) 
-            linelen = 1 + ((srcwidth+1)&~1);
-        else if(bypp==3) 
-            linelen = 1 + ((srcwidth+2)/3)*3;
-        else if(bypp==4) 
-            linelen = 1 + ((srcwidth+3)&~3);
-	unsigned char* line = (unsigned char*)malloc(linelen);
-	memset(line, 0, linelen);
-#if 0
-	unsigned char* bestline = (unsigned char*)malloc(linelen);
-	memset(bestline, 0, linelen);
-	for(y=0;y<height;y++)
-	{
-	    int filtermode;
-	    int bestsize = 0x7fffffff;
-	    for(filtermode=0;filtermode<=4;filtermode++) {
-		if(!y && filtermode>=2)
-		    continue; // don't do y direction filters in the first row
-		
-		line[0]=filtermode; //filter type
-                if(bpp==8)
-		    png_apply_specific_filter_8(filtermode, line+1, &data[y*srcwidth], width);
-                else
-		    png_apply_specific_filter_32(filtermode, line+1, &data[y*srcwidth], width);
-
-		int size = test_line(&zs, line, linelen);
-		if(size < bestsize) {
-		    memcpy(bestline, line, linelen);
-		    bestsize = size;
-		}
-	    }
-	    idatsize += compress_line(&zs, bestline, linelen, fi);
-	}
-	free(bestline);
-#else
-	for(y=0;y<height;y++) {
-            if(bpp==8)
-		line[0] = png_apply_filter_8(line+1, &data[y*srcwidth], width, y);
-            else
-		line[0] = png_apply_filter_32(line+1, &data[y*srcwidth], width, y);
-
-	    idatsize += compress_line(&zs, line, linelen, fi);
-	}
-#endif
-	free(line);
-    }
-    idatsize += finishzlib(&zs, fi);
-    png_patch_len(fi, idatpos, idatsize);
+    int idatsize = 0;
+    unsigned char*idat = png_compress_image(data, width, height, bpp, compression, &idatsize);
+    png_start_chunk(fi, "IDAT", idatsize);
+    png_write_bytes(fi, idat, idatsize);
     png_end_chunk(fi);
+    free(idat);
 
     png_start_chunk(fi, "IEND", 0);
     png_end_chunk(fi);
 
-    free(writebuf);
     if(data2)
 	free(data2);
     fclose(fi);
@@ -23,18 +23,42 @@
 extern "C" {
 #endif
 
-int png_apply_filter_32(unsigned char*dest, unsigned char*src, unsigned width, int y);
+/* line buffers for png_apply_filter_32(), for images up to the given width.
+   Allocate them once per image, not once per line. */
+typedef struct _png_filterlines png_filterlines_t;
+png_filterlines_t* png_filterlines_new(unsigned width);
+void png_filterlines_destroy(png_filterlines_t*f);
+int png_apply_filter_32(png_filterlines_t*f, unsigned char*dest, unsigned char*src, unsigned width, int y);
 void png_inverse_filter_32(int mode, unsigned char*src, unsigned char*old, unsigned char*dest, unsigned width);
 
 int png_load(const char*sname, unsigned*destwidth, unsigned*destheight, unsigned char**destdata);
 int png_getdimensions(const char*sname, unsigned*destwidth, unsigned*destheight);
 
+/* decodes a png file one row at a time, without ever holding the whole
+   (compressed or uncompressed) image in memory */
+typedef struct _png_reader png_reader_t;
+png_reader_t* png_reader_open(const char*sname, unsigned*destwidth, unsigned*destheight);
+/* stores the next row (width pixels, a,r,g,b) in dest. Returns 0 on error. */
+int png_reader_read_row(png_reader_t*r, unsigned char*dest);
+/* for palette and grayscale images: stores the palette (256 entries, a,r,g,b,
+   padded with black) in palette, and returns the number of colors in the
+   file. Returns 0 for other images. */
+int png_reader_get_palette(png_reader_t*r, unsigned char*palette);
+/* for palette and grayscale images: stores the palette indices of the next
+   row (one byte per pixel) in dest, instead of the colors. */
+int png_reader_read_indices(png_reader_t*r, unsigned char*dest);
+void png_reader_close(png_reader_t*r);
+
 void png_write_palette_based(const char*filename, unsigned char*data, unsigned width, unsigned height, int numcolors);
 
 void png_write(const char*filename, unsigned char*data, unsigned width, unsigned height);
 void png_write_quick(const char*filename, unsigned char*data, unsigned width, unsigned height);
 void png_write_palette_based_2(const char*filename, unsigned char*data, unsigned width, unsigned height);
 
+/* number of threads used for compressing large images (default: 1,
+   0 = one per processor) */
+void png_set_num_threads(int num);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,6 +7,7 @@
 #include "../mem.h"
 #include "../png.h"
 #include "../rfxswf.h"
+#include "../os.h"
 #include "swf.h"
 
 typedef struct _map16_t
@@ -14,19 +15,17 @@ typedef struct _map16_t
     void** ids;
 } map16_t;
 
+typedef struct _swf_source_internal
+{
+    int num_threads;
+    char lazy_bitmaps;
+} swf_source_internal_t;
+
 typedef struct _swf_page_internal
 {
     int frame;
 } swf_page_internal_t;
 
-typedef struct _swf_doc_internal
-{
-    map16_t*id2char;
-    SWF swf;
-    int width,height;
-    MATRIX m;
-} swf_doc_internal_t;
-
 #define TYPE_SHAPE 1
 #define TYPE_BITMAP 2
 #define TYPE_SPRITE 3
@@ -48,6 +47,40 @@ typedef struct _placement
     int startFrame;
 } placement_t;
 
+/* how many frames lie between two stored display lists */
+#define SNAPSHOT_INTERVAL 50
+
+/* the display list at a given point of a (main or sprite) timeline */
+typedef struct _framestate
+{
+    TAG*tag; /* next tag to process, 0 at the end of the timeline */
+    int frame; /* frame the depthmap belongs to */
+    char complete; /* whether all tags of that frame have been processed */
+    map16_t*depthmap;
+} framestate_t;
+
+/* compact copy of a framestate, taken every snapshot_interval frames */
+typedef struct _snapshot
+{
+    TAG*tag;
+    int frame;
+    int num;
+    placement_t*placements;
+} snapshot_t;
+
+typedef struct _swf_doc_internal
+{
+    map16_t*id2char;
+    SWF swf;
+    int width,height;
+    MATRIX m;
+
+    framestate_t state;
+    snapshot_t**snapshots;
+    int num_snapshots;
+    int snapshot_interval;
+} swf_doc_internal_t;
+
 typedef struct _sprite
 {
     int frameCount;
@@ -210,10 +243,21 @@ static gfximage_t* gfximage_new(RGBA*data, int width, int height)
     return b;
 }
 
+static gfximage_t* decodeBitmap(character_t*c)
+{
+    int width, height;
+    void*data = swf_ExtractImage(c->tag, &width, &height);
+    return gfximage_new(data, width, height);
+}
+
 static gfximage_t* findimage(render_t*r, U16 id)
 {
     character_t*c = (character_t*)map16_get_id(r->id2char, id);
     assert(c && c->type == TYPE_BITMAP);
+    if(!c->data) {
+	/* decode on first use */
+	c->data = decodeBitmap(c);
+    }
     gfximage_t*img = (gfximage_t*)c->data;
 
     /*char filename[80];
@@ -327,10 +371,108 @@ static void textcallback(void*self, int*chars, int*xpos, int nr, int fontid, int
 
 //---- tag handling ----
 
-static map16_t* extractDefinitions(SWF*swf)
+static char isFontTag(TAG*tag)
+{
+    switch(tag->id) {
+	case ST_DEFINEFONT:
+	case ST_DEFINEFONT2:
+	case ST_DEFINEFONT3:
+	case ST_DEFINEFONTALIGNZONES:
+	case ST_DEFINEFONTINFO:
+	case ST_DEFINEFONTINFO2:
+	case ST_DEFINETEXT:
+	case ST_DEFINETEXT2:
+	case ST_GLYPHNAMES:
+	    return 1;
+    }
+    return 0;
+}
+
+static font_t* decodeFont(TAG*fonttags, int numfonttags, character_t*c)
+{
+    /* swf_FontExtract moves the read position of the tags it looks at, so
+       give it a private copy of the (font related) tag list to work on */
+    TAG*tags = (TAG*)rfx_alloc(sizeof(TAG)*numfonttags);
+    SWF swf;
+    int t;
+    memcpy(tags, fonttags, sizeof(TAG)*numfonttags);
+    for(t=0;t<numfonttags;t++) {
+	tags[t].pos = 0;
+	tags[t].readBit = 0;
+	tags[t].prev = t>0?&tags[t-1]:0;
+	tags[t].next = t<numfonttags-1?&tags[t+1]:0;
+    }
+    memset(&swf, 0, sizeof(swf));
+    swf.firstTag = tags;
+
+    SWFFONT*swffont = 0;
+    font_t*font = (font_t*)rfx_calloc(sizeof(font_t));
+    swf_FontExtract(&swf, c->id, &swffont);
+    rfx_free(tags);
+    if(!swffont) {
+	fprintf(stderr, "Couldn't extract font %d\n", c->id);
+	return font;
+    }
+    font->numchars = swffont->numchars;
+    font->glyphs = (gfxline_t**)rfx_calloc(sizeof(gfxline_t*)*font->numchars);
+    RGBA color_white = {255,255,255,255};
+    for(t=0;t<font->numchars;t++) {
+	if(!swffont->glyph[t].shape->fillstyle.n) {
+	    swf_ShapeAddSolidFillStyle(swffont->glyph[t].shape, &color_white);
+	}
+	SHAPE2*s2 = swf_ShapeToShape2(swffont->glyph[t].shape);
+	font->glyphs[t] = swfline_to_gfxline(s2->lines, 0, 1);
+	if(c->tag->id==ST_DEFINEFONT3) {
+	    gfxmatrix_t m = {1/20.0,0,0, 0,1/20.0,0};
+	    gfxline_transform(font->glyphs[t], &m);
+	}
+	swf_Shape2Free(s2);
+    }
+    swf_FontFree(swffont);
+    return font;
+}
+
+typedef struct _decodejobs
+{
+    character_t**chars;
+    TAG*fonttags;
+    int numfonttags;
+} decodejobs_t;
+
+static void decodeCharacter(void*self, int nr)
+{
+    decodejobs_t*jobs = (decodejobs_t*)self;
+    character_t*c = jobs->chars[nr];
+    if(c->type == TYPE_FONT)
+	c->data = decodeFont(jobs->fonttags, jobs->numfonttags, c);
+    else if(c->type == TYPE_BITMAP)
+	c->data = decodeBitmap(c);
+}
+
+/* Collect all definitions. Characters which need decoding (fonts, and
+   bitmaps unless they're decoded on first use) are independent of each
+   other and are processed on up to num_threads threads. */
+static map16_t* extractDefinitions(SWF*swf, int num_threads, char lazy_bitmaps)
 {
     map16_t*map = map16_new();
     TAG*tag = swf->firstTag;
+    decodejobs_t jobs;
+    int num = 0;
+
+    memset(&jobs, 0, sizeof(jobs));
+    for(tag=swf->firstTag;tag;tag=tag->next) {
+	if(isFontTag(tag))
+	    jobs.numfonttags++;
+    }
+    jobs.fonttags = (TAG*)rfx_calloc(sizeof(TAG)*(jobs.numfonttags+1));
+    jobs.numfonttags = 0;
+    for(tag=swf->firstTag;tag;tag=tag->next) {
+	if(isFontTag(tag))
+	    jobs.fonttags[jobs.numfonttags++] = *tag;
+    }
+    jobs.chars = (character_t**)rfx_calloc(sizeof(character_t*)*65536);
+
+    tag = swf->firstTag;
     while(tag)
     {
 	int id = 0;
@@ -361,31 +503,12 @@ static map16_t* extractDefinitions(SWF*swf)
 		tag->id == ST_DEFINEFONT2 ||
 		tag->id == ST_DEFINEFONT3) {
 	    character_t*c = rfx_calloc(sizeof(character_t));
-	    SWFFONT*swffont = 0;
-	    font_t*font = (font_t*)rfx_calloc(sizeof(font_t));
-	    swf_FontExtract(swf, id, &swffont);
-            font->numchars = swffont->numchars;
-            font->glyphs = (gfxline_t**)rfx_calloc(sizeof(gfxline_t*)*font->numchars);
-            int t;
-            RGBA color_white = {255,255,255,255};
-            for(t=0;t<font->numchars;t++) {
-                if(!swffont->glyph[t].shape->fillstyle.n) {
-                    swf_ShapeAddSolidFillStyle(swffont->glyph[t].shape, &color_white);
-                }
-                SHAPE2*s2 = swf_ShapeToShape2(swffont->glyph[t].shape);
-                font->glyphs[t] = swfline_to_gfxline(s2->lines, 0, 1);
-		if(tag->id==ST_DEFINEFONT3) {
-		    gfxmatrix_t m = {1/20.0,0,0, 0,1/20.0,0};
-		    gfxline_transform(font->glyphs[t], &m);
-		}
-                swf_Shape2Free(s2);
-            }
-            swf_FontFree(swffont);
-
+	    c->id = id;
 	    c->tag = tag;
 	    c->type = TYPE_FONT;
-	    c->data = font;
 	    map16_add_id(map, id, c);
+	    if(num<65536)
+		jobs.chars[num++] = c;
 	}
 	else if(tag->id == ST_DEFINETEXT ||
 		tag->id == ST_DEFINETEXT2) {
@@ -401,17 +524,21 @@ static map16_t* extractDefinitions(SWF*swf)
 		tag->id == ST_DEFINEBITSLOSSLESS || 
 		tag->id == ST_DEFINEBITSLOSSLESS2) {
 	    character_t*c = rfx_calloc(sizeof(character_t));
-	    int width, height;
-	    void*data = swf_ExtractImage(tag, &width, &height);
-	    gfximage_t*b = gfximage_new(data, width, height);
+	    c->id = id;
 	    c->tag = tag;
 	    c->type = TYPE_BITMAP;
-	    c->data = b;
 	    map16_add_id(map, id, c);
+	    if(!lazy_bitmaps && num<65536)
+		jobs.chars[num++] = c;
 	}
 
 	tag = tag->next;
     }
+
+    parallel_for(num, decodeCharacter, &jobs, num_threads);
+
+    rfx_free(jobs.chars);
+    rfx_free(jobs.fonttags);
     return map;
 }
 
@@ -433,12 +560,97 @@ static void increaseAge(void*self, int id, void*data)
     p->age++;
 }
 
-static map16_t* extractFrame(TAG*startTag, int frame_to_extract)
+static void framestate_init(framestate_t*s, TAG*startTag)
+{
+    s->tag = startTag;
+    s->frame = 1;
+    s->complete = 0;
+    s->depthmap = map16_new();
+}
+
+static void framestate_clear(framestate_t*s)
+{
+    if(s->depthmap) {
+	int t;
+	for(t=0;t<65536;t++) {
+	    if(s->depthmap->ids[t])
+		placement_free(s->depthmap->ids[t]);
+	}
+	map16_free(s->depthmap);
+	free(s->depthmap);
+	s->depthmap = 0;
+    }
+}
+
+static placement_t* placement_clone(placement_t*p)
 {
-    map16_t*depthmap = map16_new();
-    TAG*tag = startTag;
-    int frame = 1;
-    int insprite = 0;
+    placement_t*c = rfx_alloc(sizeof(placement_t));
+    *c = *p;
+    if(p->po.name)
+	c->po.name = strdup(p->po.name);
+    return c;
+}
+
+static snapshot_t* snapshot_new(framestate_t*s)
+{
+    snapshot_t*snapshot = rfx_calloc(sizeof(snapshot_t));
+    int t;
+    snapshot->tag = s->tag;
+    snapshot->frame = s->frame;
+    for(t=0;t<65536;t++) {
+	if(s->depthmap->ids[t])
+	    snapshot->num++;
+    }
+    snapshot->placements = rfx_calloc(sizeof(placement_t)*(snapshot->num?snapshot->num:1));
+    snapshot->num = 0;
+    for(t=0;t<65536;t++) {
+	placement_t*p = s->depthmap->ids[t];
+	if(p) {
+	    placement_t*c = &snapshot->placements[snapshot->num++];
+	    *c = *p;
+	    if(p->po.name)
+		c->po.name = strdup(p->po.name);
+	}
+    }
+    return snapshot;
+}
+
+static void snapshot_restore(snapshot_t*snapshot, framestate_t*s)
+{
+    int t;
+    s->tag = snapshot->tag;
+    s->frame = snapshot->frame;
+    s->complete = 1;
+    s->depthmap = map16_new();
+    for(t=0;t<snapshot->num;t++) {
+	placement_t*p = placement_clone(&snapshot->placements[t]);
+	map16_add_id(s->depthmap, p->po.depth, p);
+    }
+}
+
+static void snapshot_free(snapshot_t*snapshot)
+{
+    int t;
+    for(t=0;t<snapshot->num;t++) {
+	swf_PlaceObjectFree(&snapshot->placements[t].po);
+    }
+    free(snapshot->placements);
+    free(snapshot);
+}
+
+/* process tags until the display list of frame_to_extract is complete, or the
+   timeline ends. Frames before the current one can't be reached. */
+static void framestate_advance(framestate_t*s, int frame_to_extract)
+{
+    TAG*tag = s->tag;
+
+    if(s->complete) {
+	if(s->frame == frame_to_extract || !tag)
+	    return;
+	s->frame++;
+	s->complete = 0;
+	map16_enumerate(s->depthmap, increaseAge, 0);
+    }
 
     for(;tag;tag = tag->next) {
 	if(tag->id == ST_DEFINESPRITE) {
@@ -450,39 +662,76 @@ static map16_t* extractFrame(TAG*startTag, int frame_to_extract)
 	   tag->id == ST_PLACEOBJECT2) {
             placement_t* p = rfx_calloc(sizeof(placement_t));
 	    p->age = 1;
-	    p->startFrame = frame;
+	    p->startFrame = s->frame;
             swf_GetPlaceObject(tag, &p->po);
-	    if(p->po.move) {
-		placement_t*old = (placement_t*)map16_get_id(depthmap, p->po.depth);
-	
-		if(!(p->po.flags&PF_CHAR)) p->po.id = old->po.id;
-		if(!(p->po.flags&PF_MATRIX)) p->po.matrix = old->po.matrix;
-		if(!(p->po.flags&PF_CXFORM)) p->po.cxform = old->po.cxform;
-		if(!(p->po.flags&PF_RATIO)) p->po.ratio = old->po.ratio;
-
-		map16_remove_id(depthmap, old->po.depth);
+	    placement_t*old = (placement_t*)map16_get_id(s->depthmap, p->po.depth);
+	    if(old) {
+		if(p->po.move) {
+		    if(!(p->po.flags&PF_CHAR)) p->po.id = old->po.id;
+		    if(!(p->po.flags&PF_MATRIX)) p->po.matrix = old->po.matrix;
+		    if(!(p->po.flags&PF_CXFORM)) p->po.cxform = old->po.cxform;
+		    if(!(p->po.flags&PF_RATIO)) p->po.ratio = old->po.ratio;
+		}
+		/* a placement without the move flag replaces the old one, too */
+		map16_remove_id(s->depthmap, old->po.depth);
 		placement_free(old);
 	    }
-	    map16_add_id(depthmap, p->po.depth, p);
+	    map16_add_id(s->depthmap, p->po.depth, p);
 	}
 	if(tag->id == ST_REMOVEOBJECT ||
 	   tag->id == ST_REMOVEOBJECT2) {
 	    U16 depth = swf_GetDepth(tag);
-	    map16_remove_id(depthmap, depth);
+	    placement_t*old = (placement_t*)map16_get_id(s->depthmap, depth);
+	    map16_remove_id(s->depthmap, depth);
+	    if(old)
+		placement_free(old);
 	}
 	if(tag->id == ST_SHOWFRAME || tag->id == ST_END || !tag->next) {
-	    if(frame == frame_to_extract) {
-		return depthmap;
-	    }
-	    if(tag->id == ST_SHOWFRAME) {
-		frame++;
-		map16_enumerate(depthmap, increaseAge, 0);
+	    s->tag = tag->id == ST_END ? 0 : tag->next;
+	    s->complete = 1;
+	    if(s->frame == frame_to_extract || !s->tag) {
+		return;
 	    }
+	    s->frame++;
+	    s->complete = 0;
+	    map16_enumerate(s->depthmap, increaseAge, 0);
 	}
-	if(tag->id == ST_END) 
+    }
+    s->tag = 0;
+    s->complete = 1;
+}
+
+/* bring the document's framestate to the given frame, starting from
+   the nearest snapshot if we can't get there by moving forward */
+static framestate_t* seekFrame(swf_doc_internal_t*i, int frame)
+{
+    framestate_t*s = &i->state;
+    int k = frame / i->snapshot_interval;
+    if(k > i->num_snapshots)
+	k = i->num_snapshots;
+
+    if(!s->depthmap || s->frame > frame ||
+       (k && s->frame < i->snapshots[k-1]->frame)) {
+	framestate_clear(s);
+	if(k)
+	    snapshot_restore(i->snapshots[k-1], s);
+	else
+	    framestate_init(s, i->swf.firstTag);
+    }
+
+    /* store snapshots of all keyframes we pass on the way */
+    while(s->tag) {
+	int next = (i->num_snapshots+1)*i->snapshot_interval;
+	if(next > frame || s->frame > next)
 	    break;
+	framestate_advance(s, next);
+	if(s->frame != next || !s->tag)
+	    break;
+	i->snapshots = rfx_realloc(i->snapshots, sizeof(snapshot_t*)*(i->num_snapshots+1));
+	i->snapshots[i->num_snapshots++] = snapshot_new(s);
     }
-    return depthmap;
+    framestate_advance(s, frame);
+    return s;
 }
 
 // ---- rendering ----
@@ -602,9 +851,11 @@ static void placeObject(void*self, int id, void*data)
 
         sprite_t* s = (sprite_t*)c->data;
 
-	TAG*spritetags = c->tag->next;
-        map16_t* depths = extractFrame(spritetags, s->frameCount>0? p->age % s->frameCount : 0);
-        map16_enumerate(depths, placeObject, r);
+	framestate_t state;
+	framestate_init(&state, c->tag->next);
+	framestate_advance(&state, s->frameCount>0? p->age % s->frameCount : 0);
+        map16_enumerate(state.depthmap, placeObject, r);
+        framestate_clear(&state);
        
         int t;
         for(t=0;t<65536;t++) {
@@ -634,7 +885,7 @@ void swfpage_render(gfxpage_t*page, gfxdevice_t*output)
 {
     swf_page_internal_t*i = (swf_page_internal_t*)page->internal;
     swf_doc_internal_t*pi = (swf_doc_internal_t*)page->parent->internal;
-    map16_t* depths = extractFrame(pi->swf.firstTag, i->frame);
+    map16_t* depths = seekFrame(pi, i->frame)->depthmap;
     render_t r;
     r.id2char = pi->id2char;
     r.clips = 0;
@@ -667,6 +918,12 @@ void swfpage_rendersection(gfxpage_t*page, gfxdevice_t*output, gfxcoord_t x, gfx
 void swf_doc_destroy(gfxdocument_t*gfx)
 {
     swf_doc_internal_t*i= (swf_doc_internal_t*)gfx->internal;
+    int t;
+    framestate_clear(&i->state);
+    for(t=0;t<i->num_snapshots;t++) {
+	snapshot_free(i->snapshots[t]);
+    }
+    free(i->snapshots);
     swf_FreeTags(&i->swf);
     free(gfx->internal);gfx->internal=0;
     free(gfx);gfx=0;
@@ -675,6 +932,11 @@ void swf_doc_destroy(gfxdocument_t*gfx)
 void swf_doc_setparameter(gfxdocument_t*gfx, const char*name, const char*value)
 {
     swf_doc_internal_t*i= (swf_doc_internal_t*)gfx->internal;
+    if(!strcmp(name, "snapshotinterval")) {
+	int interval = atoi(value);
+	if(interval > 0 && !i->num_snapshots)
+	    i->snapshot_interval = interval;
+    }
 }
 
 gfxpage_t* swf_doc_getpage(gfxdocument_t*doc, int page)
@@ -702,7 +964,13 @@ gfxpage_t* swf_doc_getpage(gfxdocument_t*doc, int page)
 
 void swf_setparameter(gfxsource_t*src, const char*name, const char*value)
 {
+    swf_source_internal_t*i = (swf_source_internal_t*)src->internal;
     msg("<verbose> setting parameter %s to \"%s\"", name, value);
+    if(!strcmp(name, "threads")) {
+	i->num_threads = atoi(value);
+    } else if(!strcmp(name, "lazybitmaps")) {
+	i->lazy_bitmaps = atoi(value);
+    }
 }
 
 gfxdocument_t*swf_open(gfxsource_t*src, const char*filename)
@@ -733,7 +1001,8 @@ gfxdocument_t*swf_open(gfxsource_t*src, const char*filename)
     }
     swf_UnFoldAll(&i->swf);
     
-    i->id2char = extractDefinitions(&i->swf);
+    swf_source_internal_t*si = (swf_source_internal_t*)src->internal;
+    i->id2char = extractDefinitions(&i->swf, si->num_threads, si->lazy_bitmaps);
     i->width = (i->swf.movieSize.xmax - i->swf.movieSize.xmin) / 20;
     i->height = (i->swf.movieSize.ymax - i->swf.movieSize.ymin) / 20;
     
@@ -741,6 +1010,8 @@ gfxdocument_t*swf_open(gfxsource_t*src, const char*filename)
     i->m.tx = -i->swf.movieSize.xmin;
     i->m.ty = -i->swf.movieSize.ymin;
 
+    i->snapshot_interval = SNAPSHOT_INTERVAL;
+
     swf_doc->num_pages = i->swf.frameCount;
     swf_doc->internal = i;
     swf_doc->get = 0;
@@ -753,6 +1024,7 @@ gfxdocument_t*swf_open(gfxsource_t*src, const char*filename)
 
 static void swf_destroy(gfxsource_t*src)
 {
+    free(src->internal);
     memset(src, 0, sizeof(*src));
     free(src);
 }
@@ -765,6 +1037,10 @@ gfxsource_t*gfxsource_swf_create()
     src->setparameter = swf_setparameter;
     src->open = swf_open;
     src->destroy = swf_destroy;
+    swf_source_internal_t*i = (swf_source_internal_t*)rfx_calloc(sizeof(swf_source_internal_t));
+    i->num_threads = 0; // one per processor
+    i->lazy_bitmaps = 1;
+    src->internal = i;
     return src;
 }
 
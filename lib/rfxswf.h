@@ -712,6 +712,8 @@ void swf_DumpFont(SWFFONT * font);
 
 int swf_ImageHasAlpha(RGBA*img, int width, int height);
 int swf_ImageGetNumberOfPaletteEntries(RGBA*img, int width, int height, RGBA*palette);
+int swf_ImageGetPalette(RGBA*img, int width, int height, RGBA*palette, U8*indices, int bpl);
+int swf_ImageQuantize(RGBA*img, int width, int height, int numcolors, double maxerror, char dither, RGBA*palette, U8*indices, int bpl);
 
 typedef int JPEGBITS;
 JPEGBITS * swf_SetJPEGBitsStart(TAG * t,int width,int height,int quality); // deprecated
@@ -737,13 +739,19 @@ void swf_SaveJPEG(char*filename, RGBA*pixels, int width, int height, int quality
 
 int swf_SetLosslessBits(TAG * t,U16 width,U16 height,void * bitmap,U8 bitmap_flags);
 int swf_SetLosslessBitsIndexed(TAG * t,U16 width,U16 height,U8 * bitmap,RGBA * palette,U16 ncolors);
+int swf_SetLosslessBitsIndexedRows(TAG * t,U16 width,U16 height,int (*getrow)(void*user, U8*row),void*user,RGBA * palette,U16 ncolors);
 int swf_SetLosslessBitsGrayscale(TAG * t,U16 width,U16 height,U8 * bitmap);
+void swf_PreMultiplyAlpha(RGBA*data, int width, int height);
 void swf_SetLosslessImage(TAG*tag, RGBA*data, int width, int height); //WARNING: will change tag->id
+void swf_SetLosslessImageQuantized(TAG*tag, RGBA*data, int width, int height, double maxerror, char dither); //WARNING: will change tag->id
+int swf_SetLosslessImageRows(TAG*tag, int width, int height, int (*getrow)(void*user, RGBA*row), void*user); //WARNING: will change tag->id
 
 RGBA* swf_DefineLosslessBitsTagToImage(TAG*tag, int*width, int*height);
 
 RGBA* swf_ExtractImage(TAG*tag, int*dwidth, int*dheight);
 TAG* swf_AddImage(TAG*tag, int bitid, RGBA*mem, int width, int height, int quality);
+TAG* swf_AddImageQuantized(TAG*tag, int bitid, RGBA*mem, int width, int height, int quality, double maxerror, char dither);
+TAG* swf_AddImageAdaptive(TAG*tag, int bitid, RGBA*mem, int width, int height, int quality, double minpsnr, int num_threads);
 
 // swfsound.c
 void swf_SetSoundStreamHead(TAG*tag, int avgnumsamples);
@@ -1113,6 +1121,7 @@ typedef struct RENDERBUF
 void swf_Render_Init(RENDERBUF*buf, int posx, int posy, int width, int height, int antialize, int multiply);
 void swf_Render_SetBackground(RENDERBUF*buf, RGBA*img, int width, int height);
 void swf_Render_SetBackgroundColor(RENDERBUF*buf, RGBA color);
+void swf_Render_SetGlyphCacheSize(RENDERBUF*buf, int size); /* in bytes, default 4MB. 0 disables the glyph cache */
 RGBA* swf_Render(RENDERBUF*dest);
 void swf_RenderShape(RENDERBUF*dest, SHAPE2*shape, MATRIX*m, CXFORM*c, U16 depth,U16 clipdepth);
 void swf_RenderSWF(RENDERBUF*buf, SWF*swf);
@@ -1120,6 +1129,18 @@ void swf_Render_AddImage(RENDERBUF*buf, U16 id, RGBA*img, int width, int height)
 void swf_Render_ClearCanvas(RENDERBUF*dest);
 void swf_Render_Delete(RENDERBUF*dest);
 
+typedef struct RENDERMOVIE
+{
+    RENDERBUF*buf;
+    int frame; /* frame currently in the render buffer (starting at 1) */
+    int numframes;
+    void*internal;
+} RENDERMOVIE;
+
+void swf_RenderMovie_Init(RENDERMOVIE*movie, RENDERBUF*buf, SWF*swf);
+int swf_RenderMovie_NextFrame(RENDERMOVIE*movie); /* returns 0 after the last frame */
+void swf_RenderMovie_Delete(RENDERMOVIE*movie);
+
 // swffilter.c
 
 #define FILTERTYPE_DROPSHADOW 0
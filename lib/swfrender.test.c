@@ -0,0 +1,123 @@
+/* Renders a text movie with and without the glyph cache, with enough
+   differently scaled glyphs to overflow the cache, and checks that the
+   results match. Cached glyphs are rasterized at a different position
+   than the one they are drawn at, and the rasterizer's rounding depends
+   on the position, so a few edge pixels (at most MAX_EDGE_PIXELS) may
+   differ. Rendering the movie again into the same RENDERBUF, with the
+   cache already filled, has to give exactly the same image. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "rfxswf.h"
+
+#define WIDTH 400
+#define HEIGHT 300
+#define MAX_EDGE_PIXELS (WIDTH*HEIGHT/2000)
+
+static void make_movie(SWF*swf, SWFFONT*font)
+{
+    RGBA black = {255,0,0,0};
+    RGBA white = {255,255,255,255};
+    /* repeated letters are drawn from the cache, at different subpixel positions */
+    char*text = "the quick brown fox jumps over the lazy dog. THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG.";
+    TAG*tag;
+    int t;
+
+    memset(swf, 0, sizeof(SWF));
+    swf->fileVersion = 8;
+    swf->frameRate = 0x1900;
+    swf->movieSize.xmax = WIDTH*20;
+    swf->movieSize.ymax = HEIGHT*20;
+
+    tag = swf->firstTag = swf_InsertTag(0, ST_SETBACKGROUNDCOLOR);
+    swf_SetRGB(tag, &white);
+
+    font->id = 1;
+    swf_FontCreateLayout(font);
+    swf_FontInitUsage(font);
+    swf_FontUseUTF8(font, (U8*)text, 0xffff);
+    tag = swf_InsertTag(tag, ST_DEFINEFONT2);
+    swf_FontSetDefine2(tag, font);
+
+    tag = swf_InsertTag(tag, ST_DEFINETEXT);
+    swf_SetU16(tag, 2);
+    swf_SetDefineText(tag, font, &black, text, 20);
+
+    /* every scale factor rasterizes every glyph again. 75 scale factors
+       are several times the size of the glyph cache. Each of them is used
+       for two rows, which start at different subpixel positions. */
+    for(t=0;t<150;t++) {
+	MATRIX m;
+	swf_GetMatrix(0, &m);
+	m.sx = m.sy = 0x10000 + (t/2)*0x2000;
+	m.tx = (t%7)*20 + (t*7)%20;
+	m.ty = (t%40)*HEIGHT*20/40 + (t*3)%20;
+	tag = swf_InsertTag(tag, ST_PLACEOBJECT2);
+	swf_ObjectPlace(tag, 2, t+1, &m, 0, 0);
+    }
+    tag = swf_InsertTag(tag, ST_SHOWFRAME);
+    tag = swf_InsertTag(tag, ST_END);
+}
+
+static RGBA* render(RENDERBUF*buf, SWF*swf)
+{
+    swf_RenderSWF(buf, swf);
+    return swf_Render(buf);
+}
+
+static int count_differences(RGBA*img1, RGBA*img2)
+{
+    int t, num = 0;
+    for(t=0;t<WIDTH*HEIGHT;t++) {
+	if(memcmp(&img1[t], &img2[t], sizeof(RGBA)))
+	    num++;
+    }
+    return num;
+}
+
+int main(int argn, char*argv[])
+{
+    char*fontfile = argn>1 ? argv[1] : "../doc/Arial.swf";
+    SWFFONT*font = swf_ReadFont(fontfile);
+    if(!font) {
+	fprintf(stderr, "Couldn't read font %s\n", fontfile);
+	return 1;
+    }
+    SWF swf;
+    make_movie(&swf, font);
+
+    int errors = 0;
+    int antialize;
+    for(antialize=1;antialize<=4;antialize*=2) {
+	RENDERBUF buf;
+	swf_Render_Init(&buf, 0, 0, WIDTH, HEIGHT, antialize, 1);
+	swf_Render_SetGlyphCacheSize(&buf, 0);
+	RGBA*reference = render(&buf, &swf);
+	swf_Render_Delete(&buf);
+
+	swf_Render_Init(&buf, 0, 0, WIDTH, HEIGHT, antialize, 1);
+	RGBA*first = render(&buf, &swf);
+	RGBA*second = render(&buf, &swf);
+	swf_Render_Delete(&buf);
+
+	int num = count_differences(first, reference);
+	if(num > MAX_EDGE_PIXELS) {
+	    printf("antialize %d: %d pixels differ from the uncached rendering (allowed: %d)\n",
+		    antialize, num, MAX_EDGE_PIXELS);
+	    errors++;
+	}
+	if(count_differences(second, first)) {
+	    printf("antialize %d: rendering with a filled cache differs from the first one\n", antialize);
+	    errors++;
+	}
+	free(reference);
+	free(first);
+	free(second);
+    }
+
+    swf_FreeTags(&swf);
+    swf_FontFree(font);
+    printf("%s\n", errors ? "FAILED" : "ok");
+    return errors ? 1 : 0;
+}
@@ -27,6 +27,7 @@
 #include <fcntl.h>
 #include <gif_lib.h>
 #include "../lib/rfxswf.h"
+#include "../lib/os.h"
 #include "../lib/args.h"
 
 #define MAX_INPUT_FILES 1024
@@ -47,12 +48,24 @@ static struct {
     char *outfile;
     int imagecount;
     int loopcount;
+    int jobs;
 } global;
 
 struct {
     char *filename;
 } image[MAX_INPUT_FILES];
 
+typedef struct _frame {
+    char *filename;
+    int id;
+    int imgidx;
+    TAG *bitmap;
+    int width;
+    int height;
+    int disposal;               // disposal method of the previous frame
+    U16 delay;
+} frame_t;
+
 struct gif_header {
     int width;
     int height;
@@ -194,12 +207,14 @@ int MovieFinish(SWF * swf, TAG * t, char *sname)
     return 0;
 }
 
-TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
+/* decodes frame f->imgidx of f->filename into a (not yet linked)
+   bitmap tag. This is called from several threads at once. */
+TAG *MakeBitmap(frame_t * f)
 {
-    SHAPE *s;
-    SRECT r;
-    MATRIX m;
-    int fs;
+    TAG *t;
+    char *sname = f->filename;
+    int id = f->id;
+    int imgidx = f->imgidx;
 
     U8 *imagedata, *from, *to;
     GifImageDesc *img;
@@ -216,9 +231,6 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
     GifColorType c;
     int interlacedOffset[] = { 0, 4, 2, 1 };    // The way Interlaced image should
     int interlacedJumps[] = { 8, 8, 4, 2 };     // be read - offsets and jumps...
-    U16 delay, depth;
-    int disposal;
-    char *as_lastframe;
 
     GifFileType *gft;
     FILE *fi;
@@ -226,18 +238,18 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
     if ((fi = fopen(sname, "rb")) == NULL) {
         if (VERBOSE(1))
             fprintf(stderr, "Read access failed: %s\n", sname);
-        return t;
+        return NULL;
     }
     fclose(fi);
 
     if ((gft = DGifOpenFileName(sname)) == NULL) {
         fprintf(stderr, "%s is not a GIF file!\n", sname);
-        return t;
+        return NULL;
     }
 
     if (DGifSlurp(gft) != GIF_OK) {
         PrintGifError();
-        return t;
+        return NULL;
     }
 
     header.width = gft->SWidth;
@@ -285,7 +297,7 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
         }
     }
 
-    t = swf_InsertTag(t, bpp == 4 ? ST_DEFINEBITSLOSSLESS2 : ST_DEFINEBITSLOSSLESS);
+    t = swf_InsertTag(NULL, bpp == 4 ? ST_DEFINEBITSLOSSLESS2 : ST_DEFINEBITSLOSSLESS);
     swf_SetU16(t, id);          // id
 
     // Ah! The Flash specs says scanlines must be DWORD ALIGNED!
@@ -351,6 +363,38 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
     }
     swf_SetLosslessBitsIndexed(t, header.width, header.height, imagedata, pal, 256);
 
+    f->width = header.width;
+    f->height = header.height;
+    f->disposal = imgidx > 0 ? getGifDisposalMethod(gft, imgidx - 1) : -1;
+    f->delay = getGifDelayTime(gft, imgidx); // delay in 1/100 sec
+
+    free(pal);
+    free(imagedata);
+    DGifCloseFile(gft);
+
+    return t;
+}
+
+TAG *MovieAddFrame(SWF * swf, TAG * t, frame_t * f)
+{
+    SHAPE *s;
+    SRECT r;
+    MATRIX m;
+    int fs;
+    int id = f->id;
+    int imgidx = f->imgidx;
+    U16 delay, depth;
+    int disposal;
+    char *as_lastframe;
+
+    if (!f->bitmap)
+        return t;
+
+    f->bitmap->prev = t;
+    f->bitmap->next = t->next;
+    t->next = f->bitmap;
+    t = f->bitmap;
+
     t = swf_InsertTag(t, ST_DEFINESHAPE);
 
     swf_ShapeNew(&s);
@@ -362,8 +406,8 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
     swf_SetU16(t, id + 1);      // id
 
     r.xmin = r.ymin = 0;
-    r.xmax = header.width * 20;
-    r.ymax = header.height * 20;
+    r.xmax = f->width * 20;
+    r.ymax = f->height * 20;
     swf_SetRect(t, &r);
 
     swf_SetShapeHeader(t, s);
@@ -380,7 +424,7 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
     if ((imgidx > 0) &&         // REMOVEOBJECT2 not needed at frame 1(imgidx==0)
         (global.imagecount > 1)) {
         // check last frame's disposal method
-        if ((disposal = getGifDisposalMethod(gft, imgidx - 1)) >= 0) {
+        if ((disposal = f->disposal) >= 0) {
             switch (disposal) {
             case NONE:
                 // [Replace one full-size, non-transparent frame with another]
@@ -420,8 +464,8 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
     t = swf_InsertTag(t, ST_PLACEOBJECT2);
 
     swf_GetMatrix(NULL, &m);
-    m.tx = (swf->movieSize.xmax - (int) header.width * 20) / 2;
-    m.ty = (swf->movieSize.ymax - (int) header.height * 20) / 2;
+    m.tx = (swf->movieSize.xmax - f->width * 20) / 2;
+    m.ty = (swf->movieSize.ymax - f->height * 20) / 2;
     swf_ObjectPlace(t, id + 1, depth, &m, NULL, NULL);
 
     if ((global.imagecount > 1) && (global.loopcount > 0)) { // 0 means infinite loop
@@ -433,7 +477,7 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
 
     if (global.imagecount > 1) { // multi-frame GIF?
         int framecnt;
-        delay = getGifDelayTime(gft, imgidx); // delay in 1/100 sec
+        delay = f->delay; // delay in 1/100 sec
         framecnt = (int) (global.framerate * (delay / 100.0));
         if (framecnt > 1) {
             if (VERBOSE(2))
@@ -453,13 +497,33 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id, int imgidx)
         }
     }
 
-    free(pal);
-    free(imagedata);
-    DGifCloseFile(gft);
-
     return t;
 }
 
+typedef struct _movie {
+    SWF *swf;
+    TAG *t;
+    frame_t *frames;
+    int framesperfile;
+} movie_t;
+
+static void convert_frame(void *data, int nr)
+{
+    movie_t *movie = (movie_t *) data;
+    movie->frames[nr].bitmap = MakeBitmap(&movie->frames[nr]);
+}
+
+static void add_frame(void *data, int nr)
+{
+    movie_t *movie = (movie_t *) data;
+    frame_t *f = &movie->frames[nr];
+    if (VERBOSE(3) && !f->imgidx)
+        fprintf(stderr, "[%03i] %s\n", nr / movie->framesperfile, f->filename);
+    movie->t = MovieAddFrame(movie->swf, movie->t, f);
+    if (f->imgidx == movie->framesperfile - 1)
+        free(f->filename);
+}
+
 int CheckInputFile(char *fname, char **realname)
 {
     FILE *fi;
@@ -581,6 +645,12 @@ int args_callback_option(char *arg, char *val)
             res = 1;
             break;
 
+        case 'J':
+            if (val)
+                global.jobs = atoi(val);
+            res = 1;
+            break;
+
         case 'V':
             printf("gif2swf - part of %s %s\n", PACKAGE, VERSION);
             exit(0);
@@ -608,6 +678,7 @@ static struct options_t options[] = {
 {"Y", "pixel"},
 {"v", "verbose"},
 {"C", "cgi"},
+{"J", "jobs"},
 {"V", "version"},
 {0,0}
 };
@@ -651,6 +722,7 @@ void args_callback_usage(char *name)
     printf("-Y , --pixel <height>          Force movie height to <height> (default: autodetect)\n");
     printf("-v , --verbose <level>         Set verbose level (0=quiet, 1=default, 2=debug)\n");
     printf("-C , --cgi                     For use as CGI- prepend http header, write to stdout\n");
+    printf("-J , --jobs <num>              Convert <num> frames at once (0 = one per processor)\n");
     printf("-V , --version                 Print version information and exit\n");
     printf("\n");
 }
@@ -666,6 +738,7 @@ int main(int argc, char **argv)
     global.verbose = 1;
     global.version = 5;
     global.loopcount = -1;
+    global.jobs = 1;
 
     processargs(argc, argv);
 
@@ -686,14 +759,25 @@ int main(int argc, char **argv)
                    global.force_height ? global.force_height : global.max_image_height);
     {
         int i, j;
+        movie_t movie;
+        movie.swf = &swf;
+        movie.t = t;
+        movie.framesperfile = global.imagecount > 1 ? global.imagecount : 1;
+        movie.frames = (frame_t *) calloc(global.nfiles * movie.framesperfile, sizeof(frame_t));
         for (i = 0; i < global.nfiles; i++) {
-            if (VERBOSE(3))
-                fprintf(stderr, "[%03i] %s\n", i, image[i].filename);
-            t = MovieAddFrame(&swf, t, image[i].filename, (i * 2) + 1, 0);
-            for (j = 2; j <= global.imagecount; j++)
-                t = MovieAddFrame(&swf, t, image[i].filename, (j * 2) - 1, j - 1);
-            free(image[i].filename);
+            for (j = 0; j < movie.framesperfile; j++) {
+                frame_t *f = &movie.frames[i * movie.framesperfile + j];
+                f->filename = image[i].filename;
+                f->id = j ? (j * 2) + 1 : (i * 2) + 1;
+                f->imgidx = j;
+            }
         }
+        /* the frames are decoded and compressed on up to global.jobs
+           threads, and added in order */
+        parallel_pipeline(global.nfiles * movie.framesperfile, convert_frame, add_frame,
+                          &movie, global.jobs, 0);
+        t = movie.t;
+        free(movie.frames);
     }
 
     MovieFinish(&swf, t, global.outfile);
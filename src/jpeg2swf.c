@@ -26,6 +26,7 @@
 #include <fcntl.h>
 #include <jpeglib.h>
 #include "../lib/rfxswf.h"
+#include "../lib/os.h"
 #include "../lib/args.h"	// not really a header ;-)
 
 #define MAX_INPUT_FILES 1024
@@ -47,6 +48,7 @@ static struct {
     int version;
     int fit_to_movie;
     float scale;
+    int jobs;
 } global;
 
 static int custom_move=0;
@@ -60,6 +62,8 @@ typedef struct _image {
     int quality;
     int width;
     int height;
+    TAG *bitmap;
+    RGBA *pic;
 } image_t;
 image_t image[MAX_INPUT_FILES];
 
@@ -229,8 +233,7 @@ int getJPEG(char*filename, int* width, int* height, RGBA**pic2)
 
 
 int frame = 0;
-TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int quality, 
-		   int width, int height)
+TAG *MovieAddFrame(SWF * swf, TAG * t, image_t * i)
 {
     SHAPE *s;
     SRECT r;
@@ -238,26 +241,31 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int quality,
     int fs;
     int movie_width = swf->movieSize.xmax - swf->movieSize.xmin;
     int movie_height = swf->movieSize.ymax - swf->movieSize.ymin;
+    int width = i->width;
+    int height = i->height;
 
     if(global.mx) {
-	int sizex, sizey;
-	RGBA * pic2;
 	SWFPLACEOBJECT obj;
 	int quant=0;
-	getJPEG(sname, &sizex, &sizey, &pic2);
-	if(sizex != stream.owidth || sizey != stream.oheight) {
+	if(!i->pic) {
+	    fprintf(stderr, "Couldn't decode %s\n", i->filename);
+	    exit(1);
+	}
+	if(width != stream.owidth || height != stream.oheight) {
 	    fprintf(stderr, "All images must have the same dimensions if using -m!");
 	    exit(1);
 	}
 
 	t = swf_InsertTag(t, ST_VIDEOFRAME);
 	swf_SetU16(t, 0xf00d);
-	quant = 1+(30-(30*quality)/100);
+	quant = 1+(30-(30*i->quality)/100);
 	if(!(frame%20)) {
-	    swf_SetVideoStreamIFrame(t, &stream, pic2, quant);
+	    swf_SetVideoStreamIFrame(t, &stream, i->pic, quant);
 	} else {
-	    swf_SetVideoStreamPFrame(t, &stream, pic2, quant);
+	    swf_SetVideoStreamPFrame(t, &stream, i->pic, quant);
 	}
+	free(i->pic);
+	i->pic = 0;
 
 	t = swf_InsertTag(t, ST_PLACEOBJECT2);
 	swf_GetPlaceObject(0, &obj);
@@ -273,9 +281,11 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int quality,
 
 	t = swf_InsertTag(t, ST_SHOWFRAME);
     } else {
-	t = swf_InsertTag(t, ST_DEFINEBITSJPEG2);
-	swf_SetU16(t, global.next_id);		// id
-	swf_SetJPEGBits(t,sname,quality);
+	PUT16(i->bitmap->data, global.next_id);	// id
+	i->bitmap->prev = t;
+	i->bitmap->next = t->next;
+	t->next = i->bitmap;
+	t = i->bitmap;
 
 	t = swf_InsertTag(t, ST_DEFINESHAPE);
 	swf_ShapeNew(&s);
@@ -333,6 +343,37 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int quality,
     return t;
 }
 
+typedef struct _movie {
+    SWF *swf;
+    TAG *t;
+} movie_t;
+
+/* decoding and jpeg compression happen in parallel. The bitmap
+   ids are only known once a frame is added, and H.263 frames depend
+   on the previous frame, so those two steps happen in order. */
+static void convert_image(void *data, int nr)
+{
+    image_t *i = &image[nr];
+    if(global.mx) {
+	if(getJPEG(i->filename, &i->width, &i->height, &i->pic) != 1)
+	    i->pic = 0;
+    } else {
+	i->bitmap = swf_InsertTag(NULL, ST_DEFINEBITSJPEG2);
+	swf_SetU16(i->bitmap, 0);	// id, filled in by MovieAddFrame
+	swf_SetJPEGBits(i->bitmap, i->filename, i->quality);
+    }
+}
+
+static void add_image(void *data, int nr)
+{
+    movie_t *movie = (movie_t *) data;
+    if (VERBOSE(3))
+	fprintf(stderr, "[%03i] %s (%i%%)\n", nr,
+		image[nr].filename, image[nr].quality);
+    movie->t = MovieAddFrame(movie->swf, movie->t, &image[nr]);
+    free(image[nr].filename);
+}
+
 int CheckInputFile(image_t* i, char *fname, char **realname)
 {
     struct jpeg_decompress_struct cinfo;
@@ -522,6 +563,11 @@ int args_callback_option(char *arg, char *val)
 	    break;
 	}
 
+	case 'J':
+	    global.jobs = atoi(val);
+	    res = 1;
+	    break;
+
 	default:
 	    res = -1;
 	    break;
@@ -551,6 +597,7 @@ static struct options_t options[] = {
 {"V", "version"},
 {"f", "fit-to-movie"},
 {"e", "export"},
+{"J", "jobs"},
 {0,0}
 };
 
@@ -599,6 +646,7 @@ void args_callback_usage(char *name)
     printf("-V , --version                 Print version information and exit\n");
     printf("-f , --fit-to-movie            Fit images to movie size\n");
     printf("-e , --export <assetname>          Make importable as asset with <assetname>\n");
+    printf("-J , --jobs <num>              Convert <num> images at once (0 = one per processor)\n");
     printf("\n");
 }
 
@@ -618,6 +666,7 @@ int main(int argc, char **argv)
     global.next_id = 1;
     global.fit_to_movie = 0;
     global.scale = 1.0;
+    global.jobs = 1;
 	
     processargs(argc, argv);
 
@@ -629,15 +678,11 @@ int main(int argc, char **argv)
 		   global.force_height ? global.force_height : (int)(global.max_image_height*global.scale));
 
     {
-	int i;
-	for (i = 0; i < global.nfiles; i++) {
-	    if (VERBOSE(3))
-		fprintf(stderr, "[%03i] %s (%i%%)\n", i,
-			image[i].filename, image[i].quality);
-	    t = MovieAddFrame(&swf, t, image[i].filename, image[i].quality,
-			      image[i].width, image[i].height);
-	    free(image[i].filename);
-	}
+	movie_t movie;
+	movie.swf = &swf;
+	movie.t = t;
+	parallel_pipeline(global.nfiles, convert_image, add_image, &movie, global.jobs, 0);
+	t = movie.t;
     }
 
     MovieFinish(&swf, t, global.outfile);
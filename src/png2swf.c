@@ -28,6 +28,7 @@
 #include "../lib/args.h"
 #include "../lib/log.h"
 #include "../lib/png.h"
+#include "../lib/os.h"
 
 #define MAX_INPUT_FILES 1024
 #define VERBOSE(x) (global.verbose>=x)
@@ -45,10 +46,13 @@ static struct {
     char *outfile;
     int mkjpeg;
     float scale;
+    int jobs;
 } global;
 
-static struct {
+static struct _image {
     char *filename;
+    TAG *bitmap;
+    unsigned width, height;
 } image[MAX_INPUT_FILES];
 
 static int custom_move=0;
@@ -111,390 +115,79 @@ int MovieFinish(SWF * swf, TAG * t, char *sname)
     return 0;
 }
 
-int png_read_chunk(char (*head)[4], int*destlen, U8**destdata, FILE*fi)
-{
-    unsigned int len;
-    if(destlen) *destlen=0;
-    if(destdata) *destdata=0;
-    if(!fread(&len, 4, 1, fi))
-	return 0;
-    if(!fread(head, 4, 1, fi))
-	return 0;
-    len = BE_32_TO_NATIVE(len);
-    if(destlen) *destlen = len;
-    if(destdata) {
-	if(len)
-	    *destdata = malloc(len);
-	else 
-	    *destdata = 0;
-	if(!fread(*destdata, len, 1, fi)) {
-	    *destdata = 0;
-	    if(destlen) *destlen=0;
-	    return 0;
-	}
-	fseek(fi, 4, SEEK_CUR);
-
-    } else {
-	fseek(fi, len+4, SEEK_CUR);
-    }
-    return 1;
-}
-
-unsigned int png_get_dword(FILE*fi)
-{
-    unsigned int a;
-    fread(&a,4,1,fi);
-    return BE_32_TO_NATIVE(a);
-}
-
-struct png_header
-{
-    int width;
-    int height;
-    int bpp;
-    int mode;
-};
-
-int png_read_header(FILE*fi, struct png_header*header)
-{
-    char id[4];
-    int len;
-    int ok=0;
-    U8 head[8] = {137,80,78,71,13,10,26,10};
-    U8 head2[8];
-    U8*data;
-    fread(head2,8,1,fi);
-    if(strncmp((char*)head,(char*)head2,4))
-	return 0;
-   
-    while(png_read_chunk(&id, &len, &data, fi))
-    {
-	if(VERBOSE(2))
-	    printf("%c%c%c%c %d\n", id[0],id[1],id[2],id[3],len);
-	if(!strncasecmp(id, "IHDR", 4)) {
-	    char a,b,c,f,i;
-	    if(len < 8) exit(1);
-	    header->width = BE_32_TO_NATIVE(*(U32*)&data[0]);
-	    header->height = BE_32_TO_NATIVE(*(U32*)&data[4]);
-	    a = data[8];      // should be 8
-	    b = data[9];      // should be 3(indexed), 2(rgb), 0(grayscale) or 6(truecolor+alpha)
-
-	    c = data[10];     // compression mode (0)
-	    f = data[11];     // filter mode (0)
-	    i = data[12];     // interlace mode (0)
-	
-	    if(VERBOSE(2)) printf("image mode:%d\n", b);
-	    if(VERBOSE(2)) printf("bpp: %d\n", a);
-	    if(VERBOSE(2)) printf("compression: %d\n", c);
-	    if(VERBOSE(2)) printf("filter: %d\n", f);
-	    if(VERBOSE(2)) printf("interlace: %d\n", i);
-
-	    if(b!=0 && b!=2 && b!=3 && b!=6) {
-		fprintf(stderr, "Image mode %d not supported!\n", b);
-		if(b == 4) {
-		    fprintf(stderr, "(This is a grayscale image with alpha channel-\n");
-		    fprintf(stderr, " try converting it into an RGB image with alpha channel)\n");
-		}
-		exit(1);
-	    }
-	    if(a!=8 && (b==2 || b==6)) {
-		fprintf(stderr, "Bpp %d in mode %d not supported!\n", b, a);
-		exit(1);
-	    }
-	    if(c!=0) {
-		fprintf(stderr, "Compression mode %d not supported!\n", c);
-		exit(1);
-	    }
-	    if(f!=0) {
-		fprintf(stderr, "Filter mode %d not supported!\n", f);
-		exit(1);
-	    }
-	    if(i!=0) {
-		fprintf(stderr, "Interlace mode %d not supported!\n", i);
-		exit(1);
-	    }
-	    if(VERBOSE(2))
-		printf("%dx%d %d %d %d %d %d\n",header->width, header->height, a,b,c,f,i);
-	    header->bpp = a;
-	    header->mode = b;
-	    ok = 1;
-	} 
-	
-	free(data);
-    }
-    return ok;
-}
-
-typedef unsigned char byte;
-#define ABS(a) ((a)>0?(a):(-(a)))
-byte inline PaethPredictor (byte a,byte b,byte c)
+static int png_getrow(void*reader, RGBA*row)
 {
-        // a = left, b = above, c = upper left
-        int p = a + b - c;        // initial estimate
-        int pa = ABS(p - a);      // distances to a, b, c
-        int pb = ABS(p - b);
-        int pc = ABS(p - c);
-        // return nearest of a,b,c,
-        // breaking ties in order a,b,c.
-        if (pa <= pb && pa <= pc) 
-		return a;
-        else if (pb <= pc) 
-		return b;
-        else return c;
+    return png_reader_read_row((png_reader_t*)reader, (unsigned char*)row);
 }
 
-void applyfilter3(int mode, U8*src, U8*old, U8*dest, int width)
+static int png_getindices(void*reader, U8*row)
 {
-    int x;
-    unsigned char lastr=0;
-    unsigned char lastg=0;
-    unsigned char lastb=0;
-    unsigned char upperlastr=0;
-    unsigned char upperlastg=0;
-    unsigned char upperlastb=0;
-
-    if(mode==0) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0];
-	    dest[2] = src[1];
-	    dest[3] = src[2];
-	    dest+=4;
-	    src+=3;
-	}
-    }
-    else if(mode==1) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0]+lastr;
-	    dest[2] = src[1]+lastg;
-	    dest[3] = src[2]+lastb;
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    dest+=4;
-	    src+=3;
-	}
-    }
-    else if(mode==2) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0]+old[1];
-	    dest[2] = src[1]+old[2];
-	    dest[3] = src[2]+old[3];
-	    dest+=4;
-	    old+=4;
-	    src+=3;
-	}
-    }
-    else if(mode==3) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0]+(old[1]+lastr)/2;
-	    dest[2] = src[1]+(old[2]+lastg)/2;
-	    dest[3] = src[2]+(old[3]+lastb)/2;
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    dest+=4;
-	    old+=4;
-	    src+=3;
-	}
-    }
-    else if(mode==4) {
-	for(x=0;x<width;x++) {
-	    dest[0] = 255;
-	    dest[1] = src[0]+PaethPredictor(lastr,old[1],upperlastr);
-	    dest[2] = src[1]+PaethPredictor(lastg,old[2],upperlastg);
-	    dest[3] = src[2]+PaethPredictor(lastb,old[3],upperlastb);
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    upperlastr = old[1];
-	    upperlastg = old[2];
-	    upperlastb = old[3];
-	    dest+=4;
-	    old+=4;
-	    src+=3;
-	}
-    }    
+    return png_reader_read_indices((png_reader_t*)reader, row);
 }
 
-void applyfilter4(int mode, U8*src, U8*old, U8*dest, int width)
+/* creates the bitmap tag of an image. The tag isn't linked into
+   the movie yet, so several images can be converted at once. */
+TAG *MakeBitmap(char *sname, int id, unsigned *width, unsigned *height)
 {
-    int x;
-    unsigned char lastr=0;
-    unsigned char lastg=0;
-    unsigned char lastb=0;
-    unsigned char lasta=0; //TODO: 255?
-    unsigned char upperlastr=0;
-    unsigned char upperlastg=0;
-    unsigned char upperlastb=0;
-    unsigned char upperlasta=0; //TODO: 255?
-
-    if(mode==0) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[3];
-	    dest[1] = src[0];
-	    dest[2] = src[1];
-	    dest[3] = src[2];
-	    dest+=4;
-	    src+=4;
-	}
-    }
-    else if(mode==1) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[3]+lasta;
-	    dest[1] = src[0]+lastr;
-	    dest[2] = src[1]+lastg;
-	    dest[3] = src[2]+lastb;
-	    lasta = dest[0];
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    dest+=4;
-	    src+=4;
-	}
-    }
-    else if(mode==2) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[3]+old[0];
-	    dest[1] = src[0]+old[1];
-	    dest[2] = src[1]+old[2];
-	    dest[3] = src[2]+old[3];
-	    dest+=4;
-	    old+=4;
-	    src+=4;
-	}
-    }
-    else if(mode==3) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[3]+(old[0]+lasta)/2;
-	    dest[1] = src[0]+(old[1]+lastr)/2;
-	    dest[2] = src[1]+(old[2]+lastg)/2;
-	    dest[3] = src[2]+(old[3]+lastb)/2;
-	    lasta = dest[0];
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    dest+=4;
-	    old+=4;
-	    src+=4;
-	}
-    }
-    else if(mode==4) {
-	for(x=0;x<width;x++) {
-	    dest[0] = src[3]+PaethPredictor(lasta,old[0],upperlasta);
-	    dest[1] = src[0]+PaethPredictor(lastr,old[1],upperlastr);
-	    dest[2] = src[1]+PaethPredictor(lastg,old[2],upperlastg);
-	    dest[3] = src[2]+PaethPredictor(lastb,old[3],upperlastb);
-	    lasta = dest[0];
-	    lastr = dest[1];
-	    lastg = dest[2];
-	    lastb = dest[3];
-	    upperlasta = old[0];
-	    upperlastr = old[1];
-	    upperlastg = old[2];
-	    upperlastb = old[3];
-	    dest+=4;
-	    old+=4;
-	    src+=4;
-	}
-    }    
-
-}
-
-void applyfilter1(int mode, U8*src, U8*old, U8*dest, int width)
-{
-    int x;
-    unsigned char last=0;
-    unsigned char upperlast=0;
-
-    if(mode==0) {
-	for(x=0;x<width;x++) {
-	    *dest = *src;
-	    dest++;
-	    src++;
-	}
-    }
-    else if(mode==1) {
-	for(x=0;x<width;x++) {
-	    *dest = *src+last;
-	    last = *dest;
-	    dest++;
-	    src++;
-	}
-    }
-    else if(mode==2) {
-	for(x=0;x<width;x++) {
-	    *dest = *src+*old;
-	    dest++;
-	    old++;
-	    src++;
-	}
-    }
-    else if(mode==3) {
-	for(x=0;x<width;x++) {
-	    *dest = *src+(*old+last)/2;
-	    last = *dest;
-	    dest++;
-	    old++;
-	    src++;
-	}
-    }
-    else if(mode==4) {
-	for(x=0;x<width;x++) {
-	    *dest = *src+PaethPredictor(last,*old,upperlast);
-	    last = *dest;
-	    upperlast = *old;
-	    dest++;
-	    old++;
-	    src++;
-	}
-    }    
-
-}
-
-TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id)
-{
-    SHAPE *s;
-    SRECT r;
-    MATRIX m;
-    int fs;
-
-    unsigned width=0, height=0;
-
-#ifndef HAVE_JPEGLIB
-    if(global.mkjpeg) {
-        global.mkjpeg = 0;
-        msg("<warning> No jpeg support compiled in");
-    }
-#endif
+    TAG *t = 0;
     if(global.mkjpeg) {
 #ifdef HAVE_JPEGLIB
 	RGBA*data = 0;
-	png_load(sname, &width, &height, (unsigned char**)&data);
+	png_load(sname, width, height, (unsigned char**)&data);
 	if(!data) 
 	    exit(1);
-	if(swf_ImageHasAlpha(data, width, height)) {
-	    t = swf_InsertTag(t, ST_DEFINEBITSJPEG3);
+	if(swf_ImageHasAlpha(data, *width, *height)) {
+	    t = swf_InsertTag(0, ST_DEFINEBITSJPEG3);
 	    swf_SetU16(t, id);
-	    swf_SetJPEGBits3(t, width,height,data,global.mkjpeg);
+	    swf_SetJPEGBits3(t, *width,*height,data,global.mkjpeg);
 	} else {
-	    t = swf_InsertTag(t, ST_DEFINEBITSJPEG2);
+	    t = swf_InsertTag(0, ST_DEFINEBITSJPEG2);
 	    swf_SetU16(t, id);
-	    swf_SetJPEGBits2(t, width,height,data,global.mkjpeg);
+	    swf_SetJPEGBits2(t, *width,*height,data,global.mkjpeg);
 	}
+	free(data);
 #endif
     } else {
-	RGBA*data = 0;
-	png_load(sname, &width, &height, (unsigned char**)&data);
-	if(!data) 
+	RGBA palette[256];
+	int num, res;
+	png_reader_t*reader = png_reader_open(sname, width, height);
+	if(!reader)
 	    exit(1);
-	t = swf_InsertTag(t, ST_DEFINEBITSLOSSLESS);
+	t = swf_InsertTag(0, ST_DEFINEBITSLOSSLESS);
 	swf_SetU16(t, id);
-	swf_SetLosslessImage(t, data,width,height);
+	num = png_reader_get_palette(reader, (unsigned char*)palette);
+	if(num) {
+	    /* palette and grayscale images keep their palette, the pixels
+	       are passed through as they are */
+	    if(swf_ImageHasAlpha(palette, num, 1)) {
+		t->id = ST_DEFINEBITSLOSSLESS2;
+		swf_PreMultiplyAlpha(palette, num, 1);
+	    }
+	    res = swf_SetLosslessBitsIndexedRows(t, *width, *height, png_getindices, reader, palette, num<2 ? 2 : num);
+	} else {
+	    /* decode and compress the image one row at a time */
+	    res = swf_SetLosslessImageRows(t, *width, *height, png_getrow, reader);
+	}
+	if(res < 0) {
+	    fprintf(stderr, "Couldn't convert %s\n", sname);
+	    exit(1);
+	}
+	png_reader_close(reader);
     }
+    return t;
+}
+
+TAG *MovieAddFrame(SWF * swf, TAG * t, TAG * bitmap, unsigned width, unsigned height, int id)
+{
+    SHAPE *s;
+    SRECT r;
+    MATRIX m;
+    int fs;
+
+    bitmap->prev = t;
+    bitmap->next = t->next;
+    t->next = bitmap;
+    t = bitmap;
 
     t = swf_InsertTag(t, ST_DEFINESHAPE3);
 
@@ -546,12 +239,31 @@ TAG *MovieAddFrame(SWF * swf, TAG * t, char *sname, int id)
     return t;
 }
 
+typedef struct _movie {
+    SWF*swf;
+    TAG*t;
+} movie_t;
+
+static void convert_image(void*data, int nr)
+{
+    image[nr].bitmap = MakeBitmap(image[nr].filename, nr * 2 + 1, &image[nr].width, &image[nr].height);
+}
+
+static void add_image(void*data, int nr)
+{
+    movie_t*movie = (movie_t*)data;
+    if (VERBOSE(3))
+	fprintf(stderr, "[%03i] %s\n", nr, image[nr].filename);
+    movie->t = MovieAddFrame(movie->swf, movie->t, image[nr].bitmap, image[nr].width, image[nr].height, nr * 2 + 1);
+    free(image[nr].filename);
+}
+
 
 int CheckInputFile(char *fname, char **realname)
 {
     FILE *fi;
     char *s = malloc(strlen(fname) + 5);
-    struct png_header head;
+    unsigned width, height;
 
     if (!s)
 	exit(2);
@@ -574,17 +286,17 @@ int CheckInputFile(char *fname, char **realname)
 	}
     }
 
-    if(!png_read_header(fi, &head)) {
+    fclose(fi);
+
+    if(!png_getdimensions(s, &width, &height)) {
 	fprintf(stderr, "%s is not a PNG file!\n", fname);
 	return -1;
     }
 
-    if (global.max_image_width < head.width)
-	global.max_image_width = head.width;
-    if (global.max_image_height < head.height)
-	global.max_image_height = head.height;
-
-    fclose(fi);
+    if (global.max_image_width < width)
+	global.max_image_width = width;
+    if (global.max_image_height < height)
+	global.max_image_height = height;
 
     return 0;
 }
@@ -632,6 +344,11 @@ int args_callback_option(char *arg, char *val)
 	    res = 1;
 	    break;
 
+	case 'J':
+	    global.jobs = atoi(val);
+	    res = 1;
+	    break;
+
 	case 'T':
 	    global.version = atoi(val);
 	    res = 1;
@@ -725,6 +442,7 @@ static struct options_t options[] = {
 {"r", "rate"},
 {"o", "output"},
 {"j", "jpeg"},
+{"J", "jobs"},
 {"z", "zlib"},
 {"T", "flashversion"},
 {"X", "pixel"},
@@ -769,6 +487,7 @@ void args_callback_usage(char *name)
     printf("-r , --rate <framerate>        Set movie framerate (frames per second)\n");
     printf("-o , --output <filename>       Set name for SWF output file.\n");
     printf("-j , --jpeg <quality>          Generate a lossy jpeg bitmap inside the SWF, with a given quality (1-100)\n");
+    printf("-J , --jobs <num>              Convert <num> images at once (0 = one per processor)\n");
     printf("-z , --zlib <zlib>             Enable Flash 6 (MX) Zlib Compression\n");
     printf("-T , --flashversion            Set the flash version to generate\n");
     printf("-X , --pixel <width>           Force movie width to <width> (default: autodetect)\n");
@@ -792,6 +511,7 @@ int main(int argc, char **argv)
     global.verbose = 1;
     global.version = 8;
     global.scale = 1.0;
+    global.jobs = 1;
 
     processargs(argc, argv);
     
@@ -807,15 +527,21 @@ int main(int argc, char **argv)
 		   global.force_width ? global.force_width : (int)(global.max_image_width*global.scale),
 		   global.force_height ? global.force_height : (int)(global.max_image_height*global.scale));
 
+#ifndef HAVE_JPEGLIB
+    if(global.mkjpeg) {
+        global.mkjpeg = 0;
+        msg("<warning> No jpeg support compiled in");
+    }
+#endif
+
     {
-	int i;
-	for (i = 0; i < global.nfiles; i++) {
-	    if (VERBOSE(3))
-		fprintf(stderr, "[%03i] %s\n", i,
-			image[i].filename);
-	    t = MovieAddFrame(&swf, t, image[i].filename, (i * 2) + 1);
-	    free(image[i].filename);
-	}
+	movie_t movie;
+	movie.swf = &swf;
+	movie.t = t;
+	/* the images are converted on up to global.jobs threads, and added
+	   in order. At most two finished bitmaps per thread wait for that. */
+	parallel_pipeline(global.nfiles, convert_image, add_image, &movie, global.jobs, 0);
+	t = movie.t;
     }
 
     MovieFinish(&swf, t, global.outfile);
@@ -98,6 +98,7 @@ void args_callback_usage(char *name)
     printf("-h , --help                    Print short help message and exit\n");
     printf("-l , --legacy                  Use old rendering framework\n");
     printf("-o , --output		   Output file (default: output.png)\n");
+    printf("-p , --pages <range>           Render frames in <range> (with -l: to output.<frame>.png)\n");
     printf("\n");
 }
 int args_callback_command(char*name,char*val)
@@ -112,12 +113,36 @@ int args_callback_command(char*name,char*val)
 
 
 
+static void write_image(RENDERBUF*buf, char*filename)
+{
+    RGBA* img = swf_Render(buf);
+    if(quantize)
+	png_write_palette_based_2(filename, (unsigned char*)img, buf->width, buf->height);
+    else
+	png_write(filename, (unsigned char*)img, buf->width, buf->height);
+    free(img);
+}
+
+/* output.png -> output.<frame>.png */
+static char* frame_filename(char*filename, int frame)
+{
+    char*name = (char*)malloc(strlen(filename)+16);
+    strcpy(name, filename);
+    int l = strlen(name);
+    if(l>4 && !strcasecmp(&name[l-4], ".png"))
+	name[l-4] = 0;
+    sprintf(name+strlen(name), ".%d.png", frame);
+    return name;
+}
+
 int main(int argn, char*argv[])
 {
     SWF swf;
     int fi;
 
     processargs(argn, argv);
+    /* large frames are compressed on all processors */
+    png_set_num_threads(0);
 
     if(!filename) {
 	fprintf(stderr, "You must supply a filename.\n");
@@ -139,12 +164,22 @@ int main(int argn, char*argv[])
 	RENDERBUF buf;
 	swf_Render_Init(&buf, 0,0, (swf.movieSize.xmax - swf.movieSize.xmin) / 20,
 				   (swf.movieSize.ymax - swf.movieSize.ymin) / 20, 2, 1);
-	swf_RenderSWF(&buf, &swf);
-	RGBA* img = swf_Render(&buf);
-        if(quantize)
-	    png_write_palette_based_2(outputname, (unsigned char*)img, buf.width, buf.height);
-        else
-	    png_write(outputname, (unsigned char*)img, buf.width, buf.height);
+	if(!pagerange) {
+	    swf_RenderSWF(&buf, &swf);
+	    write_image(&buf, outputname);
+	} else {
+	    /* render the whole timeline, saving the frames in the given range */
+	    RENDERMOVIE movie;
+	    swf_RenderMovie_Init(&movie, &buf, &swf);
+	    while(swf_RenderMovie_NextFrame(&movie)) {
+		if(is_in_range(movie.frame, pagerange)) {
+		    char*name = frame_filename(outputname, movie.frame);
+		    write_image(&buf, name);
+		    free(name);
+		}
+	    }
+	    swf_RenderMovie_Delete(&movie);
+	}
 	swf_Render_Delete(&buf);
     } else {
 	parameter_t*p;